@@ -1,4 +1,5 @@
 import os
+import socket
 import subprocess
 import sys
 import json
@@ -50,6 +51,10 @@ class EvolutionJob(NTRTJob):
             if len(terrainMatrix[0]) < 4: 
                 raise NTRTMasterError("Not enough terrain args!")
             
+            if self.args.get('server'):
+                self._runOnServer(terrainMatrix, logFile)
+                sys.exit()
+
             # Run through a set of binary job options. Currently handles terrain switches
             for run in terrainMatrix:
                 if (len(run)) >= 5:
@@ -60,6 +65,36 @@ class EvolutionJob(NTRTJob):
                 subprocess.check_call([self.args['executable'], "-l", self.args['filename'], "-P", self.args['path'], "-s", str(trialLength), "-b", str(run[0]), "-H", str(run[1]), "-a", str(run[2]), "-B", str(run[3]), "-G", str("0")], stdout=logFile)
             sys.exit()
 
+    def _runOnServer(self, terrainMatrix, logFile):
+        """
+        Send each terrain run to an already running trial server (an app started with
+        --socket) instead of starting a new process per run. The server appends scores to
+        the same file, so processJobOutput doesn't change.
+        """
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.connect(self.args['server'])
+        replies = sock.makefile('r')
+        try:
+            for run in terrainMatrix:
+                if (len(run)) >= 5:
+                    trialLength = run[4]
+                else:
+                    trialLength = self.args['length']
+                # Angles aren't used by the terrain apps, so they aren't forwarded
+                request = {'filename' : self.args['filename'],
+                           'path'     : self.args['path'],
+                           'steps'    : int(trialLength),
+                           'blocks'   : bool(run[0]),
+                           'hills'    : bool(run[1])}
+                sock.sendall((json.dumps(request) + '\n').encode())
+                reply = replies.readline()
+                logFile.write(reply.encode())
+                if not reply or json.loads(reply).get('status') != 'ok':
+                    raise NTRTMasterError("Trial server failed: %r" % reply)
+        finally:
+            replies.close()
+            sock.close()
+
     def processJobOutput(self):
         scoresPath = self.args['resourcePrefix'] + self.args['path'] + self.args['filename']
 
@@ -550,6 +550,10 @@ class EvolutionJobMaster(NTRTJobMaster):
                             'executable' : self.jConf['executable'],
                             'length'   : self.jConf['learningParams']['trialLength'],
                             'terrain'  : j}
+                    # Optional pool of long-lived trial servers, one Unix socket each
+                    if 'trialServers' in self.jConf:
+                        servers = self.jConf['trialServers']
+                        args['server'] = servers[len(jobList) % len(servers)]
                     if (n == 0 or i >= startTrial):
                         jobList.append(EvolutionJob(args))
 
@@ -0,0 +1,86 @@
+"""
+Checks that a trial server (AppTerrainJSON --server) recovers from a request
+it can't run. A request for a missing parameter file must be answered with an
+error, and the next, good request must add exactly one score to its own file,
+with nothing left over from the failed trial.
+
+Usage:
+    python trial_server_test.py <AppTerrainJSON> <resourcePrefix> <path> <filename>
+
+filename is a working parameter file in resourcePrefix + path. It is copied, so
+the original is left untouched.
+"""
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+
+def countScores(fileName):
+    fin = open(fileName, 'r')
+    params = json.load(fin)
+    fin.close()
+    return len(params.get('scores') or [])
+
+
+def request(server, filename, path, steps):
+    line = json.dumps({'filename' : filename,
+                       'path'     : path,
+                       'steps'    : steps}) + '\n'
+    server.stdin.write(line.encode())
+    server.stdin.flush()
+    reply = server.stdout.readline().decode()
+    if not reply:
+        raise RuntimeError("Trial server exited")
+    return json.loads(reply)
+
+
+def main(argv):
+    if len(argv) != 5:
+        sys.stderr.write(__doc__)
+        return 2
+
+    executable, resourcePrefix, path, filename = argv[1:]
+    folder = resourcePrefix + path
+
+    goodName = 'serverTest_' + filename
+    badName = 'serverTest_missing.json'
+    shutil.copyfile(os.path.join(folder, filename), os.path.join(folder, goodName))
+    if os.path.exists(os.path.join(folder, badName)):
+        os.remove(os.path.join(folder, badName))
+
+    before = countScores(os.path.join(folder, goodName))
+
+    server = subprocess.Popen([executable, "--server", "-P", path],
+                              stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+    try:
+        bad = request(server, badName, path, 100)
+        good = request(server, goodName, path, 100)
+    finally:
+        server.stdin.close()
+        server.wait()
+
+    after = countScores(os.path.join(folder, goodName))
+    os.remove(os.path.join(folder, goodName))
+
+    failures = []
+    if bad.get('status') != 'error':
+        failures.append("missing file was not reported: %r" % bad)
+    if good.get('status') != 'ok':
+        failures.append("good request failed after a bad one: %r" % good)
+    if after != before + 1:
+        failures.append("good file gained %d scores instead of 1" % (after - before))
+    if os.path.exists(os.path.join(folder, badName)):
+        failures.append("scores were written for the missing file")
+
+    for failure in failures:
+        sys.stderr.write(failure + '\n')
+    if not failures:
+        sys.stdout.write("Trial server recovered from a bad request\n")
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
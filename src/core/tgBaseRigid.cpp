@@ -26,6 +26,7 @@
 // This module
 #include "tgBaseRigid.h"
 #include "tgModelVisitor.h"
+#include "tgSnapshot.h"
 // The Bullet Physics library
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "btBulletDynamicsCommon.h"
@@ -62,6 +63,79 @@ void tgBaseRigid::onVisit(const tgModelVisitor& v) const
     
 }
 
+void tgBaseRigid::saveState(tgSnapshot& snapshot)
+{
+    // Precondition
+    assert(invariant());
+    
+    const btTransform& transform = m_pRigidBody->getWorldTransform();
+    const btVector3& origin = transform.getOrigin();
+    const btQuaternion rotation = transform.getRotation();
+    const btVector3& linear = m_pRigidBody->getLinearVelocity();
+    const btVector3& angular = m_pRigidBody->getAngularVelocity();
+    
+    for (int i = 0; i < 3; i++)
+    {
+        snapshot.write(origin[i]);
+    }
+    snapshot.write(rotation.x());
+    snapshot.write(rotation.y());
+    snapshot.write(rotation.z());
+    snapshot.write(rotation.w());
+    for (int i = 0; i < 3; i++)
+    {
+        snapshot.write(linear[i]);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        snapshot.write(angular[i]);
+    }
+    
+    tgModel::saveState(snapshot);
+}
+
+void tgBaseRigid::restoreState(tgSnapshot& snapshot)
+{
+    // Precondition
+    assert(invariant());
+    
+    // Read into locals, argument evaluation order is unspecified
+    const double ox = snapshot.read();
+    const double oy = snapshot.read();
+    const double oz = snapshot.read();
+    const double qx = snapshot.read();
+    const double qy = snapshot.read();
+    const double qz = snapshot.read();
+    const double qw = snapshot.read();
+    const double lx = snapshot.read();
+    const double ly = snapshot.read();
+    const double lz = snapshot.read();
+    const double ax = snapshot.read();
+    const double ay = snapshot.read();
+    const double az = snapshot.read();
+    
+    const btTransform transform(btQuaternion(qx, qy, qz, qw),
+                                btVector3(ox, oy, oz));
+    const btVector3 linear(lx, ly, lz);
+    const btVector3 angular(ax, ay, az);
+    
+    m_pRigidBody->setWorldTransform(transform);
+    m_pRigidBody->setInterpolationWorldTransform(transform);
+    if (m_pRigidBody->getMotionState() != NULL)
+    {
+        m_pRigidBody->getMotionState()->setWorldTransform(transform);
+    }
+    m_pRigidBody->setLinearVelocity(linear);
+    m_pRigidBody->setAngularVelocity(angular);
+    m_pRigidBody->setInterpolationLinearVelocity(linear);
+    m_pRigidBody->setInterpolationAngularVelocity(angular);
+    m_pRigidBody->clearForces();
+    // It may have gone to sleep since the snapshot was taken
+    m_pRigidBody->activate(true);
+    
+    tgModel::restoreState(snapshot);
+}
+
 void tgBaseRigid::teardown()
 {
   // World owns this
@@ -58,6 +58,12 @@ public:
      */
     virtual void onVisit(const tgModelVisitor& v) const;
     
+    /** Saves the body's transform and velocities, then the children */
+    virtual void saveState(tgSnapshot& snapshot);
+    
+    /** Moves the body back in place and clears its forces */
+    virtual void restoreState(tgSnapshot& snapshot);
+    
     /**
      * Return the rod's mass in application-dependent units.
      * @return the rod's mass in application-dependent units
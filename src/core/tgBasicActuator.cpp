@@ -25,15 +25,18 @@
 
 // This Module
 #include "tgBulletSpringCable.h"
+#include "tgBulletSpringCableSolver.h"
 #include "tgBasicActuator.h"
+#include "tgCast.h"
 #include "tgModelVisitor.h"
+#include "tgSnapshot.h"
 #include "tgWorld.h"
+#include "tgWorldBulletPhysicsImpl.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
 #include <cmath>
-#include <deque> // For history
 #include <iostream>
 #include <stdexcept>
 
@@ -84,6 +87,19 @@ void tgBasicActuator::setup(tgWorld& world)
 {
     // This needs to be called here in case the controller needs to cast
     notifySetup();
+    
+    // Let the world compute our forces along with every other cable's
+    tgWorldBulletPhysicsImpl& bulletWorld =
+      (tgWorldBulletPhysicsImpl&)world.implementation();
+    tgBulletSpringCableSolver* const pSolver = bulletWorld.cableSolver();
+    tgBulletSpringCable* const pCable =
+      tgCast::cast<tgSpringCable, tgBulletSpringCable>(m_springCable);
+    if (pSolver && pCable)
+    {
+        // Contact cables are refused and keep stepping themselves
+        pSolver->add(pCable);
+    }
+    
     tgModel::setup(world);
 }
 
@@ -119,6 +135,18 @@ void tgBasicActuator::onVisit(const tgModelVisitor& r) const
 #endif //BT_NO_PROFILE	
     r.render(*this);
 }
+
+void tgBasicActuator::saveState(tgSnapshot& snapshot)
+{
+    snapshot.write(m_preferredLength);
+    tgSpringCableActuator::saveState(snapshot);
+}
+
+void tgBasicActuator::restoreState(tgSnapshot& snapshot)
+{
+    m_preferredLength = snapshot.read();
+    tgSpringCableActuator::restoreState(snapshot);
+}
     
 void tgBasicActuator::logHistory()
 {
@@ -126,11 +154,11 @@ void tgBasicActuator::logHistory()
 
     if (m_config.hist)
     {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_springCable->getVelocity());
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_springCable->getTension());
+        m_pHistory->record(m_springCable->getActualLength(),
+                           m_springCable->getVelocity(),
+                           m_springCable->getDamping(),
+                           m_springCable->getRestLength(),
+                           m_springCable->getTension());
     }
 }
 
@@ -66,7 +66,9 @@ tgBulletSpringCable (anchors, coefK, dampingCoefficient, pretension),
 m_ghostObject(ghostObject),
 m_world(world),
 m_thickness(thickness),
-m_resolution(resolution)
+m_resolution(resolution),
+m_lastAabbMin(0.0, 0.0, 0.0),
+m_lastAabbMax(0.0, 0.0, 0.0)
 {
 
 }
@@ -237,7 +239,13 @@ void tgBulletContactSpringCable::updateManifolds()
 	btBroadphasePairArray& pairArray = m_ghostObject->getOverlappingPairCache()->getOverlappingPairArray();
 	int numPairs = pairArray.size();
     
-    std::vector<tgBulletSpringCableAnchor*> rejectedAnchors;
+    // m_anchors does not change until updateAnchorList, so index the
+    // sliding anchors by manifold once for all contacts
+    m_manifoldAnchors.clear();
+    for (std::size_t i = 1; i + 1 < m_anchors.size(); i++)
+    {
+        indexManifoldAnchor(i);
+    }
     
 	for (int i = 0; i < numPairs; i++)
 	{
@@ -302,7 +310,7 @@ void tgBulletContactSpringCable::updateManifolds()
 					if(rb)
 					{  
 						
-						int anchorPos = findNearestPastAnchor(pos);
+						int anchorPos = findPastAnchorByManifold(pos, manifold);
 						assert(anchorPos < (int)(m_anchors.size() - 1));
 						
 						// -1 means findNearestPastAnchor failed
@@ -334,14 +342,20 @@ void tgBulletContactSpringCable::updateManifolds()
 							if (lengthB <= m_resolution && rb == backAnchor->attachedBody && mDistB < mDistA)
 							{
 								if(backAnchor->updateManifold(manifold))
+								{
 									del = true;
+									indexManifoldAnchor(anchorPos);
 									//std::cout << "UpdateB " << mDistB << std::endl;
+								}
 							}
 							if (lengthA <= m_resolution && rb == forwardAnchor->attachedBody && (!del || mDistA < mDistB))
 							{
 								if (forwardAnchor->updateManifold(manifold))
+								{
 									del = true;
+									indexManifoldAnchor(anchorPos + 1);
 									//std::cout << "UpdateA " << mDistA << std::endl;
+								}
 							}
 							
 							if (del)
@@ -372,12 +386,14 @@ void tgBulletContactSpringCable::updateAnchorList()
 	int numContacts = 2;
     
     btScalar startLength = getActualLength();
+    // Kept up to date as anchors are inserted, instead of re-summing
+    // every segment for each new anchor
+    btScalar currentLength = startLength;
     
-	while (m_newAnchors.size() > 0)
+	for (std::size_t k = 0; k < m_newAnchors.size(); k++)
 	{
 		// Not permanent, sliding contact
-		tgBulletSpringCableAnchor* const newAnchor = m_newAnchors[0];
-		m_newAnchors.erase(m_newAnchors.begin());
+		tgBulletSpringCableAnchor* const newAnchor = m_newAnchors[k];
 		
 		btVector3 pos1 = newAnchor->getWorldPosition();
 
@@ -451,26 +467,24 @@ void tgBulletContactSpringCable::updateAnchorList()
             }
 			else
 			{		
-				
-				m_anchorIt = m_anchors.begin() + anchorPos + 1;
-			    
-				m_anchorIt = m_anchors.insert(m_anchorIt, newAnchor);
-
+				// Length of the cable once newAnchor splits this segment
+				const btScalar newLength = currentLength - (pos2 - pos0).length() + lengthA + lengthB;
 #if (1) // Keeps the energy down very well
-                if (getActualLength() > m_prevLength + 2.0 * m_resolution)
+                if (newLength > m_prevLength + 2.0 * m_resolution)
                 {
 #ifdef VERBOSE 
                     std::cout << "Deleting anchor on basis of length " << std::endl;
 #endif
-                    deleteAnchor(anchorPos + 1);
+                    delete newAnchor;
                 }
                 else
+#endif
                 {
+                    m_anchorIt = m_anchors.begin() + anchorPos + 1;
+                    m_anchorIt = m_anchors.insert(m_anchorIt, newAnchor);
+                    currentLength = newLength;
                     numContacts++;
                 }
-#else
-                numContacts++;
-#endif
                 
 #ifdef VERBOSE                
                 std::cout << "Prev: " << m_prevLength << " LengthDiff " << startLength << " " << getActualLength();
@@ -483,6 +497,7 @@ void tgBulletContactSpringCable::updateAnchorList()
 			delete newAnchor;
 		}
 	}
+	m_newAnchors.clear();
    
     //std::cout << "contacts " << numContacts << " unprunedAnchors " << m_anchors.size();
     
@@ -493,22 +508,28 @@ void tgBulletContactSpringCable::updateAnchorList()
 int tgBulletContactSpringCable::updateAnchorPositions()
 {
     int numPruned = 0;
-    std::size_t i = 1;
     
     bool keep = true; //m_anchors[i]->updateContactNormal();
     
-    while (i < m_anchors.size() - 1)
+    // Compact m_anchors in one pass: kept anchors are moved down to
+    // index kept, so each deletion is O(1) and the "back" neighbor is
+    // always the last anchor kept, as it was with erase.
+    const std::size_t last = m_anchors.size() - 1;
+    std::size_t kept = 1;
+    for (std::size_t i = 1; i < last; i++)
     {
-        btVector3 back = m_anchors[i - 1]->getWorldPosition(); 
-        btVector3 current = m_anchors[i]->getWorldPosition(); 
+        tgBulletSpringCableAnchor* const anchor = m_anchors[i];
+        
+        btVector3 back = m_anchors[kept - 1]->getWorldPosition(); 
+        btVector3 current = anchor->getWorldPosition(); 
         btVector3 forward = m_anchors[i + 1]->getWorldPosition(); 
         
         btVector3 lineA = (forward - current);
         btVector3 lineB = (back - current);
 
-        btVector3 contactNormal = m_anchors[i]->getContactNormal();
+        btVector3 contactNormal = anchor->getContactNormal();
         
-        if (!m_anchors[i]->permanent)
+        if (!anchor->permanent)
         {
 #if (0)
             btVector3 tangentMove = ((contactNormal)(lineA + lineB));
@@ -522,25 +543,20 @@ int tgBulletContactSpringCable::updateAnchorPositions()
             btVector3 newPos = current + tangentMove;
             // Check if new position is on body
 #if (1)    
-            if (!keep || !m_anchors[i]->setWorldPosition(newPos))
+            if (!keep || !anchor->setWorldPosition(newPos))
             {
-                deleteAnchor(i);
+                delete anchor;
                 numPruned++;
-            }
-            else
-            {
-                i++;
+                continue;
             }
 #else
-            m_anchors[i]->setWorldPosition(newPos);
-            i++;
+            anchor->setWorldPosition(newPos);
 #endif
         }
-        else
-        {
-            i++;
-        }
+        m_anchors[kept++] = anchor;
     }
+    m_anchors[kept++] = m_anchors[last];
+    m_anchors.resize(kept);
     
     return numPruned;
 }
@@ -567,18 +583,28 @@ void tgBulletContactSpringCable::pruneAnchors()
         }
     }
 #else
-    while (i < m_anchors.size() - 1)
+    // Each anchor's validity only depends on its own manifold, so
+    // delete in one compacting pass
     {
-        btPersistentManifold* m = m_anchors[i]->getManifold();
-        if (m_anchors[i]->getManifoldDistance(m).first == INFINITY)
-        {
-            deleteAnchor(i);
-            numPruned++;
-        }
-        else
+        const std::size_t last = m_anchors.size() - 1;
+        std::size_t kept = 1;
+        for (i = 1; i < last; i++)
         {
-            i++;
+            tgBulletSpringCableAnchor* const anchor = m_anchors[i];
+            btPersistentManifold* m = anchor->getManifold();
+            if (!anchor->permanent &&
+                anchor->getManifoldDistance(m).first == INFINITY)
+            {
+                delete anchor;
+                numPruned++;
+            }
+            else
+            {
+                m_anchors[kept++] = anchor;
+            }
         }
+        m_anchors[kept++] = m_anchors[last];
+        m_anchors.resize(kept);
     }
 #endif
 
@@ -597,26 +623,28 @@ void tgBulletContactSpringCable::pruneAnchors()
         
         if( numPruned == 0)
         {
-        
-            i = 1;
-            while (i < m_anchors.size() - 1)
+            // Same compaction as updateAnchorPositions
+            const std::size_t last = m_anchors.size() - 1;
+            std::size_t kept = 1;
+            for (i = 1; i < last; i++)
             {
+                tgBulletSpringCableAnchor* const anchor = m_anchors[i];
                 
-                if (!m_anchors[i]->permanent)
+                if (!anchor->permanent)
                 {
                     btScalar normalValue1;
                     btScalar normalValue2;
                     
                     // Get new values
                     
-                    btVector3 back = m_anchors[i - 1]->getWorldPosition(); 
-                    btVector3 current = m_anchors[i]->getWorldPosition(); 
+                    btVector3 back = m_anchors[kept - 1]->getWorldPosition(); 
+                    btVector3 current = anchor->getWorldPosition(); 
                     btVector3 forward = m_anchors[i + 1]->getWorldPosition(); 
                 
                     btVector3 lineA = (forward - current);
                     btVector3 lineB = (back - current);
             
-                    btVector3 contactNormal = m_anchors[i]->getContactNormal();
+                    btVector3 contactNormal = anchor->getContactNormal();
                     
                     
                     if (lineA.length() < m_resolution / 2.0 || lineB.length() < m_resolution / 2.0)
@@ -639,22 +667,15 @@ void tgBulletContactSpringCable::pruneAnchors()
                         #ifdef VERBOSE
                             std::cout << "Erased normal: " << normalValue1 << " "  << normalValue2 << " "; 
                         #endif
-                        if (deleteAnchor(i))
-                        {
-                            numPruned++;
-                        }
-                        else
-                        {
-                            // Permanent anchor, move on
-                            i++;
-                        }
-                    }
-                    else
-                    {
-                        i++;
+                        delete anchor;
+                        numPruned++;
+                        continue;
                     }
                 }
+                m_anchors[kept++] = anchor;
             }
+            m_anchors[kept++] = m_anchors[last];
+            m_anchors.resize(kept);
         }
 
         if (numPruned == 0)
@@ -689,9 +710,15 @@ void tgBulletContactSpringCable::updateCollisionObject()
 	btDispatcher* m_dispatcher = tgBulletUtil::worldToDynamicsWorld(m_world).getDispatcher();
 	btBroadphaseInterface* const m_overlappingPairCache = tgBulletUtil::worldToDynamicsWorld(m_world).getBroadphase();
 	
-    // Clear the existing child shapes
     btCompoundShape* m_compoundShape = tgCast::cast<btCollisionShape, btCompoundShape> (m_ghostObject->getCollisionShape());
-    clearCompoundShape(m_compoundShape);
+    
+    // The compound starts out with a placeholder child from the info
+    // class. Replace anything we did not create, once.
+    if (m_compoundShape->getNumChildShapes() != (int) m_segmentShapes.size())
+    {
+        clearCompoundShape(m_compoundShape);
+        m_segmentShapes.clear();
+    }
     
     btVector3 maxes(anchor2->getWorldPosition());
     btVector3 mins(anchor1->getWorldPosition());
@@ -715,10 +742,17 @@ void tgBulletContactSpringCable::updateCollisionObject()
     }
     btVector3 center = (maxes + mins)/2.0;
     
-    btVector3 from = anchor1->getWorldPosition();
-	btVector3 to = anchor2->getWorldPosition();
+    // Drop segments from the end if anchors were pruned
+    const std::size_t nSegments = n - 1;
+    while (m_segmentShapes.size() > nSegments)
+    {
+        const int last = m_compoundShape->getNumChildShapes() - 1;
+        deleteCollisionShape(m_compoundShape->getChildShape(last));
+        m_compoundShape->removeChildShapeByIndex(last);
+        m_segmentShapes.pop_back();
+    }
 	
-    for (std::size_t i = 0; i < n-1; i++)
+    for (std::size_t i = 0; i < nSegments; i++)
     {
         btVector3 pos1 = m_anchors[i]->getWorldPosition();
         btVector3 pos2 = m_anchors[i+1]->getWorldPosition();
@@ -728,12 +762,25 @@ void tgBulletContactSpringCable::updateCollisionObject()
         t.setOrigin(t.getOrigin() - center);
         
         btScalar length = (pos2 - pos1).length() / 2.0;
-		
-        /// @todo - seriously examine box vs cylinder shapes
-        btCylinderShape* box = new btCylinderShape(btVector3(m_thickness, length, m_thickness));
         
-        m_compoundShape->addChildShape(t, box);
+        /// @todo - seriously examine box vs cylinder shapes
+        const btVector3 halfExtents(m_thickness, length, m_thickness);
+        if (i < m_segmentShapes.size())
+        {
+            // Reshape in place. Assigning from a temporary gives exactly the
+            // dimensions and margin the constructor would, without touching
+            // the heap.
+            *m_segmentShapes[i] = btCylinderShape(halfExtents);
+            m_compoundShape->updateChildTransform(i, t, false);
+        }
+        else
+        {
+            btCylinderShape* box = new btCylinderShape(halfExtents);
+            m_compoundShape->addChildShape(t, box);
+            m_segmentShapes.push_back(box);
+        }
     }
+    m_compoundShape->recalculateLocalAabb();
     // Default margin is 0.04, so larger than default thickness. Behavior is better with larger margin
     //m_compoundShape->setMargin(m_thickness);
     
@@ -741,11 +788,19 @@ void tgBulletContactSpringCable::updateCollisionObject()
     transform.setOrigin(center);
     transform.setRotation(btQuaternion::getIdentity());
     
-    m_ghostObject->setCollisionShape (m_compoundShape);
     m_ghostObject->setWorldTransform(transform);
 	
-	// Delete the existing contacts in bullet to prevent sticking - may exacerbate problems with rotations
-	m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+    // Delete the existing contacts in bullet to prevent sticking - may exacerbate problems with rotations
+    // Only needed when the shape has actually moved
+    btVector3 aabbMin;
+    btVector3 aabbMax;
+    m_compoundShape->getAabb(transform, aabbMin, aabbMax);
+    if (aabbMin != m_lastAabbMin || aabbMax != m_lastAabbMax)
+    {
+        m_overlappingPairCache->getOverlappingPairCache()->cleanProxyFromPairs(m_ghostObject->getBroadphaseHandle(),m_dispatcher);
+        m_lastAabbMin = aabbMin;
+        m_lastAabbMax = aabbMax;
+    }
 }
 
 void tgBulletContactSpringCable::deleteCollisionShape(btCollisionShape* pShape)
@@ -788,6 +843,32 @@ void tgBulletContactSpringCable::clearCompoundShape(btCompoundShape* pShape)
 	
 }
 
+void tgBulletContactSpringCable::restoreState(tgSnapshot& snapshot)
+{
+    tgBulletSpringCable::restoreState(snapshot);
+    
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_anchors.size(); i++)
+    {
+        if (m_anchors[i]->permanent)
+        {
+            m_anchors[kept++] = m_anchors[i];
+        }
+        else
+        {
+            delete m_anchors[i];
+        }
+    }
+    m_anchors.resize(kept);
+    m_manifoldAnchors.clear();
+    
+    m_prevLength = getActualLength();
+    
+    updateCollisionObject();
+    
+    assert(invariant());
+}
+
 bool tgBulletContactSpringCable::deleteAnchor(int i)
 {
 #ifndef BT_NO_PROFILE 
@@ -949,6 +1030,50 @@ int tgBulletContactSpringCable::findNearestPastAnchor(btVector3& pos)
 
 }
 
+void tgBulletContactSpringCable::indexManifoldAnchor(std::size_t i)
+{
+    // The end points are not sliding anchors
+    if (i > 0 && i + 1 < m_anchors.size())
+    {
+        const btPersistentManifold* m = m_anchors[i]->getManifold();
+        if (m)
+        {
+            m_manifoldAnchors[m] = i;
+        }
+    }
+}
+
+int tgBulletContactSpringCable::findPastAnchorByManifold(btVector3& pos,
+                                                       const btPersistentManifold* manifold)
+{
+    ManifoldAnchorMap::const_iterator it = m_manifoldAnchors.find(manifold);
+    // Only a hint: the anchor may have moved to another manifold since
+    if (it != m_manifoldAnchors.end() &&
+        it->second > 0 && it->second + 1 < m_anchors.size() &&
+        m_anchors[it->second]->getManifold() == manifold)
+    {
+        // An anchor already rides on this manifold, so the contact is next
+        // to it. Decide which side, as findNearestPastAnchor does around
+        // its nearest anchor, then apply the same final check.
+        std::size_t i = it->second;
+        
+        tgBulletContactSpringCable::anchorCompare sides(m_anchors[i - 1], m_anchors[i + 1]);
+        btVector3 current = m_anchors[i]->getWorldPosition();
+        if (sides.comparePoints(pos, current))
+        {
+            i--;
+        }
+        
+        btVector3 back = m_anchors[i]->getWorldPosition();
+        tgBulletContactSpringCable::anchorCompare segment(m_anchors[i], m_anchors[i + 1]);
+        if (segment.comparePoints(back, pos))
+        {
+            return i;
+        }
+    }
+    return findNearestPastAnchor(pos);
+}
+
 tgBulletContactSpringCable::anchorCompare::anchorCompare(const tgBulletSpringCableAnchor* m1, const tgBulletSpringCableAnchor* m2) :
 ma1(m1),
 ma2(m2)
@@ -35,6 +35,7 @@
 // The C++ Standard Library
 
 #include <vector>
+#include <tr1/unordered_map>
 
 // Forward references
 class tgWorld;
@@ -42,7 +43,9 @@ class tgBulletSpringCableAnchor;
 class btRigidBody;
 class btCollisionShape;
 class btCompoundShape;
+class btCylinderShape;
 class btPairCachingGhostObject;
+class btPersistentManifold;
 class btDynamicsWorld;
 
 /**
@@ -113,6 +116,14 @@ public:
      */
     virtual const btScalar getActualLength() const;
     
+    /**
+     * Contacts are not part of the snapshot. The sliding anchors are
+     * dropped and found again from the restored positions on the next
+     * step, and the previous length is taken from the remaining anchors
+     * so the first step doesn't see a jump in velocity.
+     */
+    virtual void restoreState(tgSnapshot& snapshot);
+    
 private:
     
     /**
@@ -179,9 +190,11 @@ private:
     void pruneAnchors();
     
     /**
-     * Uses m_anchors to update the collision shape of the m_ghostObject
-     * Also resets the broadphase's pairCache after collision object
-     * is changed.
+     * Uses m_anchors to update the collision shape of the m_ghostObject.
+     * Segment shapes are reused from step to step; children are only
+     * added or removed when the number of anchors changes.
+     * Also resets the broadphase's pairCache when the bounding box of
+     * the collision object changes.
      */
     void updateCollisionObject();
     
@@ -218,6 +231,37 @@ private:
      */
     int findNearestPastAnchor(btVector3& pos);
     
+    /**
+     * Same contract as findNearestPastAnchor, for a contact point from
+     * updateManifolds(). If an existing sliding anchor already tracks the
+     * contact's manifold, the answer is one of the two segments next to
+     * that anchor and is found in constant time through
+     * m_manifoldAnchors. Otherwise falls back to findNearestPastAnchor.
+     * @param[in] pos the position of the contact
+     * @param[in] manifold the manifold the contact belongs to
+     * @return the index of the relevant anchor, -1 on failure
+     */
+    int findPastAnchorByManifold(btVector3& pos,
+                                 const btPersistentManifold* manifold);
+    
+    /**
+     * Record the manifold of m_anchors[i] in m_manifoldAnchors, if it is
+     * a sliding anchor with a manifold. Called again whenever an anchor
+     * takes a new manifold, so the entry points at the latest anchor.
+     */
+    void indexManifoldAnchor(std::size_t i);
+    
+    typedef std::tr1::unordered_map<const btPersistentManifold*, std::size_t>
+        ManifoldAnchorMap;
+    
+    /**
+     * Index in m_anchors of the sliding anchor tracking each manifold.
+     * Rebuilt at the start of updateManifolds(), only valid until
+     * m_anchors changes. Entries are hints, and are checked against the
+     * anchor's manifold before use.
+     */
+    ManifoldAnchorMap m_manifoldAnchors;
+    
     /**
      * An iterator over a list of tgBulletSpringCableAnchors. Used to insert new
      * anchors during updateAnchorList()
@@ -258,7 +302,20 @@ protected:
 	 */
 	const double m_resolution;
 
-private:    
+private:
+    /**
+     * The cylinder for each segment between anchors, in the order of the
+     * compound's children. The compound shape owns them.
+     */
+    std::vector<btCylinderShape*> m_segmentShapes;
+    
+    /**
+     * The world bounding box of the ghost object when the pair cache was
+     * last cleaned.
+     */
+    btVector3 m_lastAabbMin;
+    btVector3 m_lastAabbMax;
+        
     bool invariant() const;
 };
 
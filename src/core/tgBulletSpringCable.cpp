@@ -25,6 +25,7 @@
 // This module
 #include "tgBulletSpringCable.h"
 #include "tgBulletSpringCableAnchor.h"
+#include "tgBulletSpringCableSolver.h"
 #include "tgCast.h"
 // The BulletPhysics library
 #include "BulletDynamics/Dynamics/btRigidBody.h"
@@ -40,7 +41,9 @@ tgSpringCable(tgCast::filter<tgBulletSpringCableAnchor, tgSpringCableAnchor>(anc
                 coefK, dampingCoefficient, pretension),
 m_anchors(anchors),
 anchor1(anchors.front()),
-anchor2(anchors.back())
+anchor2(anchors.back()),
+m_pSolver(NULL),
+m_solverIndex(0)
 {
     assert(m_anchors.size() >= 2);
     assert(invariant());
@@ -54,6 +57,11 @@ tgBulletSpringCable::~tgBulletSpringCable()
     std::cout << "Destroying tgBulletSpringCable" << std::endl;
     #endif
     
+    if (m_pSolver)
+    {
+        m_pSolver->remove(this);
+    }
+    
     std::size_t n = m_anchors.size();
     
     // Make absolutely sure these are deleted, in case we have a poorly timed reset
@@ -83,7 +91,11 @@ void tgBulletSpringCable::step(double dt)
         throw std::invalid_argument("dt is not positive!");
     }
 
-    calculateAndApplyForce(dt);
+    // Otherwise the solver has already applied this step's forces
+    if (m_pSolver == NULL)
+    {
+        calculateAndApplyForce(dt);
+    }
     assert(invariant());
 }
 
@@ -159,6 +171,16 @@ const std::vector<const tgSpringCableAnchor*> tgBulletSpringCable::getAnchors()
     return tgCast::constFilter<tgBulletSpringCableAnchor, const tgSpringCableAnchor>(m_anchors);
 }
 
+void tgBulletSpringCable::restoreState(tgSnapshot& snapshot)
+{
+    tgSpringCable::restoreState(snapshot);
+    
+    if (m_pSolver != NULL)
+    {
+        m_pSolver->reload(this);
+    }
+}
+
 bool tgBulletSpringCable::invariant(void) const
 {
     return (m_coefK > 0.0 &&
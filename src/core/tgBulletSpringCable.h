@@ -38,6 +38,7 @@
 class btRigidBody;
 class tgSpringCableAnchor;
 class tgBulletSpringCableAnchor;
+class tgBulletSpringCableSolver;
 
 /**
  * This class defines the passive dynamics of a spring-cable system
@@ -46,6 +47,9 @@ class tgBulletSpringCableAnchor;
  */
 class tgBulletSpringCable : public tgSpringCable
 {
+    // Computes forces for many cables at once, see tgWorld::Config
+    friend class tgBulletSpringCableSolver;
+
 public: 
     /**
      * The only constructor. Takes a list of anchors, a coefficient
@@ -67,7 +71,8 @@ public:
     virtual ~tgBulletSpringCable();
 
     /**
-     * Updates this object. Calls calculateAndApplyForce(dt)
+     * Updates this object. Calls calculateAndApplyForce(dt), unless a
+     * tgBulletSpringCableSolver is applying the forces for this cable.
      * @param[in] dt, must be positive
      */
     virtual void step(double dt);
@@ -93,6 +98,19 @@ public:
      */
     virtual const std::vector<const tgSpringCableAnchor*> getAnchors() const;
     
+    /**
+     * Also hands the restored state to the batch solver, if any
+     */
+    virtual void restoreState(tgSnapshot& snapshot);
+    
+    /**
+     * The solver computing this cable's forces, or NULL if step does
+     */
+    const tgBulletSpringCableSolver* getSolver() const
+    {
+        return m_pSolver;
+    }
+    
 protected:
     
     /**
@@ -127,6 +145,12 @@ private:
 private: 
     /** Ensures integrity of member variables */
     bool invariant(void) const;
+
+    /** Set by tgBulletSpringCableSolver while it owns our forces */
+    tgBulletSpringCableSolver* m_pSolver;
+
+    /** Our position in m_pSolver's arrays */
+    std::size_t m_solverIndex;
 };
 
 #endif  // SRC_CORE_TG_BULLET_SPRING_CABLE_H_
@@ -0,0 +1,435 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgBulletSpringCableSolver.cpp
+ * @brief Definitions of members of class tgBulletSpringCableSolver
+ * $Id$
+ */
+
+// This module
+#include "tgBulletSpringCableSolver.h"
+#include "tgBulletSpringCable.h"
+#include "tgBulletSpringCableAnchor.h"
+// The BulletPhysics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+// The C++ Standard Library
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <typeinfo>
+
+tgBulletSpringCableSolver::tgBulletSpringCableSolver(bool implicit,
+                                                     std::size_t iterations) :
+m_implicit(implicit),
+m_iterations(iterations)
+{
+    if (iterations == 0)
+    {
+        throw std::invalid_argument("Need at least one cable iteration");
+    }
+    assert(invariant());
+}
+
+tgBulletSpringCableSolver::~tgBulletSpringCableSolver()
+{
+    // Let the cables step themselves if they outlive us
+    scatterState();
+    for (std::size_t i = 0; i < m_cables.size(); i++)
+    {
+        m_cables[i]->m_pSolver = NULL;
+    }
+}
+
+bool tgBulletSpringCableSolver::add(tgBulletSpringCable* cable)
+{
+    if (cable == NULL)
+    {
+        throw std::invalid_argument("cable is NULL");
+    }
+    // Subclasses override step and calculateAndApplyForce
+    if (typeid(*cable) != typeid(tgBulletSpringCable) ||
+        cable->m_anchors.size() != 2)
+    {
+        return false;
+    }
+    if (cable->m_pSolver != NULL)
+    {
+        return cable->m_pSolver == this;
+    }
+
+    const tgBulletSpringCableAnchor* const a1 = cable->anchor1;
+    const tgBulletSpringCableAnchor* const a2 = cable->anchor2;
+
+    cable->m_pSolver = this;
+    cable->m_solverIndex = m_cables.size();
+    m_cables.push_back(cable);
+
+    m_body1.push_back(a1->attachedBody);
+    m_body2.push_back(a2->attachedBody);
+    m_local1.push_back(a1->attachedBody->getWorldTransform().inverse() *
+                        a1->getWorldPosition());
+    m_local2.push_back(a2->attachedBody->getWorldTransform().inverse() *
+                        a2->getWorldPosition());
+
+    m_coefK.push_back(cable->m_coefK);
+    m_coefD.push_back(cable->m_dampingCoefficient);
+
+    m_restLength.push_back(cable->m_restLength);
+    m_prevLength.push_back(cable->m_prevLength);
+    m_velocity.push_back(cable->m_velocity);
+    m_damping.push_back(cable->m_damping);
+    m_dx.push_back(0.0);
+    m_dy.push_back(0.0);
+    m_dz.push_back(0.0);
+    m_rel1.push_back(btVector3(0.0, 0.0, 0.0));
+    m_rel2.push_back(btVector3(0.0, 0.0, 0.0));
+    m_direction.push_back(btVector3(0.0, 0.0, 0.0));
+    m_invMass.push_back(0.0);
+    m_stretch.push_back(0.0);
+    m_bias.push_back(0.0);
+    m_gain.push_back(0.0);
+    m_softness.push_back(0.0);
+    m_impulse.push_back(0.0);
+
+    assert(invariant());
+    return true;
+}
+
+namespace
+{
+    /** Swap element i with the last one and drop the last */
+    template <typename Array>
+    void swapRemove(Array& v, std::size_t i)
+    {
+        v[i] = v[v.size() - 1];
+        v.pop_back();
+    }
+}
+
+void tgBulletSpringCableSolver::reload(const tgBulletSpringCable* cable)
+{
+    if (cable == NULL || cable->m_pSolver != this)
+    {
+        return;
+    }
+
+    const std::size_t i = cable->m_solverIndex;
+    assert(i < m_cables.size() && m_cables[i] == cable);
+
+    m_restLength[i] = cable->m_restLength;
+    m_prevLength[i] = cable->m_prevLength;
+    m_velocity[i] = cable->m_velocity;
+    m_damping[i] = cable->m_damping;
+}
+
+void tgBulletSpringCableSolver::remove(tgBulletSpringCable* cable)
+{
+    if (cable == NULL || cable->m_pSolver != this)
+    {
+        return;
+    }
+
+    const std::size_t i = cable->m_solverIndex;
+    assert(i < m_cables.size() && m_cables[i] == cable);
+
+    // Hand the state back so the cable can carry on by itself
+    cable->m_prevLength = m_prevLength[i];
+    cable->m_velocity = m_velocity[i];
+    cable->m_damping = m_damping[i];
+    cable->m_pSolver = NULL;
+
+    swapRemove(m_cables, i);
+    swapRemove(m_body1, i);
+    swapRemove(m_body2, i);
+    swapRemove(m_local1, i);
+    swapRemove(m_local2, i);
+    swapRemove(m_coefK, i);
+    swapRemove(m_coefD, i);
+    swapRemove(m_restLength, i);
+    swapRemove(m_prevLength, i);
+    swapRemove(m_velocity, i);
+    swapRemove(m_damping, i);
+    swapRemove(m_dx, i);
+    swapRemove(m_dy, i);
+    swapRemove(m_dz, i);
+    swapRemove(m_rel1, i);
+    swapRemove(m_rel2, i);
+    swapRemove(m_direction, i);
+    swapRemove(m_invMass, i);
+    swapRemove(m_stretch, i);
+    swapRemove(m_bias, i);
+    swapRemove(m_gain, i);
+    swapRemove(m_softness, i);
+    swapRemove(m_impulse, i);
+
+    if (i < m_cables.size())
+    {
+        m_cables[i]->m_solverIndex = i;
+    }
+
+    assert(invariant());
+}
+
+void tgBulletSpringCableSolver::step(double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgBulletSpringCableSolver::step");
+#endif //BT_NO_PROFILE
+    if (dt <= 0.0)
+    {
+        throw std::invalid_argument("dt is not positive!");
+    }
+
+    const std::size_t n = m_cables.size();
+    if (n == 0)
+    {
+        return;
+    }
+
+    // The rest lengths set by the motors
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_restLength[i] = m_cables[i]->m_restLength;
+    }
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        gatherAnchors(i);
+    }
+
+    if (m_implicit)
+    {
+        solveImplicit(dt);
+    }
+    else
+    {
+        computeImpulses(dt);
+        applyImpulses();
+    }
+
+    scatterState();
+}
+
+void tgBulletSpringCableSolver::gatherAnchors(std::size_t i)
+{
+    const btTransform& tr1 = m_body1[i]->getWorldTransform();
+    const btTransform& tr2 = m_body2[i]->getWorldTransform();
+    // Relative to the center of mass, which is the body's origin
+    m_rel1[i] = tr1.getBasis() * m_local1[i];
+    m_rel2[i] = tr2.getBasis() * m_local2[i];
+    const btVector3 dist = (tr2.getOrigin() + m_rel2[i]) -
+                            (tr1.getOrigin() + m_rel1[i]);
+    m_dx[i] = dist.x();
+    m_dy[i] = dist.y();
+    m_dz[i] = dist.z();
+}
+
+void tgBulletSpringCableSolver::computeImpulses(double dt)
+{
+    const std::size_t n = m_cables.size();
+
+    // Compute: the force along the cable, left as an impulse in m_dx..m_dz
+    double* const dx = &m_dx[0];
+    double* const dy = &m_dy[0];
+    double* const dz = &m_dz[0];
+    const double* const restLength = &m_restLength[0];
+    const double* const coefK = &m_coefK[0];
+    const double* const coefD = &m_coefD[0];
+    double* const prevLength = &m_prevLength[0];
+    double* const velocity = &m_velocity[0];
+    double* const damping = &m_damping[0];
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double currLength = std::sqrt(dx[i] * dx[i] +
+                                            dy[i] * dy[i] +
+                                            dz[i] * dz[i]);
+        const double spring = coefK[i] * (currLength - restLength[i]);
+        const double vel = (currLength - prevLength[i]) / dt;
+        double damp = coefD[i] * vel;
+
+        // Same clamp as tgBulletSpringCable
+        if (std::fabs(spring) < std::fabs(damp))
+        {
+            damp = (damp > 0.0 ? spring : -spring);
+        }
+
+        // Slack cables push nothing
+        const double magnitude = currLength > restLength[i] ? spring + damp : 0.0;
+        const double scale = magnitude * dt / currLength;
+
+        velocity[i] = vel;
+        damping[i] = damp;
+        prevLength[i] = currLength;
+        dx[i] *= scale;
+        dy[i] *= scale;
+        dz[i] *= scale;
+    }
+}
+
+void tgBulletSpringCableSolver::applyImpulses()
+{
+    const std::size_t n = m_cables.size();
+
+    // Scatter: apply equal and opposite impulses
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 impulse(m_dx[i], m_dy[i], m_dz[i]);
+
+        m_body1[i]->activate();
+        m_body1[i]->applyImpulse(impulse, m_rel1[i]);
+
+        m_body2[i]->activate();
+        m_body2[i]->applyImpulse(-impulse, m_rel2[i]);
+    }
+}
+
+/**
+ * The impulse P = dt * T(t + dt), with the tension taken from the
+ * length and length rate at the end of the step:
+ * T = k (l + dt * u' - L) + c u', where u' = u - P / m and m is the
+ * cable's effective mass between its anchors. Each sweep corrects P
+ * against the current body velocities, which include the other
+ * cables' impulses.
+ *
+ * As in the explicit path, a cable that is slack pulls with neither
+ * spring nor damping. Pulling only shortens the cable, so if it would
+ * end the step slack without this cable's own impulse, P is zero, and
+ * otherwise P is capped where it would bring the cable exactly to its
+ * rest length.
+ */
+void tgBulletSpringCableSolver::solveImplicit(double dt)
+{
+    const std::size_t n = m_cables.size();
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const btVector3 dist(m_dx[i], m_dy[i], m_dz[i]);
+        const double currLength = dist.length();
+        const btVector3 dir = dist / currLength;
+        m_direction[i] = dir;
+
+        const btRigidBody* const body1 = m_body1[i];
+        const btRigidBody* const body2 = m_body2[i];
+        const btVector3 rn1 = m_rel1[i].cross(dir);
+        const btVector3 rn2 = m_rel2[i].cross(dir);
+        m_invMass[i] = body1->getInvMass() + body2->getInvMass() +
+            rn1.dot(body1->getInvInertiaTensorWorld() * rn1) +
+            rn2.dot(body2->getInvInertiaTensorWorld() * rn2);
+
+        m_stretch[i] = currLength - m_restLength[i];
+        m_bias[i] = dt * m_coefK[i] * m_stretch[i];
+        m_gain[i] = dt * (m_coefK[i] * dt + m_coefD[i]);
+        m_softness[i] = 1.0 / (1.0 + m_gain[i] * m_invMass[i]);
+        m_impulse[i] = 0.0;
+
+        m_velocity[i] = (currLength - m_prevLength[i]) / dt;
+        m_prevLength[i] = currLength;
+
+        m_body1[i]->activate();
+        m_body2[i]->activate();
+    }
+
+    for (std::size_t k = 0; k < m_iterations; k++)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            const btVector3& dir = m_direction[i];
+            // Rate of change of the cable's length
+            const double u = dir.dot(
+                m_body2[i]->getVelocityInLocalPoint(m_rel2[i]) -
+                m_body1[i]->getVelocityInLocalPoint(m_rel1[i]));
+            const double invMass = m_invMass[i];
+            // Stretch at the end of the step if this cable didn't pull
+            const double freeStretch =
+                m_stretch[i] + dt * (u + m_impulse[i] * invMass);
+
+            double target = 0.0;
+            if (freeStretch > 0.0)
+            {
+                target = m_impulse[i] +
+                    (m_bias[i] + m_gain[i] * u - m_impulse[i]) * m_softness[i];
+                // Not so hard that the cable ends up slack
+                if (invMass > 0.0 && target * dt * invMass > freeStretch)
+                {
+                    target = freeStretch / (dt * invMass);
+                }
+                // Cables can only pull
+                if (target < 0.0)
+                {
+                    target = 0.0;
+                }
+            }
+
+            const double delta = target - m_impulse[i];
+            m_impulse[i] = target;
+
+            const btVector3 impulse = dir * delta;
+            m_body1[i]->applyImpulse(impulse, m_rel1[i]);
+            m_body2[i]->applyImpulse(-impulse, m_rel2[i]);
+        }
+    }
+
+    // For history, the part of the applied force that isn't the spring
+    for (std::size_t i = 0; i < n; i++)
+    {
+        m_damping[i] = (m_impulse[i] - m_bias[i]) / dt;
+    }
+}
+
+void tgBulletSpringCableSolver::scatterState()
+{
+    // Getters and history read these from the cable
+    const std::size_t n = m_cables.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        tgBulletSpringCable* const cable = m_cables[i];
+        cable->m_prevLength = m_prevLength[i];
+        cable->m_velocity = m_velocity[i];
+        cable->m_damping = m_damping[i];
+    }
+}
+
+bool tgBulletSpringCableSolver::invariant() const
+{
+    const std::size_t n = m_cables.size();
+    return (m_body1.size() == n &&
+            m_body2.size() == n &&
+            static_cast<std::size_t>(m_local1.size()) == n &&
+            static_cast<std::size_t>(m_local2.size()) == n &&
+            m_coefK.size() == n &&
+            m_coefD.size() == n &&
+            m_restLength.size() == n &&
+            m_prevLength.size() == n &&
+            m_velocity.size() == n &&
+            m_damping.size() == n &&
+            m_dx.size() == n &&
+            m_dy.size() == n &&
+            m_dz.size() == n &&
+            static_cast<std::size_t>(m_rel1.size()) == n &&
+            static_cast<std::size_t>(m_rel2.size()) == n &&
+            static_cast<std::size_t>(m_direction.size()) == n &&
+            m_invMass.size() == n &&
+            m_stretch.size() == n &&
+            m_bias.size() == n &&
+            m_gain.size() == n &&
+            m_softness.size() == n &&
+            m_impulse.size() == n);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef SRC_CORE_TG_BULLET_SPRING_CABLE_SOLVER_H_
+#define SRC_CORE_TG_BULLET_SPRING_CABLE_SOLVER_H_
+
+/**
+ * @file tgBulletSpringCableSolver.h
+ * @brief Definition of class tgBulletSpringCableSolver
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btAlignedObjectArray.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward references
+class btRigidBody;
+class tgBulletSpringCable;
+
+/**
+ * Computes the forces of every registered tgBulletSpringCable in one
+ * pass, instead of one virtual step per cable. Cable parameters and
+ * state are kept in contiguous arrays so the force loop is free of
+ * pointer chasing and can be vectorized by the compiler; impulses are
+ * then scattered to the rigid bodies.
+ *
+ * The forces are the same as tgBulletSpringCable::calculateAndApplyForce.
+ * Owned by tgWorldBulletPhysicsImpl and run from Bullet's pre-tick
+ * callback, at the start of each of Bullet's internal steps. The first
+ * sees the same positions and rest lengths the actuators would have
+ * used at the end of the previous world step. Velocity and damping (and
+ * so actuator history) are therefore updated at the start of a step
+ * rather than the end of the previous one.
+ *
+ * Implicit cables take the tension at the end of the step rather
+ * than the start, so the impulse accounts for how it changes the
+ * cable's own length rate. The coupled impulses of all cables are
+ * found by projected Gauss-Seidel, like Bullet's sequential impulse
+ * solver. Cables can only pull, and only while they would be taut at
+ * the end of the step. This is stable for any stiffness and timestep,
+ * at the cost of some numerical damping, and the damping clamp is no
+ * longer needed.
+ */
+class tgBulletSpringCableSolver
+{
+public:
+
+    /**
+     * @param[in] implicit whether to solve for implicit impulses
+     * @param[in] iterations Gauss-Seidel sweeps for implicit impulses.
+     * Must be positive.
+     */
+    explicit tgBulletSpringCableSolver(bool implicit = false,
+                                       std::size_t iterations = 10);
+
+    /** Detaches any cables that are still registered */
+    ~tgBulletSpringCableSolver();
+
+    /**
+     * Take over force calculation for this cable. Only plain
+     * tgBulletSpringCables with two anchors are accepted, subclasses
+     * such as tgBulletContactSpringCable keep their own step.
+     * @return true if the cable will be stepped by this solver
+     */
+    bool add(tgBulletSpringCable* cable);
+
+    /**
+     * Stop computing forces for this cable, it will have to be stepped
+     * on its own again. Called by the cable's destructor.
+     */
+    void remove(tgBulletSpringCable* cable);
+
+    /**
+     * Copy a cable's state back into the arrays after it was changed
+     * from outside, i.e. restored from a tgSnapshot
+     */
+    void reload(const tgBulletSpringCable* cable);
+
+    /**
+     * Calculate and apply the forces of all cables for this step, from
+     * the bodies' current transforms and velocities
+     * @param[in] dt must be positive
+     */
+    void step(double dt);
+
+    std::size_t size() const
+    {
+        return m_cables.size();
+    }
+
+    bool isImplicit() const
+    {
+        return m_implicit;
+    }
+
+private:
+
+    /** Anchor positions of cable i, from its bodies' transforms */
+    void gatherAnchors(std::size_t i);
+
+    /** Turn the gathered anchor distances into impulses over dt */
+    void computeImpulses(double dt);
+
+    void applyImpulses();
+
+    /**
+     * Solve for and apply the implicit impulses over dt, from the
+     * gathered anchor distances
+     */
+    void solveImplicit(double dt);
+
+    /** Copy state the solver does not own back into each cable */
+    void scatterState();
+
+    bool invariant() const;
+
+    std::vector<tgBulletSpringCable*> m_cables;
+
+    /** @name Anchor geometry, in body coordinates */
+    /**@{*/
+    std::vector<btRigidBody*> m_body1;
+    std::vector<btRigidBody*> m_body2;
+    btAlignedObjectArray<btVector3> m_local1;
+    btAlignedObjectArray<btVector3> m_local2;
+    /**@}*/
+
+    /** @name Constant parameters */
+    /**@{*/
+    std::vector<double> m_coefK;
+    std::vector<double> m_coefD;
+    /**@}*/
+
+    /** @name Per step state and scratch */
+    /**@{*/
+    std::vector<double> m_restLength;
+    std::vector<double> m_prevLength;
+    std::vector<double> m_velocity;
+    std::vector<double> m_damping;
+    std::vector<double> m_dx;
+    std::vector<double> m_dy;
+    std::vector<double> m_dz;
+    btAlignedObjectArray<btVector3> m_rel1;
+    btAlignedObjectArray<btVector3> m_rel2;
+    /**@}*/
+
+    /** @name Implicit solver scratch */
+    /**@{*/
+    btAlignedObjectArray<btVector3> m_direction;
+    /** Inverse of the effective mass along the cable */
+    std::vector<double> m_invMass;
+    /** Length beyond rest length at the start of the step */
+    std::vector<double> m_stretch;
+    /** Spring impulse at the current length */
+    std::vector<double> m_bias;
+    /** Impulse per unit length rate, dt * (k * dt + c) */
+    std::vector<double> m_gain;
+    /** Scales each Gauss-Seidel correction, 1 / (1 + gain / mass) */
+    std::vector<double> m_softness;
+    /** Accumulated over the sweeps */
+    std::vector<double> m_impulse;
+    /**@}*/
+
+    const bool m_implicit;
+    const std::size_t m_iterations;
+};
+
+#endif // SRC_CORE_TG_BULLET_SPRING_CABLE_SOLVER_H_
@@ -51,6 +51,18 @@ btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld,
     if (isDynamic)
             shape->calculateLocalInertia(mass,localInertia);
 
+    return createRigidBody(dynamicsWorld, mass, startTransform, shape,
+                           localInertia);
+}
+
+btRigidBody* tgBulletUtil::createRigidBody(btDynamicsWorld* dynamicsWorld, 
+                                           float mass, 
+                                           const btTransform& startTransform, 
+                                           btCollisionShape* shape,
+                                           const btVector3& localInertia)
+{
+    btAssert((!shape || shape->getShapeType() != INVALID_SHAPE_PROXYTYPE));
+
 //using motionstate is recommended, it provides interpolation capabilities, and only synchronizes 'active' objects
 
 #define USE_MOTIONSTATE 1
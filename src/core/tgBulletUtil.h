@@ -31,6 +31,7 @@ class btCollisionShape;
 class btDynamicsWorld;
 class btRigidBody;
 class btTransform;
+class btVector3;
 class tgWorld;
 
 /**
@@ -46,6 +47,16 @@ public:
                                         float mass, 
                                         const btTransform& startTransform, 
                                         btCollisionShape* shape);
+
+    /**
+     * As above, with the local inertia already computed by the caller
+     * (e.g. on a build thread). Only adds the body to the world.
+     */
+    static btRigidBody* createRigidBody(btDynamicsWorld* dynamicsWorld, 
+                                        float mass, 
+                                        const btTransform& startTransform, 
+                                        btCollisionShape* shape,
+                                        const btVector3& localInertia);
     /**
      * Assuming that world has a tgWorldBulletPhysicsImpl, return
      * its dynamics world.
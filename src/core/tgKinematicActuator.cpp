@@ -28,13 +28,13 @@
 // The NTRT Core libary
 #include "core/tgBulletSpringCable.h"
 #include "core/tgModelVisitor.h"
+#include "core/tgSnapshot.h"
 #include "core/tgWorld.h"
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
 #include <cmath>
-#include <deque> // For history
 #include <iostream>
 #include <stdexcept>
 
@@ -163,6 +163,24 @@ void tgKinematicActuator::onVisit(const tgModelVisitor& r) const
 #endif //BT_NO_PROFILE	
     r.render(*this);
 }
+
+void tgKinematicActuator::saveState(tgSnapshot& snapshot)
+{
+    snapshot.write(m_motorVel);
+    snapshot.write(m_motorAcc);
+    snapshot.write(m_desiredTorque);
+    snapshot.write(m_appliedTorque);
+    tgSpringCableActuator::saveState(snapshot);
+}
+
+void tgKinematicActuator::restoreState(tgSnapshot& snapshot)
+{
+    m_motorVel = snapshot.read();
+    m_motorAcc = snapshot.read();
+    m_desiredTorque = snapshot.read();
+    m_appliedTorque = snapshot.read();
+    tgSpringCableActuator::restoreState(snapshot);
+}
     
 void tgKinematicActuator::logHistory()
 {
@@ -170,11 +188,11 @@ void tgKinematicActuator::logHistory()
 
     if (m_config.hist)
     {
-        m_pHistory->lastLengths.push_back(m_springCable->getActualLength());
-        m_pHistory->lastVelocities.push_back(m_motorVel);
-        m_pHistory->dampingHistory.push_back(m_springCable->getDamping());
-        m_pHistory->restLengths.push_back(m_springCable->getRestLength());
-        m_pHistory->tensionHistory.push_back(m_appliedTorque);
+        m_pHistory->record(m_springCable->getActualLength(),
+                           m_motorVel,
+                           m_springCable->getDamping(),
+                           m_springCable->getRestLength(),
+                           m_appliedTorque);
     }
 }
     
@@ -137,6 +137,11 @@ public:
      */
     virtual void onVisit(const tgModelVisitor& r) const;
     
+    /** Saves the motor state, then everything tgSpringCableActuator saves */
+    virtual void saveState(tgSnapshot& snapshot);
+    
+    virtual void restoreState(tgSnapshot& snapshot);
+    
     /**
      * Functions for interfacing with muscle2P, and higher level controllers
      */
@@ -26,24 +26,31 @@
 #include "tgModel.h"
 // This application
 #include "tgModelVisitor.h"
+#include "tgTagRegistry.h"
 #include "abstractMarker.h"
 // The C++ Standard Library
 #include <stdexcept>
 
-tgModel::tgModel()
+tgModel::tgModel() :
+  m_tagIndexValid(false),
+  m_pParent(NULL)
 {
   // Postcondition
   assert(invariant());
 }
 
 tgModel::tgModel(const tgTags& tags) :
-        tgTaggable(tags)
+        tgTaggable(tags),
+        m_tagIndexValid(false),
+        m_pParent(NULL)
 {
   assert(invariant());
 }
 
 tgModel::~tgModel()
 {
+  invalidateTagIndexes();
+
   const size_t n = m_children.size();
   for (size_t i = 0; i < n; ++i)
   {
@@ -67,6 +74,7 @@ void tgModel::setup(tgWorld& world)
 
 void tgModel::teardown()
 {
+  invalidateTagIndexes();
   for (std::size_t i = 0; i < m_children.size(); i++)
   {
     m_children[i]->teardown();
@@ -119,6 +127,26 @@ void tgModel::onVisit(const tgModelVisitor& r) const
   assert(invariant());
 }
 
+void tgModel::saveState(tgSnapshot& snapshot)
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++) {
+    tgModel * const pChild = m_children[i];
+    assert(pChild != NULL);
+    pChild->saveState(snapshot);
+  }
+}
+
+void tgModel::restoreState(tgSnapshot& snapshot)
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++) {
+    tgModel * const pChild = m_children[i];
+    assert(pChild != NULL);
+    pChild->restoreState(snapshot);
+  }
+}
+
 void tgModel::addChild(tgModel* pChild)
 {
   // Preconditoin
@@ -130,17 +158,14 @@ void tgModel::addChild(tgModel* pChild)
   {
     throw std::invalid_argument("child is this object");
   } 
-  else 
+  else if (hasDescendant(pChild))
   {
-    const std::vector<tgModel*> descendants = getDescendants();
-    if (std::find(descendants.begin(), descendants.end(), pChild) !=
-    descendants.end())
-    {
-      throw std::invalid_argument("child is already a descendant");
-    }
+    throw std::invalid_argument("child is already a descendant");
   }
 
   m_children.push_back(pChild);
+  pChild->m_pParent = this;
+  invalidateTagIndexes();
 
   // Postcondition
   assert(invariant());
@@ -170,6 +195,12 @@ std::string tgModel::toString(std::string prefix) const
 std::vector<tgModel*> tgModel::getDescendants() const
 {
   std::vector<tgModel*> result;
+  appendDescendants(result);
+  return result;
+}
+
+void tgModel::appendDescendants(std::vector<tgModel*>& result) const
+{
   const size_t n = m_children.size();
   for (std::size_t i = 0; i < n; i++)
   {
@@ -177,12 +208,109 @@ std::vector<tgModel*> tgModel::getDescendants() const
     assert(pChild != NULL);
     result.push_back(pChild);
     // Recursion
-    const std::vector<tgModel*> cd = pChild->getDescendants();
-    result.insert(result.end(), cd.begin(), cd.end());
+    pChild->appendDescendants(result);
+  }
+}
+
+bool tgModel::hasDescendant(const tgModel* pModel) const
+{
+  const size_t n = m_children.size();
+  for (std::size_t i = 0; i < n; i++)
+  {
+    if (m_children[i] == pModel || m_children[i]->hasDescendant(pModel))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<tgModel*> tgModel::findTagged(const tgTagSearch& tagSearch) const
+{
+  updateTagIndex();
+
+  // Start from the required tag with the fewest carriers
+  const std::vector<std::size_t> required = tagSearch.getRequiredIds();
+  const std::vector<tgModel*>* pCandidates = &m_indexedDescendants;
+  for (std::size_t i = 0; i < required.size(); i++)
+  {
+    const TagIndex::const_iterator it = m_tagIndex.find(required[i]);
+    if (it == m_tagIndex.end())
+    {
+      // Nothing here carries this tag
+      return std::vector<tgModel*>();
+    }
+    if (it->second.size() < pCandidates->size())
+    {
+      pCandidates = &it->second;
+    }
+  }
+
+  std::vector<tgModel*> result;
+  for (std::size_t i = 0; i < pCandidates->size(); i++)
+  {
+    tgModel* const pModel = (*pCandidates)[i];
+    if (tagSearch.matches(*pModel))
+    {
+      result.push_back(pModel);
+    }
   }
   return result;
 }
 
+void tgModel::updateTagIndex() const
+{
+  if (m_tagIndexValid)
+  {
+    return;
+  }
+
+  m_tagIndex.clear();
+  m_indexedDescendants.clear();
+  appendDescendants(m_indexedDescendants);
+
+  // Descendants are visited in order, so each list keeps that order
+  for (std::size_t i = 0; i < m_indexedDescendants.size(); i++)
+  {
+    tgModel* const pModel = m_indexedDescendants[i];
+    const tgTags& tags = static_cast<const tgModel*>(pModel)->getTags();
+    for (int j = 0; j < tags.size(); j++)
+    {
+      m_tagIndex[tgTagRegistry::intern(tags[j])].push_back(pModel);
+    }
+  }
+
+  m_tagIndexValid = true;
+}
+
+void tgModel::invalidateTagIndexes() const
+{
+  // An ancestor may have rebuilt its index since this one went stale,
+  // so always walk to the root
+  for (const tgModel* pModel = this; pModel != NULL; pModel = pModel->m_pParent)
+  {
+    pModel->m_tagIndexValid = false;
+  }
+}
+
+void tgModel::setTags(const tgTags& tags)
+{
+  tgTaggable::setTags(tags);
+  invalidateTagIndexes();
+}
+
+void tgModel::addTags(const std::string& space_separated_tags)
+{
+  tgTaggable::addTags(space_separated_tags);
+  invalidateTagIndexes();
+}
+
+void tgModel::addTags(const tgTags& tags)
+{
+  tgTaggable::addTags(tags);
+  invalidateTagIndexes();
+}
+
 /**
  * For tgSenseable: just return the results of getDescendants here.
  * This should be OK, since a vector of tgModel* is also a vector of
@@ -32,11 +32,14 @@
 #include "tgTagSearch.h"
 #include "tgSenseable.h"
 // The C++ Standard Library
+#include <cstddef>
 #include <iostream>
 #include <vector>
+#include <tr1/unordered_map>
 
 // Forward declarations
 class tgModelVisitor;
+class tgSnapshot;
 class tgWorld;
 class abstractMarker;
 
@@ -97,6 +100,24 @@ public:
     * @param[in,out] r a reference to a tgModelVisitor
     */
     virtual void onVisit(const tgModelVisitor& r) const;
+    
+    /**
+     * Append the dynamic state of this model and its descendants to
+     * snapshot, see tgSimulation::snapshot(). Subclasses with state of
+     * their own write it and then call this. Subclasses that are also a
+     * tgSubject should call notifySaveState so their controllers can
+     * save theirs.
+     * @param[in,out] snapshot the buffer to append to
+     */
+    virtual void saveState(tgSnapshot& snapshot);
+    
+    /**
+     * Read back, in place, what saveState wrote. The model must have
+     * the same structure as when the snapshot was taken.
+     * @param[in,out] snapshot the buffer to read from
+     * @throw std::runtime_error if the snapshot runs out
+     */
+    virtual void restoreState(tgSnapshot& snapshot);
 
     /**
     * Add a sub-model to this model.
@@ -127,7 +148,7 @@ public:
     template <typename T>
     std::vector<T*> find(const tgTagSearch& tagSearch)
     {
-        return tgCast::find<tgModel, T>(tagSearch, getDescendants());
+        return tgCast::filter<tgModel, T>(findTagged(tagSearch));
     }
 	
 	/**
@@ -140,8 +161,33 @@ public:
     template <typename T>
     std::vector<T*> find(const std::string& tagSearch)
     {
-        return tgCast::find<tgModel, T>(tgTagSearch(tagSearch), getDescendants());
+        return tgCast::filter<tgModel, T>(findTagged(tgTagSearch(tagSearch)));
     }
+    
+    /**
+     * Get the descendants that match a tag search, in the same order as
+     * getDescendants(). Looks the rarest required tag of the search up
+     * in an index from tag to descendants, so the cost is proportional
+     * to that tag's matches rather than to the size of the model. The index
+     * is built on first use and rebuilt after any model's children or
+     * tags change.
+     * @param[in] tagSearch, a tagSearch that contains the desired tags
+     * @return the matching descendants, of any type
+     */
+    std::vector<tgModel*> findTagged(const tgTagSearch& tagSearch) const;
+    
+    /**
+     * Replaces tgTaggable::setTags so tag indexes see the change. Tags
+     * changed through getTags() are not seen; set them before adding
+     * the model to a parent.
+     */
+    void setTags(const tgTags& tags);
+    
+    /** Replaces tgTaggable::addTags so tag indexes see the change */
+    void addTags(const std::string& space_separated_tags);
+    
+    /** Replaces tgTaggable::addTags so tag indexes see the change */
+    void addTags(const tgTags& tags);
 
     /**
      * Return a std::vector of const pointers to all sub-models.
@@ -167,8 +213,41 @@ private:
 
     /** Integrity predicate. */
     bool invariant() const;
+    
+    /** Append the descendants to result, depth first */
+    void appendDescendants(std::vector<tgModel*>& result) const;
+    
+    /** Search the tree without copying it */
+    bool hasDescendant(const tgModel* pModel) const;
+    
+    /** Rebuild m_tagIndex if the tree or any tags changed since */
+    void updateTagIndex() const;
+    
+    /** Mark the tag index of this model and its ancestors out of date */
+    void invalidateTagIndexes() const;
 
 private:
+    
+    /** Tag id (see tgTagRegistry) to the descendants carrying it */
+    typedef std::tr1::unordered_map<std::size_t, std::vector<tgModel*> > TagIndex;
+    
+    mutable TagIndex m_tagIndex;
+    
+    /** getDescendants() as of the last index build */
+    mutable std::vector<tgModel*> m_indexedDescendants;
+    
+    /**
+     * Cleared whenever children or tags change here or in any
+     * descendant. Kept per tree rather than globally, so models in
+     * different worlds (or threads) don't touch each other's indexes.
+     */
+    mutable bool m_tagIndexValid;
+    
+    /**
+     * The model this one was last added to with addChild, NULL for a
+     * root. Not owned. A model has at most one parent.
+     */
+    tgModel* m_pParent;
 
     /**
      * The collection of child models.
@@ -27,6 +27,9 @@
  * $Id$
  */
 
+// Forward declarations
+class tgSnapshot;
+
 /**
  * A mixin class which makes its derived class the Subject in the Obsever
  * design pattern. These are typically controllers.
@@ -66,6 +69,22 @@ public:
      */    
     virtual void onTeardown(Subject& subject) { }
     
+    /**
+     * Notify the observers that the subject's state is being saved, so
+     * they can append their own. See tgModel::saveState
+     * @param[in,out] subject the subject being observed
+     * @param[in,out] snapshot the buffer to write to
+     */
+    virtual void onSaveState(Subject& subject, tgSnapshot& snapshot) { }
+    
+    /**
+     * Notify the observers that the subject's state is being restored.
+     * Must read exactly what onSaveState wrote.
+     * @param[in,out] subject the subject being observed
+     * @param[in,out] snapshot the buffer to read from
+     */
+    virtual void onRestoreState(Subject& subject, tgSnapshot& snapshot) { }
+    
 };
    
 #endif
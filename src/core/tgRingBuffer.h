@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RING_BUFFER_H
+#define TG_RING_BUFFER_H
+
+/**
+ * @file tgRingBuffer.h
+ * @brief Definition of tgRingBuffer, a bounded FIFO sequence used for
+ * actuator history
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+/**
+ * A sequence with the parts of the std::deque interface used for actuator
+ * history (push_back, operator[], front, back, size, iteration). When a
+ * capacity is set, the buffer holds at most that many elements and
+ * push_back overwrites the oldest one, so memory stays fixed no matter
+ * how long the simulation runs. A capacity of zero means unbounded.
+ * Index 0 is always the oldest retained element.
+ */
+template <typename T>
+class tgRingBuffer
+{
+public:
+
+    /** Read-only iterator from the oldest to the newest element. */
+    class const_iterator :
+        public std::iterator<std::forward_iterator_tag, T, std::ptrdiff_t,
+                             const T*, const T&>
+    {
+    public:
+        const_iterator() : m_pBuffer(NULL), m_index(0) { }
+        const_iterator(const tgRingBuffer* pBuffer, std::size_t index) :
+            m_pBuffer(pBuffer), m_index(index) { }
+
+        const T& operator*() const { return (*m_pBuffer)[m_index]; }
+        const T* operator->() const { return &(*m_pBuffer)[m_index]; }
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int)
+        {
+            const_iterator result(*this);
+            ++m_index;
+            return result;
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return (m_pBuffer == other.m_pBuffer) && (m_index == other.m_index);
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const tgRingBuffer* m_pBuffer;
+        std::size_t m_index;
+    };
+
+    /** @param capacity maximum number of elements kept, 0 for unbounded */
+    explicit tgRingBuffer(std::size_t capacity = 0) :
+        m_capacity(capacity),
+        m_head(0)
+    {
+        m_data.reserve(capacity);
+    }
+
+    /**
+     * Append an element. If the buffer is full the oldest element is
+     * overwritten.
+     */
+    void push_back(const T& value)
+    {
+        if (m_capacity == 0 || m_data.size() < m_capacity)
+        {
+            m_data.push_back(value);
+        }
+        else
+        {
+            m_data[m_head] = value;
+            m_head = (m_head + 1) % m_capacity;
+        }
+    }
+
+    /** Remove all elements, keeping the capacity. */
+    void clear()
+    {
+        m_data.clear();
+        m_head = 0;
+    }
+
+    std::size_t size() const { return m_data.size(); }
+
+    bool empty() const { return m_data.empty(); }
+
+    /** The maximum number of elements retained, 0 if unbounded. */
+    std::size_t capacity() const { return m_capacity; }
+
+    /** Element i, counting from the oldest retained element. */
+    const T& operator[](std::size_t i) const
+    {
+        assert(i < m_data.size());
+        const std::size_t j = m_head + i;
+        return m_data[j < m_data.size() ? j : j - m_data.size()];
+    }
+
+    T& operator[](std::size_t i)
+    {
+        assert(i < m_data.size());
+        const std::size_t j = m_head + i;
+        return m_data[j < m_data.size() ? j : j - m_data.size()];
+    }
+
+    const T& front() const { return (*this)[0]; }
+
+    const T& back() const { return (*this)[m_data.size() - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, m_data.size()); }
+
+private:
+
+    /** Storage, at most m_capacity long when bounded. */
+    std::vector<T> m_data;
+
+    /** Maximum number of elements, or 0 for unbounded. */
+    std::size_t m_capacity;
+
+    /** Index in m_data of the oldest element once the buffer has wrapped. */
+    std::size_t m_head;
+};
+
+#endif  // TG_RING_BUFFER_H
@@ -30,6 +30,7 @@
 #include "tgSimView.h"
 #include "tgSimViewGraphics.h"
 #include "tgWorld.h"
+#include "tgWorldBulletPhysicsImpl.h"
 #include "sensors/tgDataManager.h" //for loggers etc.
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
@@ -133,6 +134,57 @@ void tgSimulation::onVisit(const tgModelVisitor& r) const
         }
 }
 
+void tgSimulation::snapshot(tgSnapshot& snapshot) const
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgSimulation::snapshot");
+#endif //BT_NO_PROFILE	
+    snapshot.clear();
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        m_models[i]->saveState(snapshot);
+    }
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        m_obstacles[i]->saveState(snapshot);
+    }
+}
+
+tgSnapshot tgSimulation::snapshot() const
+{
+    tgSnapshot result;
+    snapshot(result);
+    return result;
+}
+
+void tgSimulation::restore(tgSnapshot& snapshot)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("tgSimulation::restore");
+#endif //BT_NO_PROFILE	
+    snapshot.rewind();
+    for (std::size_t i = 0; i < m_models.size(); i++)
+    {
+        m_models[i]->restoreState(snapshot);
+    }
+    for (std::size_t i = 0; i < m_obstacles.size(); i++)
+    {
+        m_obstacles[i]->restoreState(snapshot);
+    }
+    if (!snapshot.atEnd())
+    {
+        throw std::runtime_error("Snapshot does not match the models being restored");
+    }
+    
+    // Avoid dynamic_cast, as in tgBulletUtil::worldToDynamicsWorld
+    tgWorldBulletPhysicsImpl& impl =
+        static_cast<tgWorldBulletPhysicsImpl&>(m_view.world().implementation());
+    impl.clearContactCache();
+    
+    // Postcondition
+    assert(invariant());
+}
+
 void tgSimulation::reset()
 {
 
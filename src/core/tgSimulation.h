@@ -26,6 +26,8 @@
  * $Id$
  */
 
+// This application
+#include "tgSnapshot.h"
 // The C++ Standard Library
 #include <iostream>
 #include <vector>
@@ -121,6 +123,33 @@ public:
      */
     void reset(tgGround* newGround);
     
+    /**
+     * Capture the dynamic state of the models and obstacles: rigid body
+     * transforms and velocities, cable rest lengths, actuator motor state
+     * and whatever their controllers save (see tgModel::saveState).
+     * Restoring it with restore() is much cheaper than reset(), which
+     * rebuilds the world and every model.
+     * @param[out] snapshot cleared, then filled; reuse it to avoid
+     * reallocating
+     */
+    void snapshot(tgSnapshot& snapshot) const;
+    
+    /**
+     * Convenience overload of snapshot(tgSnapshot&)
+     */
+    tgSnapshot snapshot() const;
+    
+    /**
+     * Put the models and obstacles back in the state captured by
+     * snapshot(), in place, and drop the world's cached contacts.
+     * Models, obstacles and data managers must not have been added or
+     * removed (i.e. by reset()) since the snapshot was taken. Data
+     * managers and actuator histories are not rewound.
+     * @param[in,out] snapshot read from the start
+     * @throw std::runtime_error if the snapshot does not match the models
+     */
+    void restore(tgSnapshot& snapshot);
+    
     /**
      * Returns a reference to the world
      */
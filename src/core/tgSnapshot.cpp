@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSnapshot.cpp
+ * @brief Contains the definitions of members of class tgSnapshot
+ * $Id$
+ */
+
+// This module
+#include "tgSnapshot.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+tgSnapshot::tgSnapshot() :
+    m_cursor(0)
+{
+}
+
+double tgSnapshot::read()
+{
+    if (m_cursor >= m_values.size())
+    {
+        throw std::runtime_error("Snapshot does not match the models being restored");
+    }
+    return m_values[m_cursor++];
+}
+
+void tgSnapshot::clear()
+{
+    m_values.clear();
+    m_cursor = 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SNAPSHOT_H
+#define TG_SNAPSHOT_H
+
+/**
+ * @file tgSnapshot.h
+ * @brief Definition of class tgSnapshot
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A flat buffer of the dynamic state of a simulation, written by
+ * tgModel::saveState and read back in the same order by
+ * tgModel::restoreState. The layout is defined only by the order of the
+ * writes, so a snapshot can only be restored into the model tree it
+ * was taken from. See tgSimulation::snapshot().
+ */
+class tgSnapshot
+{
+public:
+
+    tgSnapshot();
+
+    /** Append a value to the end of the buffer */
+    void write(double value)
+    {
+        m_values.push_back(value);
+    }
+
+    /**
+     * Read the next value.
+     * @throw std::runtime_error if every value has been read, i.e. the
+     * snapshot came from a different set of models
+     */
+    double read();
+
+    /** Start reading from the first value again */
+    void rewind()
+    {
+        m_cursor = 0;
+    }
+
+    /** True once read() has consumed every value */
+    bool atEnd() const
+    {
+        return m_cursor == m_values.size();
+    }
+
+    /** Discard the contents, keeping the allocation for reuse */
+    void clear();
+
+    /** The number of values written */
+    std::size_t size() const
+    {
+        return m_values.size();
+    }
+
+private:
+
+    std::vector<double> m_values;
+
+    /** Index of the next value to read */
+    std::size_t m_cursor;
+};
+
+#endif // TG_SNAPSHOT_H
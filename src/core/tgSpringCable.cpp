@@ -25,6 +25,7 @@
 // This module
 #include "tgSpringCable.h"
 #include "tgSpringCableAnchor.h"
+#include "tgSnapshot.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -76,3 +77,19 @@ void tgSpringCable::setRestLength( const double newRestLength)
     
     m_restLength = newRestLength;
 }
+
+void tgSpringCable::saveState(tgSnapshot& snapshot) const
+{
+    snapshot.write(m_restLength);
+    snapshot.write(m_prevLength);
+    snapshot.write(m_velocity);
+    snapshot.write(m_damping);
+}
+
+void tgSpringCable::restoreState(tgSnapshot& snapshot)
+{
+    m_restLength = snapshot.read();
+    m_prevLength = snapshot.read();
+    m_velocity = snapshot.read();
+    m_damping = snapshot.read();
+}
@@ -30,6 +30,7 @@
 #include <vector>
 
 // Forward references
+class tgSnapshot;
 class tgSpringCableAnchor;
 
 /**
@@ -78,6 +79,17 @@ public:
      */
     virtual void setRestLength( const double newRestLength); 
     
+    /**
+     * Append rest length, previous length, velocity and damping to
+     * snapshot. Called by tgSpringCableActuator::saveState
+     */
+    virtual void saveState(tgSnapshot& snapshot) const;
+    
+    /**
+     * Read back what saveState wrote
+     */
+    virtual void restoreState(tgSnapshot& snapshot);
+    
     /**
      * Pure virtual funciton, returns the actual length of the spring
      * cable
@@ -26,8 +26,10 @@
 // This Module
 #include "tgSpringCableActuator.h"
 #include "tgSpringCable.h"
+#include "tgSnapshot.h"
 #include "tgWorld.h"
 // The C++ Standard Library
+#include <cassert>
 #include <cmath>
 #include <iostream>
 #include <stdexcept>
@@ -44,11 +46,15 @@ tgSpringCableActuator::Config::Config(double s,
                    double mnRL,
 		   double rot,
    	           bool moveCPA,
-		   bool moveCPB) :
+		   bool moveCPB,
+                   std::size_t histCap,
+                   std::size_t histDec) :
   stiffness(s),
   damping(d),
   pretension(p),
   hist(h),
+  histCapacity(histCap),
+  histDecimation(histDec),
   maxTens(mf),
   targetVelocity(tVel),
   minActualLength(mnAL),
@@ -85,6 +91,60 @@ tgSpringCableActuator::Config::Config(double s,
     {
          throw std::invalid_argument("Abs of rotation is greater than 2pi. Are you sure you're setting the right parameters?");
     }
+    else if (histDec == 0)
+    {
+        throw std::invalid_argument("History decimation is zero.");
+    }
+}
+
+tgSpringCableActuator::SpringCableActuatorHistory::SpringCableActuatorHistory(
+    std::size_t capacity, std::size_t decimation) :
+    lastLengths(capacity),
+    restLengths(capacity),
+    dampingHistory(capacity),
+    lastVelocities(capacity),
+    tensionHistory(capacity),
+    decimation(decimation),
+    sampleCount(0),
+    maxTension(0.0),
+    energySpent(0.0),
+    prevRestLength(0.0),
+    prevTension(0.0)
+{
+    assert(decimation > 0);
+}
+
+void tgSpringCableActuator::SpringCableActuatorHistory::record(double length,
+                                                            double velocity,
+                                                            double damping,
+                                                            double restLength,
+                                                            double tension)
+{
+    if (sampleCount > 0)
+    {
+        const double motorSpeed = restLength - prevRestLength;
+        if (motorSpeed < 0.0)
+        {
+            energySpent += prevTension * motorSpeed;
+        }
+    }
+    if (sampleCount == 0 || tension > maxTension)
+    {
+        maxTension = tension;
+    }
+    
+    if (sampleCount % decimation == 0)
+    {
+        lastLengths.push_back(length);
+        lastVelocities.push_back(velocity);
+        dampingHistory.push_back(damping);
+        restLengths.push_back(restLength);
+        tensionHistory.push_back(tension);
+    }
+    
+    prevRestLength = restLength;
+    prevTension = tension;
+    ++sampleCount;
 }
 
 void tgSpringCableActuator::Config::scale (double sf)
@@ -119,7 +179,8 @@ tgSpringCableActuator::tgSpringCableActuator(tgSpringCable* springCable,
     tgModel(tags),
     m_springCable(springCable),
     m_config(config),
-    m_pHistory(new SpringCableActuatorHistory()),
+    m_pHistory(new SpringCableActuatorHistory(config.histCapacity,
+                                              config.histDecimation)),
     m_restLength(springCable->getRestLength()),
     m_startLength(springCable->getActualLength()),
     m_prevVelocity(0.0)
@@ -159,6 +220,24 @@ void tgSpringCableActuator::step(double dt)
     }
 }
 
+void tgSpringCableActuator::saveState(tgSnapshot& snapshot)
+{
+    snapshot.write(m_restLength);
+    snapshot.write(m_prevVelocity);
+    m_springCable->saveState(snapshot);
+    notifySaveState(snapshot);
+    tgModel::saveState(snapshot);
+}
+
+void tgSpringCableActuator::restoreState(tgSnapshot& snapshot)
+{
+    m_restLength = snapshot.read();
+    m_prevVelocity = snapshot.read();
+    m_springCable->restoreState(snapshot);
+    notifyRestoreState(snapshot);
+    tgModel::restoreState(snapshot);
+}
+
 const double tgSpringCableActuator::getStartLength() const
 {
     return m_startLength;
@@ -32,7 +32,9 @@
 #include "tgControllable.h"
 #include "tgSubject.h"
 
-#include <deque> // For history
+#include "tgRingBuffer.h" // For history
+// The C++ Standard Library
+#include <cstddef>
 // Forward declarations
 class tgWorld;
 class tgSpringCable;
@@ -66,7 +68,9 @@ public:
         double mnRL = 0.1,
 	double rot = 0,
 	bool moveCPA = true,
-	bool moveCPB = true);
+	bool moveCPB = true,
+        std::size_t histCap = 0,
+        std::size_t histDec = 1);
       
       /**
        * Scale parameters that depend on the length of the simulation.
@@ -102,9 +106,23 @@ public:
       // History Parameters
       /**
        * Specifies whether data such as length and tension will be stored
-       * in deque objects. Useful for computing the energy of a trial.
+       * in the history buffers. Useful for computing the energy of a trial.
        */
       bool hist;
+      
+      /**
+       * Maximum number of samples kept in each history buffer. Once full,
+       * the oldest samples are overwritten so memory use per cable is
+       * fixed. Zero keeps every sample (the original behavior).
+       */
+      std::size_t histCapacity;
+      
+      /**
+       * Store only every histDecimation-th sample in the history buffers.
+       * Must be at least 1. The running aggregates in
+       * SpringCableActuatorHistory are still updated every step.
+       */
+      std::size_t histDecimation;
               
       // Motor model parameters
       /**
@@ -178,23 +196,66 @@ public:
       
     };
     
-    /** Encapsulate the history members. */
+    /**
+     * Encapsulate the history members. The sequences are bounded by
+     * Config::histCapacity and thinned by Config::histDecimation; the
+     * aggregates below always cover every logged step.
+     */
     struct SpringCableActuatorHistory
     {
+        /**
+         * @param[in] capacity the maximum samples per sequence, 0 for
+         * unbounded
+         * @param[in] decimation store every decimation-th sample, must be
+         * at least 1
+         */
+        SpringCableActuatorHistory(std::size_t capacity = 0,
+                                   std::size_t decimation = 1);
+        
+        /**
+         * Log one step: update the aggregates and, subject to decimation,
+         * append to each sequence.
+         */
+        void record(double length, double velocity, double damping,
+                    double restLength, double tension);
+        
         /** Length history. */
-        std::deque<double> lastLengths;
+        tgRingBuffer<double> lastLengths;
         
         /** Rest length history. */
-        std::deque<double> restLengths;
+        tgRingBuffer<double> restLengths;
 
         /** Damping history. */
-        std::deque<double> dampingHistory;
+        tgRingBuffer<double> dampingHistory;
 
         /** Velocity history. */
-        std::deque<double> lastVelocities;
+        tgRingBuffer<double> lastVelocities;
         
         /** Tension history. */
-        std::deque<double> tensionHistory;
+        tgRingBuffer<double> tensionHistory;
+        
+        /** Store every decimation-th sample in the sequences. */
+        std::size_t decimation;
+        
+        /** Number of steps passed to record(), stored or not. */
+        std::size_t sampleCount;
+        
+        /** Largest tension seen over all recorded steps. */
+        double maxTension;
+        
+        /**
+         * Running sum of previous tension * change in rest length over
+         * steps where the rest length shrank, i.e. the motor work
+         * computed by the learning controllers from the full history.
+         * Non-positive.
+         */
+        double energySpent;
+        
+        /** Rest length at the previous recorded step. */
+        double prevRestLength;
+        
+        /** Tension at the previous recorded step. */
+        double prevTension;
     };
 
     /** Deletes history and spring cable instantiation */
@@ -209,6 +270,16 @@ public:
     /** Just calls tgModel::step(dt) - steps any children */
     virtual void step(double dt);
     
+    /**
+     * Saves the rest length and the spring cable's state, then notifies
+     * observers and saves any children. History is not part of the
+     * snapshot and keeps accumulating across a restore.
+     */
+    virtual void saveState(tgSnapshot& snapshot);
+    
+    /** Reads back what saveState wrote, in the same order */
+    virtual void restoreState(tgSnapshot& snapshot);
+    
     /**
      * Functions for interfacing with tgSpringCable
      */
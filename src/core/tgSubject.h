@@ -78,6 +78,18 @@ public:
      */
     void notifyTeardown();
     
+    /**
+     * Call tgObserver<T>::onSaveState() on all observers in the order in
+     * which they were attached.
+     */
+    void notifySaveState(tgSnapshot& snapshot);
+    
+    /**
+     * Call tgObserver<T>::onRestoreState() on all observers in the order in
+     * which they were attached.
+     */
+    void notifyRestoreState(tgSnapshot& snapshot);
+    
 private:
 
     /**
@@ -129,5 +141,27 @@ void tgSubject<Subject>::notifyTeardown()
         if (pObserver) { pObserver->onTeardown(static_cast<Subject&>(*this)); }
     }
 }
+
+template <typename Subject>
+void tgSubject<Subject>::notifySaveState(tgSnapshot& snapshot)
+{
+    const std::size_t n = m_observers.size();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        tgObserver<Subject>* const pObserver = m_observers[i];
+        if (pObserver) { pObserver->onSaveState(static_cast<Subject&>(*this), snapshot); }
+    }
+}
+
+template <typename Subject>
+void tgSubject<Subject>::notifyRestoreState(tgSnapshot& snapshot)
+{
+    const std::size_t n = m_observers.size();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        tgObserver<Subject>* const pObserver = m_observers[i];
+        if (pObserver) { pObserver->onRestoreState(static_cast<Subject&>(*this), snapshot); }
+    }
+}
 #endif  // TG_SUBJECT_H
 
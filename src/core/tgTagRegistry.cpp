@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgTagRegistry.cpp
+ * @brief Contains the definitions of members of class tgTagRegistry
+ * $Id$
+ */
+
+// This module
+#include "tgTagRegistry.h"
+// POSIX
+#include <pthread.h>
+// The C++ Standard Library
+#include <tr1/unordered_map>
+
+namespace
+{
+    typedef std::tr1::unordered_map<std::string, std::size_t> TagTable;
+
+    /** Statically initialized, so it is ready before any constructor */
+    pthread_mutex_t tableMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * Constructed on first use, so it is safe from static initializers.
+     * Only called with tableMutex held.
+     */
+    TagTable& table()
+    {
+        static TagTable result;
+        return result;
+    }
+
+    /** Holds tableMutex for its lifetime */
+    class TableLock
+    {
+    public:
+        TableLock()
+        {
+            pthread_mutex_lock(&tableMutex);
+        }
+        ~TableLock()
+        {
+            pthread_mutex_unlock(&tableMutex);
+        }
+    };
+}
+
+const std::size_t tgTagRegistry::npos;
+
+std::size_t tgTagRegistry::intern(const std::string& tag)
+{
+    const TableLock lock;
+    TagTable& t = table();
+    const TagTable::const_iterator it = t.find(tag);
+    if (it != t.end())
+    {
+        return it->second;
+    }
+    const std::size_t id = t.size();
+    t.insert(std::make_pair(tag, id));
+    return id;
+}
+
+std::size_t tgTagRegistry::lookup(const std::string& tag)
+{
+    const TableLock lock;
+    const TagTable& t = table();
+    const TagTable::const_iterator it = t.find(tag);
+    return (it != t.end()) ? it->second : npos;
+}
+
+std::size_t tgTagRegistry::size()
+{
+    const TableLock lock;
+    return table().size();
+}
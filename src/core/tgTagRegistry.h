@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_TAG_REGISTRY_H
+#define TG_TAG_REGISTRY_H
+
+/**
+ * @file tgTagRegistry.h
+ * @brief Definition of class tgTagRegistry
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+
+/**
+ * Interns tag strings as small integer ids, so indexes and searches
+ * can compare ids instead of strings. Ids are assigned in order of
+ * first use starting from zero and are never reused. The table is
+ * shared by everything in the process. It is only used when a
+ * tgTagSearch is parsed or a tgModel builds its tag index, never per
+ * match. The only threads that may reach it are tgStructureInfo's
+ * build threads, when a tgBuildSpec opts in to them and an info's
+ * getCollisionShape or initConnector parses a search, so it is locked
+ * for them. Trials run in separate processes, each with its own table.
+ */
+class tgTagRegistry
+{
+public:
+
+    /** Returned by lookup() for a tag that was never interned */
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * The id of tag, assigning the next one if it is new
+     * @param[in] tag a single tag, not a space separated list
+     */
+    static std::size_t intern(const std::string& tag);
+
+    /**
+     * The id of tag without interning it. A tag that was never
+     * interned can't be carried by anything that has been indexed.
+     * @return the id, or npos
+     */
+    static std::size_t lookup(const std::string& tag);
+
+    /** The number of distinct tags interned so far */
+    static std::size_t size();
+};
+
+#endif // TG_TAG_REGISTRY_H
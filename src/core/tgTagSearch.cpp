@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+/**
+ * @file tgTagSearch.cpp
+ * @brief Contains the definitions of members of class tgTagSearch
+ * $Id$
+ */
+
+// This module
+#include "tgTagSearch.h"
+#include "tgTagRegistry.h"
+// The C++ Standard Library
+#include <cassert>
+#include <climits>
+#include <deque>
+
+namespace
+{
+    const std::size_t bitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+
+    void setBit(std::vector<unsigned long>& mask, std::size_t bit)
+    {
+        const std::size_t word = bit / bitsPerWord;
+        if (mask.size() <= word)
+        {
+            mask.resize(word + 1, 0);
+        }
+        mask[word] |= 1UL << (bit % bitsPerWord);
+    }
+
+    void clearBit(std::vector<unsigned long>& mask, std::size_t bit)
+    {
+        const std::size_t word = bit / bitsPerWord;
+        if (word < mask.size())
+        {
+            mask[word] &= ~(1UL << (bit % bitsPerWord));
+        }
+    }
+
+    bool testBit(const std::vector<unsigned long>& mask, std::size_t bit)
+    {
+        const std::size_t word = bit / bitsPerWord;
+        return word < mask.size() &&
+            (mask[word] & (1UL << (bit % bitsPerWord))) != 0;
+    }
+}
+
+void tgTagSearch::parse(const std::string& search_string)
+{
+    // Validity is judged the same way as for tags themselves
+    tgTags validator;
+    const std::deque<std::string> terms = tgTags::splitTags(search_string);
+    for (std::size_t i = 0; i < terms.size(); i++)
+    {
+        Clause clause;
+        const std::deque<std::string> alternatives =
+            tgTags::splitTags(terms[i], '|');
+        for (std::size_t j = 0; j < alternatives.size(); j++)
+        {
+            const bool negated = alternatives[j][0] == '-';
+            const std::string tag =
+                negated ? alternatives[j].substr(1) : alternatives[j];
+            if (!validator.isValid(tag))
+            {
+                throw tgTagException("Invalid tag '" + tag +
+                                     "' in search '" + search_string + "'");
+            }
+            const std::size_t slot = slotFor(tag);
+            setBit(negated ? clause.none : clause.any, slot);
+        }
+        if (alternatives.empty())
+        {
+            throw tgTagException("Empty term in search '" +
+                                 search_string + "'");
+        }
+        m_clauses.push_back(clause);
+    }
+}
+
+std::size_t tgTagSearch::slotFor(const std::string& tag)
+{
+    const std::size_t slot = findSlot(tag);
+    if (slot == m_ids.size())
+    {
+        m_ids.push_back(tgTagRegistry::intern(tag));
+        m_tags.push_back(tag);
+    }
+    return slot;
+}
+
+std::size_t tgTagSearch::findSlot(const std::string& tag) const
+{
+    // Searches name a handful of tags, so a scan beats hashing
+    const std::size_t n = m_tags.size();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        if (m_tags[i] == tag)
+        {
+            return i;
+        }
+    }
+    return n;
+}
+
+const bool tgTagSearch::matches(const tgTags& tags) const
+{
+    if (m_clauses.empty())
+    {
+        return true;
+    }
+
+    // Almost every search fits one word; only allocate when it doesn't
+    const std::size_t words = (m_ids.size() + bitsPerWord - 1) / bitsPerWord;
+    unsigned long one = 0;
+    std::vector<unsigned long> many;
+    unsigned long* present = &one;
+    if (words > 1)
+    {
+        many.resize(words, 0);
+        present = &many[0];
+    }
+
+    const std::deque<std::string>& t = tags.getTags();
+    for (std::size_t i = 0; i < t.size(); i++)
+    {
+        const std::size_t slot = findSlot(t[i]);
+        if (slot < m_ids.size())
+        {
+            present[slot / bitsPerWord] |= 1UL << (slot % bitsPerWord);
+        }
+    }
+    return satisfied(present);
+}
+
+bool tgTagSearch::satisfied(const unsigned long* present) const
+{
+    for (std::size_t i = 0; i < m_clauses.size(); i++)
+    {
+        const Clause& clause = m_clauses[i];
+        bool ok = false;
+        for (std::size_t w = 0; !ok && w < clause.any.size(); w++)
+        {
+            ok = (present[w] & clause.any[w]) != 0;
+        }
+        for (std::size_t w = 0; !ok && w < clause.none.size(); w++)
+        {
+            ok = (~present[w] & clause.none[w]) != 0;
+        }
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::size_t> tgTagSearch::getRequiredIds() const
+{
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < m_clauses.size(); i++)
+    {
+        const Clause& clause = m_clauses[i];
+        std::size_t count = 0;
+        std::size_t last = 0;
+        for (std::size_t slot = 0; slot < m_ids.size(); slot++)
+        {
+            if (testBit(clause.none, slot))
+            {
+                count = 2;
+                break;
+            }
+            if (testBit(clause.any, slot))
+            {
+                ++count;
+                last = slot;
+            }
+        }
+        if (count == 1)
+        {
+            result.push_back(m_ids[last]);
+        }
+    }
+    return result;
+}
+
+void tgTagSearch::remove(const tgTags& tags)
+{
+    const std::deque<std::string>& t = tags.getTags();
+    for (std::size_t i = 0; i < t.size(); i++)
+    {
+        const std::size_t slot = findSlot(t[i]);
+        if (slot == m_ids.size())
+        {
+            continue;
+        }
+
+        std::vector<Clause> kept;
+        for (std::size_t j = 0; j < m_clauses.size(); j++)
+        {
+            Clause& clause = m_clauses[j];
+            if (!testBit(clause.any, slot))
+            {
+                // A clause left with no alternatives can never match
+                clearBit(clause.none, slot);
+                kept.push_back(clause);
+            }
+        }
+        m_clauses.swap(kept);
+    }
+}
@@ -26,24 +26,29 @@
 #ifndef TG_TAG_SEARCH_H
 #define TG_TAG_SEARCH_H
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "tgTags.h"
 #include "tgTaggable.h"
 
-/*  @todo: Implement more advanced search capability
-
-    Currently, tag searches just matches all tags, so something like
-    tgTagSearch("a b").matches(tgTags("a b c")) is true. 
-
-    Plans: search operators like 'or' and 'not', for instance
-    - tgTagSearch("a -b") would match tgTags("a c") but not tgTags("a b")
-    - tgTagSearch("a b|c") would match tgTags("a b") and tgTags("a c") 
-      but not tgTags("a d")
-*/
-
 /**
  * Represents a search to be performed on a tgTaggable
+ *
+ * A search is a space separated list of terms, all of which must match.
+ * A term is a tag, a tag prefixed with '-' that must be absent, or
+ * alternatives joined by '|' of which at least one must match:
+ * - tgTagSearch("a b") matches tgTags("a b c")
+ * - tgTagSearch("a -b") matches tgTags("a c") but not tgTags("a b")
+ * - tgTagSearch("a b|c") matches tgTags("a b") and tgTags("a c")
+ *   but not tgTags("a d")
+ *
+ * The search is parsed once into clauses held as bit masks over the
+ * distinct tags the search mentions. Those tags are interned (see
+ * tgTagRegistry) when the search is parsed, for getRequiredIds(), but
+ * matching only compares candidate tags with the search's own few tags
+ * and never goes back to the registry.
  */
 class tgTagSearch
 {
@@ -51,20 +56,20 @@ public:
     
     tgTagSearch() {}
 
-    tgTagSearch(std::string search_string) : m_search(search_string)
-    {}
+    /**
+     * @throw tgTagException if a term names an invalid tag
+     */
+    tgTagSearch(std::string search_string)
+    {
+        parse(search_string);
+    }
     
     virtual ~tgTagSearch() {}
 
     /**
      * Do the tags match this search?
      */
-    const bool matches(const tgTags& tags) const
-    {
-        // Simple for now, just check that the tags contain the tags in the 
-        // search
-        return tags.contains(m_search);
-    }
+    const bool matches(const tgTags& tags) const;
 
     const bool matches(const tgTaggable& taggable) const
     {
@@ -84,18 +89,49 @@ public:
     }
     
     /**
-     * Remove the given tags from the search
+     * The ids of the tags every match must carry, i.e. the terms that
+     * are a single tag. Other terms still have to be checked with
+     * matches().
      */
-    void remove(const tgTags& tags)
-    {
-        tgTags s(tags);
-        m_search.remove(tags);
-    }
+    std::vector<std::size_t> getRequiredIds() const;
+    
+    /**
+     * Specialize the search for candidates known to carry the given tags:
+     * terms they satisfy are dropped and negations of them can no longer
+     * match.
+     */
+    void remove(const tgTags& tags);
     
 private:
     
-    // @todo: change this to a parsed representation of the and/or/not setup
-    tgTags m_search;
+    /** Bit masks over m_ids, one bit per distinct tag in the search */
+    typedef std::vector<unsigned long> Mask;
+
+    /** Satisfied by a present tag in any, or an absent tag in none */
+    struct Clause
+    {
+        Mask any;
+        Mask none;
+    };
+
+    void parse(const std::string& search_string);
+
+    /** The bit for a tag, adding one if the search didn't use it yet */
+    std::size_t slotFor(const std::string& tag);
+
+    /** The bit for a tag, or m_ids.size() if the search doesn't use it */
+    std::size_t findSlot(const std::string& tag) const;
+
+    bool satisfied(const unsigned long* present) const;
+
+    /** Interned tag id of each bit */
+    std::vector<std::size_t> m_ids;
+
+    /** Tag of each bit */
+    std::vector<std::string> m_tags;
+
+    /** Conjunction of clauses; empty matches everything */
+    std::vector<Clause> m_clauses;
 
 };
 
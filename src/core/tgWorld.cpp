@@ -32,9 +32,19 @@
 #include <cassert>
 #include <stdexcept>
 
-tgWorld::Config::Config(double g, double ws) :
+tgWorld::Config::Config(double g, double ws, bool bc) :
 gravity(g),
-worldSize(ws)
+worldSize(ws),
+batchCables(bc),
+cableSubsteps(1),
+implicitCables(false),
+solver(dantzigMLCP),
+broadphase(axisSweep),
+solverIterations(10),
+splitImpulse(true),
+erp(0.2),
+solverBatchSize(128),
+benchmark(false)
 {
   if (ws <= 0.0)
   {
@@ -44,7 +44,27 @@ public:
    */
   struct Config
   {
-	Config(double g = 9.81, double ws = 1000);
+    /** Constraint solvers Bullet can use for contacts and joints */
+    enum Solver
+    {
+      /** Iterative; cost grows linearly with the number of contacts */
+      sequentialImpulse,
+      /** Direct MLCP solver; accurate, but cubic in the batch size */
+      dantzigMLCP,
+      /** Projected Gauss-Seidel MLCP solver */
+      pgsMLCP
+    };
+
+    /** Broadphase collision detection */
+    enum Broadphase
+    {
+      /** Dynamic AABB tree; needs no world bounds */
+      dbvt,
+      /** Sweep and prune inside a cube of side worldSize */
+      axisSweep
+    };
+
+	Config(double g = 9.81, double ws = 1000, bool bc = false);
     /**
      * Gravitational acceleration.
      * The units are application depenent.
@@ -56,6 +76,56 @@ public:
      * the length of one side of the detection cube. Must be positive.
      */
     double worldSize;
+    /**
+     * Compute the forces of all tgBasicActuator cables in one batch at
+     * the start of each world step (see tgBulletSpringCableSolver)
+     * instead of in each actuator's step. The forces are unchanged, but
+     * velocity and damping history lag by one step.
+     */
+    bool batchCables;
+    /**
+     * Split each world step into this many Bullet steps, with the
+     * batched cable forces recomputed before each one, so stiff cables
+     * stay stable while models and controllers step at the full dt.
+     * Contacts, constraints and gravity are solved at the substep too,
+     * so each substep costs a full Bullet step. Needs batchCables if
+     * greater than 1. Defaults to 1.
+     */
+    int cableSubsteps;
+    /**
+     * Solve batched cable impulses implicitly, so stiff cables are
+     * stable at large timesteps (see tgBulletSpringCableSolver). Uses
+     * solverIterations sweeps. Needs batchCables. Defaults to false.
+     */
+    bool implicitCables;
+    /** Defaults to dantzigMLCP */
+    Solver solver;
+    /** Defaults to axisSweep */
+    Broadphase broadphase;
+    /**
+     * Iterations of the sequential impulse solver, which the MLCP
+     * solvers also use to warm start and as a fallback. Must be
+     * positive. Bullet's default is 10.
+     */
+    int solverIterations;
+    /**
+     * Solve penetration separately from velocity, so deep contacts
+     * don't add energy. Bullet's default is on.
+     */
+    bool splitImpulse;
+    /** Error reduction parameter for contacts and joints, in (0, 1] */
+    double erp;
+    /**
+     * Islands are gathered until a batch has this many constraints
+     * before each solve. Bullet's default is 128; 1 keeps the MLCP
+     * solvers' matrices small. Must be positive.
+     */
+    int solverBatchSize;
+    /**
+     * Time each step and report the mean step time, with the solver
+     * and broadphase used, when the world is destroyed or reset
+     */
+    bool benchmark;
   };
 
   /** Construct with the default configuration. */
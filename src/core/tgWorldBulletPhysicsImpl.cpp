@@ -28,6 +28,7 @@
 #include "tgWorldBulletPhysicsImpl.h"
 // This application
 #include "tgWorld.h"
+#include "tgBulletSpringCableSolver.h"
 #include "tgCast.h"
 #include "terrain/tgBulletGround.h"
 #include "terrain/tgEmptyGround.h"
@@ -40,6 +41,8 @@
 #include "BulletCollision/CollisionShapes/btBoxShape.h"
 #include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
 #include "BulletCollision/CollisionShapes/btCompoundShape.h"
+#include "BulletCollision/CollisionShapes/btCylinderShape.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 #include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
@@ -55,15 +58,57 @@
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
 
-#define MLCP_SOLVER
-
-#ifdef MLCP_SOLVER
-
+// MLCP solvers
 #include "BulletDynamics/MLCPSolvers/btDantzigSolver.h"
 #include "BulletDynamics/MLCPSolvers/btSolveProjectedGaussSeidel.h"
 #include "BulletDynamics/MLCPSolvers/btMLCPSolver.h"
 
-#endif //MLCP_SOLVER
+// POSIX
+#include <sys/time.h>
+// The C++ Standard Library
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    const char* solverName(tgWorld::Config::Solver solver)
+    {
+        switch (solver)
+        {
+        case tgWorld::Config::sequentialImpulse:
+            return "sequential impulse";
+        case tgWorld::Config::dantzigMLCP:
+            return "Dantzig MLCP";
+        case tgWorld::Config::pgsMLCP:
+            return "PGS MLCP";
+        }
+        return "unknown";
+    }
+
+    const char* broadphaseName(tgWorld::Config::Broadphase broadphase)
+    {
+        switch (broadphase)
+        {
+        case tgWorld::Config::dbvt:
+            return "DBVT";
+        case tgWorld::Config::axisSweep:
+            return "axis sweep";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Bullet calls this at the start of each internal step, so batched
+     * cable forces are recomputed for every substep
+     */
+    void cableSolverTick(btDynamicsWorld* world, btScalar timeStep)
+    {
+        tgBulletSpringCableSolver* const solver =
+            static_cast<tgBulletSpringCableSolver*>(world->getWorldUserInfo());
+        solver->step(timeStep);
+    }
+}
 
 /**
  * Helper class to bundle objects that have the same life cycle, so they can be
@@ -72,55 +117,113 @@
 class IntermediateBuildProducts
 {
     public:
-        IntermediateBuildProducts(double worldSize) : 
-            corner1 (-worldSize,-worldSize, -worldSize),
-            corner2 (worldSize, worldSize, worldSize),
+        IntermediateBuildProducts(const tgWorld::Config& config) : 
+            corner1 (-config.worldSize,-config.worldSize, -config.worldSize),
+            corner2 (config.worldSize, config.worldSize, config.worldSize),
             dispatcher(&collisionConfiguration),
             ghostCallback(),
-#ifndef   MLCP_SOLVER       
-	#if (1) // More acc broadphase - remeber the comma (consider doing ifndef)
-				broadphase(corner1, corner2, 16384)
-	#endif // Broadphase
-#else
-			broadphase(corner1, corner2, 16384),
-			solver(&mlcp)
-#endif //MLCP_SOLVER  
-			
+            broadphase(NULL),
+            mlcp(NULL),
+            solver(NULL)
   {
-	  broadphase.getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+      if (config.solverIterations <= 0)
+      {
+          throw std::invalid_argument("solverIterations is not positive");
+      }
+      else if (config.erp <= 0.0 || config.erp > 1.0)
+      {
+          throw std::invalid_argument("erp is not in (0, 1]");
+      }
+      else if (config.solverBatchSize <= 0)
+      {
+          throw std::invalid_argument("solverBatchSize is not positive");
+      }
+      else if (config.cableSubsteps <= 0)
+      {
+          throw std::invalid_argument("cableSubsteps is not positive");
+      }
+      else if (config.cableSubsteps > 1 && !config.batchCables)
+      {
+          throw std::invalid_argument("cableSubsteps needs batchCables");
+      }
+      else if (config.implicitCables && !config.batchCables)
+      {
+          throw std::invalid_argument("implicitCables needs batchCables");
+      }
+
+      switch (config.broadphase)
+      {
+      case tgWorld::Config::dbvt:
+          broadphase = new btDbvtBroadphase();
+          break;
+      case tgWorld::Config::axisSweep:
+          // More accurate broadphase
+          broadphase = new btAxisSweep3(corner1, corner2, 16384);
+          break;
+      default:
+          throw std::invalid_argument("Unknown broadphase");
+      }
+	  broadphase->getOverlappingPairCache()->setInternalGhostPairCallback(&ghostCallback);
+
+      switch (config.solver)
+      {
+      case tgWorld::Config::sequentialImpulse:
+          solver = new btSequentialImpulseConstraintSolver();
+          break;
+      case tgWorld::Config::dantzigMLCP:
+          mlcp = new btDantzigSolver();
+          solver = new btMLCPSolver(mlcp);
+          break;
+      case tgWorld::Config::pgsMLCP:
+          mlcp = new btSolveProjectedGaussSeidel();
+          solver = new btMLCPSolver(mlcp);
+          break;
+      default:
+          delete broadphase;
+          throw std::invalid_argument("Unknown solver");
+      }
   }
+
+  ~IntermediateBuildProducts()
+  {
+      delete solver;
+      delete mlcp;
+      delete broadphase;
+  }
+
   const btVector3 corner1;
   const btVector3 corner2;
   btSoftBodyRigidBodyCollisionConfiguration collisionConfiguration;
   btCollisionDispatcher dispatcher;
   btGhostPairCallback ghostCallback;
-#if (0) // Default broadphase
-        btDbvtBroadphase broadphase;
-#else
-        // More accurate broadphase:
-        btAxisSweep3 broadphase;
-#endif
-
-#ifdef MLCP_SOLVER
-		btDantzigSolver mlcp;
-        //btSolveProjectedGaussSeidel mlcp;
-		btMLCPSolver solver;
-#else
-		btSequentialImpulseConstraintSolver solver;
-#endif
+  btBroadphaseInterface* broadphase;
+  /** NULL unless an MLCP solver was chosen */
+  btMLCPSolverInterface* mlcp;
+  btConstraintSolver* solver;
 	
 };
 
 tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config,
         tgBulletGround* ground) :
     tgWorldImpl(config, ground),
-    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config.worldSize)),
-    m_pDynamicsWorld(createDynamicsWorld())
+    m_pIntermediateBuildProducts(new IntermediateBuildProducts(config)),
+    m_pDynamicsWorld(createDynamicsWorld()),
+    m_pCableSolver(config.batchCables ?
+                   new tgBulletSpringCableSolver(config.implicitCables,
+                                                 config.solverIterations) :
+                   NULL),
+    m_cableSubsteps(config.cableSubsteps),
+    m_solver(config.solver),
+    m_broadphase(config.broadphase),
+    m_benchmark(config.benchmark),
+    m_benchmarkSteps(0),
+    m_benchmarkSeconds(0.0)
 {
 
     // Gravitational acceleration is down on the Y axis
     const btVector3 gravityVector(0, -config.gravity, 0);
     m_pDynamicsWorld->setGravity(gravityVector);
+    pthread_mutex_init(&m_shapeMutex, NULL);
 	
 	if (!tgCast::cast<tgBulletGround, tgEmptyGround>(ground) && ground != NULL)
 	{
@@ -128,24 +231,24 @@ tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config
 	}
 	
 	/*
-	 * These are lines from the old BasicLearningApp.cpp that we aren't using.
+	 * The defaults in tgWorld::Config are Bullet's own.
 	 * http://bulletphysics.org/mediawiki-1.5.8/index.php/BtContactSolverInfo
 	 */
-    #if (0) 
-		// Split impulse is on by default
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulse = true;
-        m_pDynamicsWorld->getSolverInfo().m_splitImpulsePenetrationThreshold = -0.02;
-        
-        // Default is 10 - increases runtime but decreases odds of penetration
-        // Makes tetraspine sine waves more accurate and static test less accurate
-        m_pDynamicsWorld->getSolverInfo().m_numIterations = 20;
-        
-        // Ground contact params:
-        m_pDynamicsWorld->getSolverInfo().m_erp = 0.8;
-        
-    #endif	
-    
+    btContactSolverInfo& solverInfo = m_pDynamicsWorld->getSolverInfo();
+    // More iterations increase runtime but decrease odds of penetration
+    solverInfo.m_numIterations = config.solverIterations;
+    solverInfo.m_splitImpulse = config.splitImpulse;
+    solverInfo.m_erp = config.erp;
+    solverInfo.m_minimumSolverBatchSize = config.solverBatchSize;
 
+    // Forces from the rest lengths set during the last model step
+    if (m_pCableSolver)
+    {
+        const bool isPreTick = true;
+        m_pDynamicsWorld->setInternalTickCallback(cableSolverTick,
+                                                  m_pCableSolver,
+                                                  isPreTick);
+    }
     
     // Postcondition
     assert(invariant());
@@ -153,6 +256,17 @@ tgWorldBulletPhysicsImpl::tgWorldBulletPhysicsImpl(const tgWorld::Config& config
 
 tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
 {
+    if (m_benchmark && m_benchmarkSteps > 0)
+    {
+        std::cout << "tgWorld benchmark: " << solverName(m_solver) << " solver, "
+                  << broadphaseName(m_broadphase) << " broadphase, "
+                  << m_benchmarkSteps << " steps, "
+                  << getMeanStepTime() * 1.0e6 << " us per step" << std::endl;
+    }
+
+    // Any cables still registered go back to stepping themselves
+    delete m_pCableSolver;
+
     // Delete all the collision objects. The dynamics world must exist.
     // Delete in reverse order of creation.
     const size_t nco = m_pDynamicsWorld->getNumCollisionObjects();
@@ -181,6 +295,7 @@ tgWorldBulletPhysicsImpl::~tgWorldBulletPhysicsImpl()
     const size_t ncs = m_collisionShapes.size();
     
     for (size_t i = 0; i < ncs; ++i) { delete m_collisionShapes[i]; }
+    pthread_mutex_destroy(&m_shapeMutex);
 
     delete m_pDynamicsWorld;
 
@@ -197,12 +312,9 @@ btDynamicsWorld* tgWorldBulletPhysicsImpl::createDynamicsWorld() const
    
   btSoftRigidDynamicsWorld* const result =
     new btSoftRigidDynamicsWorld(&m_pIntermediateBuildProducts->dispatcher,
-                 &m_pIntermediateBuildProducts->broadphase,
-                 &m_pIntermediateBuildProducts->solver, 
+                 m_pIntermediateBuildProducts->broadphase,
+                 m_pIntermediateBuildProducts->solver, 
                  &m_pIntermediateBuildProducts->collisionConfiguration);
-#ifdef MLCPSOLVER	
-		result ->getSolverInfo().m_minimumSolverBatchSize = 1;//for direct solver it is better to have a small A matrix
-#endif	
   return result;
 }
 
@@ -212,30 +324,90 @@ void tgWorldBulletPhysicsImpl::step(double dt)
     assert(dt > 0.0);
 
     const btScalar timeStep = dt;
-    const int maxSubSteps = 1;
-    const btScalar fixedTimeStep = dt;
-    m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    const int maxSubSteps = m_cableSubsteps;
+    btScalar fixedTimeStep = timeStep / maxSubSteps;
+    // Bullet counts substeps by dividing timeStep by fixedTimeStep, and
+    // rounding must not drop one
+    if (static_cast<int>(timeStep / fixedTimeStep) < maxSubSteps)
+    {
+        fixedTimeStep *= btScalar(1.0) - SIMD_EPSILON;
+    }
+    if (m_benchmark)
+    {
+        timeval start;
+        timeval end;
+        gettimeofday(&start, NULL);
+        m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+        gettimeofday(&end, NULL);
+        m_benchmarkSeconds += (end.tv_sec - start.tv_sec) +
+                              (end.tv_usec - start.tv_usec) * 1.0e-6;
+        ++m_benchmarkSteps;
+    }
+    else
+    {
+        m_pDynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep);
+    }
 
     // Postcondition
     assert(invariant());
 }
 
+double tgWorldBulletPhysicsImpl::getMeanStepTime() const
+{
+    return m_benchmarkSteps > 0 ? m_benchmarkSeconds / m_benchmarkSteps : 0.0;
+}
+
+void tgWorldBulletPhysicsImpl::clearContactCache()
+{
+    btBroadphaseInterface* const broadphase = m_pDynamicsWorld->getBroadphase();
+    btDispatcher* const dispatcher = m_pDynamicsWorld->getDispatcher();
+    btCollisionObjectArray& objects = m_pDynamicsWorld->getCollisionObjectArray();
+    for (int i = 0; i < objects.size(); i++)
+    {
+        btBroadphaseProxy* const proxy = objects[i]->getBroadphaseHandle();
+        if (proxy != NULL)
+        {
+            broadphase->getOverlappingPairCache()->cleanProxyFromPairs(proxy,
+                                                                       dispatcher);
+        }
+    }
+    // Bodies may have moved a long way, bring the broadphase up to date
+    m_pDynamicsWorld->updateAabbs();
+    m_pDynamicsWorld->getConstraintSolver()->reset();
+}
+
 void tgWorldBulletPhysicsImpl::addCollisionShape(btCollisionShape* pShape)
 {
+    // Shapes may be created on several threads while a structure is
+    // built. The profiler isn't thread safe either, so it goes inside.
+    pthread_mutex_lock(&m_shapeMutex);
+    {
 #ifndef BT_NO_PROFILE 
-    BT_PROFILE("addCollisionShape");
+        BT_PROFILE("addCollisionShape");
 #endif //BT_NO_PROFILE   	
 	
-    if (pShape)
-    {
-        m_collisionShapes.push_back(pShape);
+        if (pShape)
+        {
+            m_collisionShapes.push_back(pShape);
+        }
     }
+    pthread_mutex_unlock(&m_shapeMutex);
 
       // Postcondition
       assert(invariant());
 }
 
 void tgWorldBulletPhysicsImpl::deleteCollisionShape(btCollisionShape* pShape)
+{
+    pthread_mutex_lock(&m_shapeMutex);
+    releaseCollisionShape(pShape);
+    pthread_mutex_unlock(&m_shapeMutex);
+
+      // Postcondition
+      assert(invariant());
+}
+
+void tgWorldBulletPhysicsImpl::releaseCollisionShape(btCollisionShape* pShape)
 {
 #ifndef BT_NO_PROFILE 
     BT_PROFILE("deleteCollisionShape");
@@ -243,21 +415,124 @@ void tgWorldBulletPhysicsImpl::deleteCollisionShape(btCollisionShape* pShape)
 	
     if (pShape)
     {
+        std::map<btCollisionShape*, std::size_t>::iterator ref =
+            m_sharedShapeRefs.find(pShape);
+        if (ref != m_sharedShapeRefs.end())
+        {
+            // Other rigids may still be using it
+            if (--ref->second > 0)
+            {
+                return;
+            }
+            m_sharedShapeRefs.erase(ref);
+            std::map<ShapeKey, btCollisionShape*>::iterator it =
+                m_sharedShapes.begin();
+            while (it->second != pShape)
+            {
+                ++it;
+            }
+            m_sharedShapes.erase(it);
+        }
+
 		btCompoundShape* cShape = tgCast::cast<btCollisionShape, btCompoundShape>(pShape);
 		if (cShape)
 		{
 			std::size_t n = cShape->getNumChildShapes();
 			for( std::size_t i = 0; i < n; i++)
 			{
-				deleteCollisionShape(cShape->getChildShape(i));
+				releaseCollisionShape(cShape->getChildShape(i));
 			}
 		}
 		m_collisionShapes.remove(pShape);
         delete pShape;
     }
+}
 
-      // Postcondition
-      assert(invariant());
+namespace
+{
+    /**
+     * Shared shapes whose dimensions all agree to within this are the
+     * same shape. Far below anything that changes a contact.
+     */
+    const double shapeKeyResolution = 1.0e-9;
+
+    long long snapToKey(double value)
+    {
+        return static_cast<long long>(std::floor(value / shapeKeyResolution + 0.5));
+    }
+
+    btCollisionShape* newCylinderShape(const btVector3& halfExtents)
+    {
+        return new btCylinderShape(halfExtents);
+    }
+
+    btCollisionShape* newBoxShape(const btVector3& halfExtents)
+    {
+        return new btBoxShape(halfExtents);
+    }
+
+    btCollisionShape* newSphereShape(const btVector3& radius)
+    {
+        return new btSphereShape(radius.x());
+    }
+}
+
+bool tgWorldBulletPhysicsImpl::ShapeKey::operator<(const ShapeKey& other) const
+{
+    if (shapeType != other.shapeType)
+    {
+        return shapeType < other.shapeType;
+    }
+    else if (x != other.x)
+    {
+        return x < other.x;
+    }
+    else if (y != other.y)
+    {
+        return y < other.y;
+    }
+    return z < other.z;
+}
+
+btCollisionShape* tgWorldBulletPhysicsImpl::getCylinderShape(const btVector3& halfExtents)
+{
+    return getSharedShape(CYLINDER_SHAPE_PROXYTYPE, newCylinderShape, halfExtents);
+}
+
+btCollisionShape* tgWorldBulletPhysicsImpl::getBoxShape(const btVector3& halfExtents)
+{
+    return getSharedShape(BOX_SHAPE_PROXYTYPE, newBoxShape, halfExtents);
+}
+
+btCollisionShape* tgWorldBulletPhysicsImpl::getSphereShape(double radius)
+{
+    return getSharedShape(SPHERE_SHAPE_PROXYTYPE, newSphereShape,
+                          btVector3(radius, 0.0, 0.0));
+}
+
+btCollisionShape* tgWorldBulletPhysicsImpl::getSharedShape(int shapeType,
+        btCollisionShape* (*create)(const btVector3&),
+        const btVector3& dims)
+{
+    ShapeKey key;
+    key.shapeType = shapeType;
+    key.x = snapToKey(dims.x());
+    key.y = snapToKey(dims.y());
+    key.z = snapToKey(dims.z());
+
+    pthread_mutex_lock(&m_shapeMutex);
+    btCollisionShape*& pShape = m_sharedShapes[key];
+    if (pShape == NULL)
+    {
+        // The first rigid's exact dimensions define the shape
+        pShape = create(dims);
+        m_collisionShapes.push_back(pShape);
+    }
+    ++m_sharedShapeRefs[pShape];
+    btCollisionShape* const result = pShape;
+    pthread_mutex_unlock(&m_shapeMutex);
+
+    return result;
 }
 
 bool tgWorldBulletPhysicsImpl::invariant() const
@@ -31,12 +31,18 @@
 #include "tgWorld.h"
 #include "tgWorldImpl.h"
 #include "LinearMath/btAlignedObjectArray.h"
+// POSIX
+#include <pthread.h>
+// The C++ Standard Library
+#include <cstddef>
+#include <map>
 
 
 
 // Forward declarations
 class btCollisionShape;
 class btTypedConstraint;
+class btVector3;
 class btDynamicsWorld;
 class btRigidBody;
 class IntermediateBuildProducts;
@@ -44,6 +50,7 @@ class btBroadphaseInterface;
 class btDispatcher;
 class tgBulletGround;
 class tgHillyGround;
+class tgBulletSpringCableSolver;
 
 /**
  * Concrete class derived from tgWorldImpl for Bullet Physics
@@ -84,16 +91,31 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
   
 	/**
 	 * Add a btCollisionShape the a collection for deletion upon
-	 * destruction.
+	 * destruction. May be called from several threads at once.
 	 * @param[in] pShape a pointer to a btCollisionShape; do nothing if NULL
 	 */
 	void addCollisionShape(btCollisionShape* pShape);
 	
 	/**
-	 * Immediately delete a collision shape to avoid leaking memory during a rial
+	 * Immediately delete a collision shape to avoid leaking memory during a trial.
+	 * Shared shapes are only deleted when their last user releases them.
 	 * @param[in] pShape a pointer to a btCollisionShape; do nothing if NULL
 	 */
 	void deleteCollisionShape(btCollisionShape* pShape);
+
+	/**
+	 * Return the world's cylinder with these half extents, creating and
+	 * registering it on first use. Each call takes a reference, which
+	 * deleteCollisionShape gives back. May be called from several threads.
+	 * @param[in] halfExtents as for btCylinderShape
+	 */
+	btCollisionShape* getCylinderShape(const btVector3& halfExtents);
+
+	/** As getCylinderShape, for btBoxShape */
+	btCollisionShape* getBoxShape(const btVector3& halfExtents);
+
+	/** As getCylinderShape, for btSphereShape */
+	btCollisionShape* getSphereShape(double radius);
 	
         /**
      * Add a btTypedConstraint to a collection for deletion upon
@@ -101,6 +123,28 @@ class tgWorldBulletPhysicsImpl : public tgWorldImpl
      * @param[in] pConstraint a pointer to a btTypedConstraint; do nothing if NULL
      */
         void addConstraint(btTypedConstraint* pConstaint);
+
+    /**
+     * Return the solver that batches cable forces for this world.
+     * @return NULL unless tgWorld::Config::batchCables is set
+     */
+    tgBulletSpringCableSolver* cableSolver() const
+    {
+        return m_pCableSolver;
+    }
+
+    /**
+     * Drop cached contact manifolds and solver state, i.e. after bodies
+     * were moved by tgSimulation::restore. Contacts are found again on
+     * the next step.
+     */
+    void clearContactCache();
+
+    /**
+     * Mean wall clock time of stepSimulation, in seconds.
+     * @return 0 unless tgWorld::Config::benchmark is set
+     */
+    double getMeanStepTime() const;
 private:
 
     /**
@@ -127,6 +171,28 @@ private:
 
  private:
     
+    /**
+     * Geometry of a shared shape, snapped to shapeKeyResolution so
+     * rounding in rod lengths doesn't split otherwise equal rods
+     */
+    struct ShapeKey
+    {
+        int shapeType;
+        long long x;
+        long long y;
+        long long z;
+
+        bool operator<(const ShapeKey& other) const;
+    };
+
+    /** Find or create the shared shape, and take a reference to it */
+    btCollisionShape* getSharedShape(int shapeType,
+            btCollisionShape* (*create)(const btVector3&),
+            const btVector3& dims);
+
+    /** deleteCollisionShape without the lock, for compound children */
+    void releaseCollisionShape(btCollisionShape* pShape);
+
     /** Used to build the btSoftRigidDynamicsWorld. */
     IntermediateBuildProducts * const m_pIntermediateBuildProducts;
     
@@ -144,12 +210,39 @@ private:
      */
     btAlignedObjectArray<btCollisionShape*> m_collisionShapes;
 
+    /** Shapes handed out by getCylinderShape and friends */
+    std::map<ShapeKey, btCollisionShape*> m_sharedShapes;
+
+    /** Outstanding references to each shared shape */
+    std::map<btCollisionShape*, std::size_t> m_sharedShapeRefs;
+
+    /**
+     * Serializes the shape collections, which tgStructureInfo fills
+     * from build threads
+     */
+    pthread_mutex_t m_shapeMutex;
+
     /* 
      * A vector of constraints for easy reference. Does not affect
      * physics or rendering unles the constraint is placed into the dynamics
      * world.
      */
     btAlignedObjectArray<btTypedConstraint*> m_constraints;
+
+    /** Applies cable forces before each internal step, if batching is on */
+    tgBulletSpringCableSolver* m_pCableSolver;
+
+    /** Internal Bullet steps per call to step() */
+    const int m_cableSubsteps;
+
+    /** What was chosen, for the benchmark report */
+    const tgWorld::Config::Solver m_solver;
+    const tgWorld::Config::Broadphase m_broadphase;
+
+    /** If set, step() times stepSimulation */
+    const bool m_benchmark;
+    std::size_t m_benchmarkSteps;
+    double m_benchmarkSeconds;
 };
 
 #endif  // TG_WORLDBULLETPHYSICSIMPL_H
@@ -876,6 +876,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
 			{
 				tmpAct.push_back(output[j]);
 			}
+			delete[] output;
 			actions.push_back(tmpAct);
 
 			std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -902,6 +903,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
 		{
 			tmpAct.push_back(output[j]);
 		}
+		delete[] output;
 		actions.push_back(tmpAct);
 
 		std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -909,6 +911,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
 		feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
 	}
 
+    delete[] inputs;
     return feedback;
 }
 
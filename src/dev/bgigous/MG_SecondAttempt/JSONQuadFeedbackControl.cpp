@@ -446,6 +446,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -454,6 +455,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppCordeHangingTest.cpp
+ * @brief Hangs a rod from a Corde string anchored in a tgWorld
+ * $Id$
+ */
+
+// This application
+#include "CordeHangingModel.h"
+#include "CordeModel.h"
+// This library
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The Bullet Physics Library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cmath>
+#include <iostream>
+
+/**
+ * Hangs a 1 kg rod from a 1 m string and steps it at the world's usual
+ * timestep for two seconds. Unsupported, the rod would fall almost
+ * 20 m; on the string it should settle a few millimeters below where
+ * it started.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[0] is the executable name
+ * @return 0 if the rod stays within 5 cm of where it started
+ */
+int main(int argc, char** argv)
+{
+	std::cout << "AppCordeHangingTest" << std::endl;
+	
+	// Spillman's rope, with a stretch modulus that makes the string
+	// about 3 kN/m overall
+	const std::size_t resolution = 10;
+	const double radius = 0.01;
+	const double density = 1300;
+	const double youngMod = 0.5;
+	const double shearMod = 0.5;
+	const double stretchMod = 1.0e7;
+	const double springConst = 100.0 * pow(10, 3);
+	const double gammaT = 10.0 * pow(10, -6);
+	const double gammaR = 1.0 * pow(10, -6);
+	const CordeModel::Config config(resolution, radius, density, youngMod,
+								shearMod, stretchMod, springConst,
+								gammaT, gammaR);
+	
+	const double dt = 0.001;
+	const int steps = 2000;
+	const double tolerance = 0.05;
+	
+	tgWorld::Config worldConfig(9.81);
+	tgWorld world(worldConfig);
+	tgSimView view(world, dt);
+	tgSimulation simulation(view);
+	
+	CordeHangingModel* const myModel = new CordeHangingModel(config);
+	simulation.addModel(myModel);
+	
+	const btVector3 start = myModel->getHangingRod()->centerOfMass();
+	std::cout << "Substeps per step: "
+			  << myModel->getString()->getNumSubsteps(dt) << std::endl;
+	
+	double drift = 0.0;
+	for (int i = 0; i < steps; i++)
+	{
+		simulation.step(dt);
+		const double d =
+			myModel->getHangingRod()->centerOfMass().distance(start);
+		// Also catches NaN
+		if (!(d < tolerance))
+		{
+			drift = d;
+			break;
+		}
+		drift = d > drift ? d : drift;
+	}
+	
+	const CordeModel* const string = myModel->getString();
+	for (std::size_t i = 0; i < string->getNumMassPoints(); i++)
+	{
+		std::cout << "Position " << i << " " << string->getPosition(i)
+				  << std::endl;
+	}
+	std::cout << "Largest rod offset: " << drift << std::endl;
+	
+	return drift < tolerance ? 0 : 1;
+}
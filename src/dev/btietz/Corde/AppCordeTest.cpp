@@ -77,13 +77,21 @@ int main(int argc, char** argv)
 	
 	CordeModel testString(startPos, endPos, startRot, endRot, config);
 	
+	// The world's usual timestep, the model substeps as needed
 	double t = 0.0;
-	double dt = 0.0001;
-	for (int i = 0; i < 10000; i++)
+	double dt = 0.001;
+	std::cout << "Substeps per step: " << testString.getNumSubsteps(dt) << std::endl;
+	for (int i = 0; i < 1000; i++)
 	{
 		testString.step(dt);
 		t += dt;
 	}
+	
+	for (std::size_t i = 0; i < testString.getNumMassPoints(); i++)
+	{
+		std::cout << "Position " << i << " " << testString.getPosition(i) << std::endl;
+	}
+	
 	#ifdef BT_USE_DOUBLE_PRECISION
 		std::cout << "Double precision" << std::endl;
 	#else
@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file CordeHangingModel.cpp
+ * @brief Contains the implementation of class CordeHangingModel
+ * $Id$
+ */
+
+// This module
+#include "CordeHangingModel.h"
+// This library
+#include "core/tgBulletSpringCableAnchor.h"
+#include "core/tgRod.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+// The Bullet Physics library
+#include "LinearMath/btQuaternion.h"
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <stdexcept>
+
+namespace
+{
+	const double radius = 0.05;
+	// 1 kg over the rod's volume of pi * 0.05^2 * 1 m^3
+	const double density = 127.32395;
+	
+	// The string hangs from the fixed rod's bottom to the hanging rod's top
+	const btVector3 topAnchor(0.0, 3.0, 0.0);
+	const btVector3 bottomAnchor(0.0, 2.0, 0.0);
+}
+
+CordeHangingModel::CordeHangingModel(const CordeModel::Config& config) :
+tgModel(),
+m_config(config),
+m_pString(NULL),
+m_pHangingRod(NULL)
+{
+}
+
+CordeHangingModel::~CordeHangingModel()
+{
+	delete m_pString;
+}
+
+void CordeHangingModel::setup(tgWorld& world)
+{
+	const tgRod::Config fixedConfig(radius, 0.0);
+	const tgRod::Config hangingConfig(radius, density);
+	
+	tgStructure s;
+	s.addPair(btVector3(0.0, 4.0, 0.0), topAnchor, "fixed");
+	s.addPair(bottomAnchor, btVector3(0.0, 1.0, 0.0), "hanging");
+	
+	tgBuildSpec spec;
+	spec.addBuilder("fixed", new tgRodInfo(fixedConfig));
+	spec.addBuilder("hanging", new tgRodInfo(hangingConfig));
+	
+	tgStructureInfo structureInfo(s, spec);
+	structureInfo.buildInto(*this, world);
+	
+	const std::vector<tgRod*> fixed = find<tgRod>("fixed");
+	const std::vector<tgRod*> hanging = find<tgRod>("hanging");
+	if (fixed.size() != 1 || hanging.size() != 1)
+	{
+		throw std::runtime_error("CordeHangingModel did not build its rods.");
+	}
+	m_pHangingRod = hanging[0];
+	
+	// The string owns the anchors, the world owns the bodies
+	tgBulletSpringCableAnchor* const anchor1 =
+		new tgBulletSpringCableAnchor(fixed[0]->getPRigidBody(), topAnchor);
+	tgBulletSpringCableAnchor* const anchor2 =
+		new tgBulletSpringCableAnchor(m_pHangingRod->getPRigidBody(),
+										bottomAnchor);
+	
+	// Neither bending nor torsion along the string
+	const btQuaternion rotation =
+		shortestArcQuat(btVector3(0.0, 0.0, 1.0),
+						(bottomAnchor - topAnchor).normalized());
+	
+	delete m_pString;
+	m_pString = new CordeModel(anchor1, anchor2, rotation, rotation, m_config);
+	
+	tgModel::setup(world);
+}
+
+void CordeHangingModel::step(double dt)
+{
+	if (dt <= 0.0)
+	{
+		throw std::invalid_argument("dt is not positive");
+	}
+	else
+	{
+		if (m_pString)
+		{
+			m_pString->step(dt);
+		}
+		tgModel::step(dt);
+	}
+}
+
+void CordeHangingModel::teardown()
+{
+	delete m_pString;
+	m_pString = NULL;
+	m_pHangingRod = NULL;
+	tgModel::teardown();
+}
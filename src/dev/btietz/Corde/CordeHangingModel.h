@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef CORDE_HANGING_MODEL_H
+#define CORDE_HANGING_MODEL_H
+
+/**
+ * @file CordeHangingModel.h
+ * @brief A rod hanging from a fixed rod by a Corde string
+ * $Id$
+ */
+
+// This application
+#include "CordeModel.h"
+// This library
+#include "core/tgModel.h"
+// The C++ Standard Library
+#include <vector>
+
+// Forward declarations
+class tgRod;
+class tgWorld;
+
+/**
+ * Couples a CordeModel to the rigid bodies of a tgWorld. A static rod
+ * runs from y = 4 to y = 3 and a rod of about 1 kg from y = 2 to y = 1.
+ * The string is anchored to the facing ends of the two rods and is
+ * stepped after the world, so the impulses it applies to the hanging
+ * rod act in the next world step. Lengths are in meters, so use a
+ * gravity of 9.81.
+ */
+class CordeHangingModel : public tgModel
+{
+public:
+	
+	/**
+	 * @param[in] config the string's parameters, its length is set
+	 * by the gap between the rods
+	 */
+	CordeHangingModel(const CordeModel::Config& config);
+	
+	virtual ~CordeHangingModel();
+	
+	/**
+	 * Build the rods, then anchor a new string to them
+	 */
+	virtual void setup(tgWorld& world);
+	
+	/**
+	 * Step the string, then the rods
+	 */
+	virtual void step(double dt);
+	
+	/**
+	 * Delete the string, then tear down the rods
+	 */
+	virtual void teardown();
+	
+	/** NULL before setup */
+	const CordeModel* getString() const
+	{
+		return m_pString;
+	}
+	
+	/** NULL before setup */
+	const tgRod* getHangingRod() const
+	{
+		return m_pHangingRod;
+	}
+	
+private:
+	
+	CordeModel::Config m_config;
+	
+	CordeModel* m_pString;
+	
+	tgRod* m_pHangingRod;
+};
+
+#endif // CORDE_HANGING_MODEL_H
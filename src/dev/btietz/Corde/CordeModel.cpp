@@ -27,9 +27,16 @@
 #include "CordeModel.h"
 
 // This library
-#include "tgcreator/tgUtil.h"
+#include "core/tgBulletSpringCableAnchor.h"
+
+// The Bullet Physics library
+#include "BulletDynamics/Dynamics/btRigidBody.h"
 
 // The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
 
 CordeModel::Config::Config(const std::size_t res,
@@ -82,59 +89,110 @@ CordeModel::Config::Config(const std::size_t res,
 }
 
 CordeModel::CordeModel(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2, CordeModel::Config& Config) : 
-m_config(Config),
-    simTime(0.0)
+    m_config(Config),
+    m_anchor1(NULL),
+    m_anchor2(NULL),
+    m_anchorImpulse1(0.0, 0.0, 0.0),
+    m_anchorImpulse2(0.0, 0.0, 0.0)
 {
-	computeConstants();
+    constructorAux(pos1, pos2, quat1, quat2);
+}
+
+CordeModel::CordeModel(tgBulletSpringCableAnchor* anchor1,
+                        tgBulletSpringCableAnchor* anchor2,
+                        btQuaternion quat1, btQuaternion quat2,
+                        CordeModel::Config& Config) :
+    m_config(Config),
+    m_anchor1(anchor1),
+    m_anchor2(anchor2),
+    m_anchorImpulse1(0.0, 0.0, 0.0),
+    m_anchorImpulse2(0.0, 0.0, 0.0)
+{
+    if (anchor1 == NULL && anchor2 == NULL)
+    {
+        throw std::invalid_argument("Corde string needs at least one anchor.");
+    }
+    /// @todo allow one free end by taking its position as an argument
+    else if (anchor1 == NULL || anchor2 == NULL)
+    {
+        throw std::invalid_argument("Corde string anchor is NULL.");
+    }
     
-    btVector3 rodLength(pos2 - pos1);
-    btVector3 unitLength( rodLength / ((double) m_config.resolution - 1) );
-    btVector3 massPos(pos1);
+    constructorAux(anchor1->getWorldPosition(), anchor2->getWorldPosition(),
+                    quat1, quat2);
+}
+
+void CordeModel::constructorAux(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2)
+{
+    if (m_config.resolution < 3)
+    {
+        throw std::invalid_argument("Corde string needs at least 3 mass points.");
+    }
+    
+	computeConstants();
     
-    double unitMass =  m_config.density * M_PI * pow( m_config.radius, 2) * unitLength.length();
+    const std::size_t n = m_config.resolution;
     
-    CordePositionElement* currentPoint = new CordePositionElement(massPos, unitMass);
+    btVector3 rodLength(pos2 - pos1);
+    btVector3 unitLength( rodLength / ((double) n - 1) );
     
-    m_massPoints.push_back(currentPoint);
+    m_unitMass =  m_config.density * M_PI * m_config.radius * m_config.radius * unitLength.length();
     
-    std::cout << massPos << std::endl;
     // Setup mass elements
-    for (std::size_t i = 1; i < m_config.resolution; i++)
+    m_positions.resize(n);
+    m_velocities.resize(n, btVector3(0.0, 0.0, 0.0));
+    m_forces.resize(n, btVector3(0.0, 0.0, 0.0));
+    m_inverseMasses.assign(n, 1.0 / m_unitMass);
+    
+    btVector3 massPos(pos1);
+    for (std::size_t i = 0; i < n; i++)
     {
-                
+        m_positions[i] = massPos;
         massPos += unitLength;
-        currentPoint = new CordePositionElement(massPos, unitMass);
-        m_massPoints.push_back(currentPoint);
-        // Introduce stretch
-        linkLengths.push_back(unitLength.length() * 1.0);
-        std::cout << massPos << " " << unitMass << std::endl;
     }
+    // Introduce stretch
+    linkLengths.assign(n - 1, unitLength.length() * 1.0);
     
-    CordeQuaternionElement* currentAngle = new CordeQuaternionElement(quat1);
-    m_centerlines.push_back(currentAngle);
+    // Anchored points are moved by their bodies
+    if (m_anchor1)
+    {
+        m_inverseMasses[0] = 0.0;
+    }
+    if (m_anchor2)
+    {
+        m_inverseMasses[n - 1] = 0.0;
+    }
     
-    std::size_t n = m_config.resolution - 1;
-    for (std::size_t i = 1; i < n; i++)
+    // Setup quaternion elements, one per link
+    const std::size_t nq = n - 1;
+    m_quaternions.resize(nq);
+    m_qdots.resize(nq, btQuaternion(0.0, 0.0, 0.0, 0.0));
+    m_tprimes.resize(nq, btQuaternion(0.0, 0.0, 0.0, 0.0));
+    m_torques.resize(nq, btVector3(0.0, 0.0, 0.0));
+    m_omegas.resize(nq, btVector3(0.0, 0.0, 0.0));
+    
+    m_quaternions[0] = quat1.normalized();
+    for (std::size_t i = 1; i < nq; i++)
     {
-        currentAngle = new CordeQuaternionElement(quat1.slerp(quat2, (double) i / (double) n) );
-        m_centerlines.push_back(currentAngle);
-        std::cout << currentAngle->q << std::endl;
-        quaternionShapes.push_back(unitLength.length());
+        m_quaternions[i] = quat1.slerp(quat2, (double) i / (double) nq).normalized();
     }
+    quaternionShapes.assign(nq - 1, unitLength.length());
+    
+    m_linkForces0.resize(n - 1, btVector3(0.0, 0.0, 0.0));
+    m_linkForces1.resize(n - 1, btVector3(0.0, 0.0, 0.0));
+    m_bendTprimes0.resize(nq - 1, btQuaternion(0.0, 0.0, 0.0, 0.0));
+    m_bendTprimes1.resize(nq - 1, btQuaternion(0.0, 0.0, 0.0, 0.0));
+    
+    computeStableTimestep();
     
     assert(invariant());
 }
 
 CordeModel::~CordeModel()
 {
-	for (std::size_t i = 0; i < m_massPoints.size(); i++)
-    {
-        delete m_massPoints[i];
-    }
-    for (std::size_t i = 0; i < m_centerlines.size(); i++)
-    {
-        delete m_centerlines[i];
-    }
+    // The world owns the bodies, we own the anchors
+    delete m_anchor1;
+    delete m_anchor2;
 }
 
 void CordeModel::step (btScalar dt)
@@ -144,31 +202,39 @@ void CordeModel::step (btScalar dt)
         throw std::invalid_argument("Timestep is not positive.");
     }
     
-    stepPrerequisites();
-	computeInternalForces();
-    unconstrainedMotion(dt);
-    simTime += dt;
-    if (simTime >= .01)
+    const std::size_t substeps = getNumSubsteps(dt);
+    const double h = dt / (double) substeps;
+    const std::size_t last = m_positions.size() - 1;
+    
+    m_anchorImpulse1.setZero();
+    m_anchorImpulse2.setZero();
+    
+    // Bodies don't move until the world steps, anchored points continue
+    // along their velocity during the substeps
+    updateAnchors();
+    
+    for (std::size_t k = 0; k < substeps; k++)
     {
-        size_t n = m_massPoints.size();
-        for (std::size_t i = 0; i < n; i++)
-        {
-            std::cout << "Position " << i << " " << m_massPoints[i]->pos << std::endl
-                      << "Force " << i << " " << m_massPoints[i]->force << std::endl;
-            if (i < n - 1)
-            {
-            std::cout << "Quaternion " << i << " " << m_centerlines[i]->q << std::endl
-                      << "Qdot " << i << " " << m_centerlines[i]->qdot << std::endl
-                      << "Force " << i << " " << m_centerlines[i]->tprime << std::endl
-                      << "Torque " << i << " " << m_centerlines[i]->torques << std::endl;
-            }       
-        }
-        simTime = 0.0;
+        computeInternalForces();
+        
+        // What the string does to its end points it does to the bodies
+        m_anchorImpulse1 += m_forces[0] * h;
+        m_anchorImpulse2 += m_forces[last] * h;
+        
+        unconstrainedMotion(h);
     }
     
+    applyAnchorImpulses();
+    
     assert(invariant());
 }
 
+std::size_t CordeModel::getNumSubsteps(double dt) const
+{
+    const double substeps = std::ceil(dt / m_stableTimestep - 1.0e-9);
+    return substeps > 1.0 ? (std::size_t) substeps : 1;
+}
+
 void CordeModel::computeConstants()
 {
     assert(computedStiffness.empty());
@@ -198,382 +264,315 @@ void CordeModel::computeConstants()
 }
 
 /**
- * @todo consider making a reset function for the elements
+ * Semi-implicit Euler on a chain of springs is stable while
+ * dt < 2 / omega, and the fastest mode of a chain has
+ * omega^2 = 4 k / m. Damping needs dt < m / (2 c). The stiffnesses
+ * are linearized about the rest state and the result is halved, since
+ * the alignment and bending terms stiffen as the string deforms.
  */
-void CordeModel::stepPrerequisites()
+void CordeModel::computeStableTimestep()
 {
-    std::size_t n = m_massPoints.size();
-	for (std::size_t i = 0; i < n - 1; i++)
+    const double safety = 0.5;
+    double stable = std::numeric_limits<double>::max();
+    
+    // Mass points: stretch and quaternion alignment springs
+    for (std::size_t i = 0; i < linkLengths.size(); i++)
     {
-        CordePositionElement* r_0 = m_massPoints[i];
-        r_0->force.setZero();
+        const double k = computedStiffness[0] / linkLengths[i] +
+                            m_config.ConsSpringConst;
+        const double c = m_config.gammaT / linkLengths[i];
+        if (k > 0.0)
+        {
+            stable = std::min(stable, std::sqrt(m_unitMass / k));
+        }
+        if (c > 0.0)
+        {
+            stable = std::min(stable, m_unitMass / (2.0 * c));
+        }
     }
     
-    n = m_centerlines.size();
-	for (std::size_t i = 0; i < n - 1; i++)
+    // Quaternions: alignment with their link plus bending and torsion
+    // against both neighbours
+    const double minInertia = computedInertia[computedInertia.minAxis()];
+    const double maxBending = std::max(computedStiffness[1],
+                            std::max(computedStiffness[2], computedStiffness[3]));
+    const std::size_t nq = m_quaternions.size();
+    for (std::size_t i = 0; i < nq; i++)
     {
-        CordeQuaternionElement* q_0 = m_centerlines[i];
-        q_0->tprime = btQuaternion(0.0, 0.0, 0.0, 0.0);
-        q_0->torques.setZero();
+        double k = 2.0 * m_config.ConsSpringConst * linkLengths[i];
+        double c = 0.0;
+        for (std::size_t j = (i > 0 ? i - 1 : 0); j < i + 1 && j < quaternionShapes.size(); j++)
+        {
+            const double l = quaternionShapes[j];
+            k += 2.0 * 4.0 / l * maxBending;
+            c += 2.0 * 4.0 * m_config.gammaR / l;
+        }
+        if (k > 0.0)
+        {
+            stable = std::min(stable, std::sqrt(minInertia / k));
+        }
+        if (c > 0.0)
+        {
+            stable = std::min(stable, minInertia / (2.0 * c));
+        }
     }
+    
+    m_stableTimestep = safety * stable;
 }
 
+void CordeModel::updateAnchors()
+{
+    const std::size_t last = m_positions.size() - 1;
+    if (m_anchor1)
+    {
+        m_positions[0] = m_anchor1->getWorldPosition();
+        m_velocities[0] = m_anchor1->attachedBody->getVelocityInLocalPoint(
+                                        m_anchor1->getRelativePosition());
+    }
+    if (m_anchor2)
+    {
+        m_positions[last] = m_anchor2->getWorldPosition();
+        m_velocities[last] = m_anchor2->attachedBody->getVelocityInLocalPoint(
+                                        m_anchor2->getRelativePosition());
+    }
+}
+
+void CordeModel::applyAnchorImpulses()
+{
+    if (m_anchor1)
+    {
+        m_anchor1->attachedBody->activate();
+        m_anchor1->attachedBody->applyImpulse(m_anchorImpulse1,
+                                        m_anchor1->getRelativePosition());
+    }
+    if (m_anchor2)
+    {
+        m_anchor2->attachedBody->activate();
+        m_anchor2->attachedBody->applyImpulse(m_anchorImpulse2,
+                                        m_anchor2->getRelativePosition());
+    }
+}
+
+/**
+ * Each element loop writes only its own entries, the contributions to
+ * shared mass points and quaternions are summed in a separate pass
+ */
 void CordeModel::computeInternalForces()
 {
-    std::size_t n = m_massPoints.size() - 1;
+    computeLinkForces();
+    computeBendingTorques();
+    
+    const std::size_t n = m_positions.size();
+    m_forces[0] = m_linkForces0[0];
+    for (std::size_t i = 1; i < n - 1; i++)
+    {
+        m_forces[i] = m_linkForces0[i] + m_linkForces1[i - 1];
+    }
+    m_forces[n - 1] = m_linkForces1[n - 2];
+    
+    const std::size_t nq = m_quaternions.size();
+    m_tprimes[0] += m_bendTprimes0[0];
+    for (std::size_t i = 1; i < nq - 1; i++)
+    {
+        m_tprimes[i] += m_bendTprimes0[i] + m_bendTprimes1[i - 1];
+    }
+    m_tprimes[nq - 1] += m_bendTprimes1[nq - 2];
+}
+
+/**
+ * Forces are the negative gradients of the stretch energy
+ * (k0 / 2L) (|e| - L)^2 and the alignment energy K L (1 - d3 . e / |e|),
+ * where e runs from point i to point i + 1 and d3 is the director of
+ * quaternion i. The alignment energy also gives the generalized force
+ * on the quaternion.
+ */
+void CordeModel::computeLinkForces()
+{
+    const std::size_t n = linkLengths.size();
+    const btScalar k0 = computedStiffness[0];
+    const btScalar ksc = m_config.ConsSpringConst;
+    const btScalar gammaT = m_config.gammaT;
     
-    // Update position elements
 	for (std::size_t i = 0; i < n; i++)
     {
-        CordePositionElement* r_0 = m_massPoints[i];
-        CordePositionElement* r_1 = m_massPoints[i + 1];
-        
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        
-        // Get position elements in standard variable names
-        const btScalar x1 = r_0->pos[0];
-        const btScalar y1 = r_0->pos[1];
-        const btScalar z1 = r_0->pos[2];
-        
-        const btScalar x2 = r_1->pos[0];
-        const btScalar y2 = r_1->pos[1];
-        const btScalar z2 = r_1->pos[2];
+        const btScalar L = linkLengths[i];
+        const btQuaternion& q = m_quaternions[i];
         
         // Same for quaternion elements
-        const btScalar q11 = quat_0->q[0];
-        const btScalar q12 = quat_0->q[1];
-        const btScalar q13 = quat_0->q[2];
-        const btScalar q14 = quat_0->q[3];
+        const btScalar q11 = q[0];
+        const btScalar q12 = q[1];
+        const btScalar q13 = q[2];
+        const btScalar q14 = q[3];
         
         // Setup common factors
-        const btVector3 posDiff = r_0->pos - r_1->pos;
-        const btVector3 velDiff = r_0->vel - r_1->vel;
-        const btScalar posNorm   = posDiff.length();
+        const btVector3 posDiff = m_positions[i] - m_positions[i + 1];
+        const btVector3 velDiff = m_velocities[i] - m_velocities[i + 1];
         const btScalar posNorm_2 = posDiff.length2();
+        const btScalar posNorm   = btSqrt(posNorm_2);
+        const btScalar dx = posDiff[0];
+        const btScalar dy = posDiff[1];
+        const btScalar dz = posDiff[2];
         const btVector3 director( (2.0 * (q11 * q13 + q12 * q14)),
                         (2.0 * (q12 * q13 - q11 * q14)),
            ( -1.0 * q11 * q11 - q12 * q12 + q13 * q13 + q14 * q14));
         
-        // Sum Forces, have to split it out into components due to
-        // derivatives of energy quantaties
-
-        // Spring common
-        const btScalar spring_common = computedStiffness[0] * 
-            (linkLengths[i] - posNorm) / (linkLengths[i] * posNorm);
-        
-        const btScalar diss_common = m_config.gammaT *
-                        posNorm_2 * posDiff.dot(velDiff) / pow (linkLengths[i] , 5);
-        
-        /* Quaternion Constraint X */
-        const btScalar quat_cons_x = m_config.ConsSpringConst * linkLengths[i] *
-        ( director[2] * (x1 - x2) * (z1 - z2) - director[0] * ( pow( posDiff[1], 2) + pow( posDiff[2], 2) )
-        + director[1] * (x1 - x2) * (y1 - y2) ) / ( pow (posNorm, 3) );
-        
-        /* Quaternion Constraint Y */
-        const btScalar quat_cons_y = m_config.ConsSpringConst * linkLengths[i] *
-        ( -1.0 * director[2] * (y1 - y2) * (z1 - z2) + director[1] * ( pow( posDiff[0], 2) + pow( posDiff[2], 2) )
-        - director[0] * (x1 - x2) * (z1 - z2) ) / ( pow (posNorm, 3) );
+        // Spring common, negative when stretched
+        const btScalar spring_common = k0 * 
+            (L - posNorm) / (L * posNorm);
         
-        /* Quaternion Constraint Z */
-        const btScalar quat_cons_z = m_config.ConsSpringConst * linkLengths[i] *
-        ( -1.0 * director[0] * (y1 - y2) * (z1 - z2) + director[2] * ( pow( posDiff[0], 2) + pow( posDiff[1], 2) )
-        - director[1] * (x1 - x2) * (z1 - z2) ) / ( pow (posNorm, 3) );
+        const btScalar L_2 = L * L;
+        const btScalar diss_common = gammaT *
+                        posNorm_2 * posDiff.dot(velDiff) / (L_2 * L_2 * L);
         
-        r_0->force[0] += -1.0 * (x1 - x2) * (spring_common + diss_common);
+        /* Quaternion constraint, pulls the link towards the director */
+        const btVector3 quatCons = ksc * L / (posNorm_2 * posNorm) *
+            (director * posNorm_2 - posDiff * posDiff.dot(director));
         
-        r_1->force[0] += (x1 - x2) * (spring_common + diss_common);
+        const btVector3 spring = posDiff * (spring_common - diss_common);
         
-        /* Apply Y forces */
-        r_0->force[1] += -1.0 * (y1 - y2) * (spring_common + diss_common);
-        
-        r_1->force[1] += (y1 - y2) * (spring_common + diss_common);
-        
-        /* Apply Z Forces */
-        r_0->force[2] += -1.0 * (z1 - z2) * (spring_common + diss_common);
-        
-        r_1->force[2] += (z1 - z2) * (spring_common + diss_common);
-
-        /* Apply constraint equation with boundry conditions */
-        if (i == 0)
-        {
-           r_1->force[0] += quat_cons_x;
-            
-            
-           r_1->force[1] += quat_cons_y;
-            
-            
-           r_1->force[2] += quat_cons_z; 
-        }
-        else if (i == n - 1)
-        {
-            r_0->force[0] -= quat_cons_x;
-
-            r_0->force[1] -= quat_cons_y;
-            
-            r_0->force[2] -= quat_cons_z;       
-        }
-        else
-        {
-            r_0->force[0] -= quat_cons_x;
-            r_1->force[0] += quat_cons_x;
-            
-            r_0->force[1] -= quat_cons_y;
-            r_1->force[1] += quat_cons_y;
-            
-            r_0->force[2] -= quat_cons_z;
-            r_1->force[2] += quat_cons_z;            
-        }
+        m_linkForces0[i] = spring - quatCons;
+        m_linkForces1[i] = quatCons - spring;
 
-#if (0) // Original derivation
-        /* Torques resulting from quaternion alignment constraints */
-        quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q11 * quat_0->q.length2() + (q13 * posDiff[0] -
-            q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
-        
-        quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q12 * quat_0->q.length2() + (q14 * posDiff[0] +
-            q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q13 * quat_0->q.length2() + (q11 * posDiff[0] +
-            q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q14 * quat_0->q.length2() + (q12 * posDiff[0] -
-            q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
-#else // quat_0->q.length2() should always be 1, but sometimes numerical precision renders it slightly greater
-        // The simulation is much more stable if we just assume its one.
-        quat_0->tprime[0] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q11 + (q13 * posDiff[0] -
-            q14 * posDiff[1] - q11 * posDiff[2]) / posNorm);
-        
-        quat_0->tprime[1] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q12 + (q14 * posDiff[0] +
-            q13 * posDiff[1] - q12 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[2] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q13 + (q11 * posDiff[0] +
-            q12 * posDiff[1] + q13 * posDiff[2]) / posNorm);
-            
-        quat_0->tprime[3] += 2.0 * m_config.ConsSpringConst * linkLengths[i]
-            * ( q14 + (q12 * posDiff[0] -
-            q11 * posDiff[1] + q14 * posDiff[2]) / posNorm);
-#endif
+        // Turns the director towards the link
+        const btScalar tprime_common = -2.0 * ksc * L / posNorm;
+        m_tprimes[i] = btQuaternion(
+            tprime_common * (q13 * dx - q14 * dy - q11 * dz),
+            tprime_common * (q14 * dx + q13 * dy - q12 * dz),
+            tprime_common * (q11 * dx + q12 * dy + q13 * dz),
+            tprime_common * (q12 * dx - q11 * dy + q14 * dz));
     }
+}
+
+/**
+ * The bending and torsion energy of each pair is
+ * 2 / l * sum_k K_k B_k^2, with B_k the components of the Darboux
+ * vector scaled by l / 2 (rest shape straight). Damping acts on the
+ * rate of change of the same components.
+ */
+void CordeModel::computeBendingTorques()
+{
+    const std::size_t n = quaternionShapes.size();
     
-    n = m_centerlines.size() - 1;
+    const btScalar k1 = computedStiffness[1];
+    const btScalar k2 = computedStiffness[2];
+    const btScalar k3 = computedStiffness[3];
     
-    // Update quaternion elements
 	for (std::size_t i = 0; i < n; i++)
     {
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        CordeQuaternionElement* quat_1 = m_centerlines[i + 1];
+        const btQuaternion& quat_0 = m_quaternions[i];
+        const btQuaternion& quat_1 = m_quaternions[i + 1];
+        const btQuaternion& qdot_0 = m_qdots[i];
+        const btQuaternion& qdot_1 = m_qdots[i + 1];
         
         /* Setup Variables */
-        const btScalar q11 = quat_0->q[0];
-        const btScalar q12 = quat_0->q[1];
-        const btScalar q13 = quat_0->q[2];
-        const btScalar q14 = quat_0->q[3];
-        
-        const btScalar q21 = quat_1->q[0];
-        const btScalar q22 = quat_1->q[1];
-        const btScalar q23 = quat_1->q[2];
-        const btScalar q24 = quat_1->q[3];
-        
-        const btScalar qdot11 = quat_0->qdot[0];
-        const btScalar qdot12 = quat_0->qdot[1];
-        const btScalar qdot13 = quat_0->qdot[2];
-        const btScalar qdot14 = quat_0->qdot[3];
-        
-        const btScalar qdot21 = quat_1->qdot[0];
-        const btScalar qdot22 = quat_1->qdot[1];
-        const btScalar qdot23 = quat_1->qdot[2];
-        const btScalar qdot24 = quat_1->qdot[3];
-        
-        const btScalar k1 = computedStiffness[1];
-        const btScalar k2 = computedStiffness[2];
-        const btScalar k3 = computedStiffness[3];
-        
-        /* I apologize for the mess below - the derivatives involved
-         * here do not leave a lot of common factors. If you see
-         * any nice vector operations I missed, implement them and/or
-         * let me know! _Brian
-         */
+        const btScalar q11 = quat_0[0];
+        const btScalar q12 = quat_0[1];
+        const btScalar q13 = quat_0[2];
+        const btScalar q14 = quat_0[3];
+        
+        const btScalar q21 = quat_1[0];
+        const btScalar q22 = quat_1[1];
+        const btScalar q23 = quat_1[2];
+        const btScalar q24 = quat_1[3];
+        
+        /* Gradients of B_k with respect to each quaternion */
+        const btQuaternion dB1_0( q24,  q23, -q22, -q21);
+        const btQuaternion dB2_0( q23, -q24, -q21,  q22);
+        const btQuaternion dB3_0( q22, -q21,  q24, -q23);
+        
+        const btQuaternion dB1_1(-q14, -q13,  q12,  q11);
+        const btQuaternion dB2_1(-q13,  q14,  q11, -q12);
+        const btQuaternion dB3_1(-q12,  q11, -q14,  q13);
+        
+        /* B_k is bilinear, so B_k = dB_k_0 . quat_0 */
+        const btScalar B1 = dB1_0.dot(quat_0);
+        const btScalar B2 = dB2_0.dot(quat_0);
+        const btScalar B3 = dB3_0.dot(quat_0);
+        
+        const btScalar B1dot = dB1_0.dot(qdot_0) + dB1_1.dot(qdot_1);
+        const btScalar B2dot = dB2_0.dot(qdot_0) + dB2_1.dot(qdot_1);
+        const btScalar B3dot = dB3_0.dot(qdot_0) + dB3_1.dot(qdot_1);
         
         /* Bending and torsional stiffness */        
-        const btScalar stiffness_common = 4.0 / quaternionShapes[i] *
-        pow(quaternionShapes[i] - 1.0, 2);
+        const btScalar stiffness_common = 4.0 / quaternionShapes[i];
         
-        const btScalar q11_stiffness = stiffness_common * 
-        (k1 * q24 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
-         k2 * q23 * (q11 * q23 - q12 * q24 - q13 * q21 + q14 * q22) +
-         k3 * q22 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
-         
-        const btScalar q12_stiffness = stiffness_common * 
-        (k1 * q23 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
-         k2 * q24 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
-         k3 * q21 * (q12 * q21 - q11 * q22 - q13 * q24 + q14 * q23));
-         
-        const btScalar q13_stiffness = stiffness_common * 
-        (k1 * q22 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) +
-         k2 * q21 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
-         k3 * q24 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
-         
-        const btScalar q14_stiffness = stiffness_common * 
-        (k1 * q21 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
-         k2 * q22 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
-         k3 * q23 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));   
-        
-        const btScalar q21_stiffness = stiffness_common *
-        (k1 * q14 * (q14 * q21 - q11 * q24 - q12 * q23 + q13 * q22) +
-         k2 * q13 * (q13 * q21 - q11 * q23 + q12 * q24 - q14 * q22) +
-         k3 * q12 * (q12 * q21 - q11 * q22 + q14 * q23 - q13 * q24));
-        
-        const btScalar q22_stiffness = stiffness_common *
-        (k1 * q13 * (q13 * q22 - q11 * q24 - q12 * q23 + q14 * q21) + 
-         k2 * q14 * (q14 * q22 + q11 * q23 - q12 * q24 - q13 * q21) +
-         k3 * q11 * (q11 * q22 - q12 * q21 + q13 * q24 - q14 * q23));
-         
-        const btScalar q23_stiffness = stiffness_common *
-        (k1 * q12 * (q12 * q23 + q11 * q24 - q13 * q22 - q14 * q21) +
-         k2 * q11 * (q11 * q23 - q13 * q21 - q12 * q24 + q14 * q22) +
-         k3 * q14 * (q14 * q23 - q11 * q22 + q12 * q21 - q13 * q24));
-         
-        const btScalar q24_stiffness = stiffness_common *
-        (k1 * q11 * (q11 * q24 + q12 * q23 - q13 * q22 - q14 * q21) +
-         k2 * q12 * (q12 * q24 - q11 * q23 + q13 * q21 - q14 * q22) +
-         k3 * q13 * (q13 * q24 + q11 * q22 - q12 * q21 - q14 * q23));
-         
         /* Torsional Damping */
         const btScalar damping_common = 4.0 * m_config.gammaR / quaternionShapes[i];
         
-        const btScalar q11_damping = damping_common *
-        (q12 * (q12 * qdot11 - q11 * qdot12 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23) +
-         q13 * (q13 * qdot11 - q11 * qdot13 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22) +
-         q14 * (q14 * qdot11 - q11 * qdot14 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21));
-         
-        const btScalar q12_damping = damping_common *
-        (q11 * (q11 * qdot12 - q12 * qdot11 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23) +
-         q13 * (q13 * qdot12 - q13 * qdot13 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) + 
-         q14 * (q14 * qdot12 - q14 * qdot14 + q21 * qdot23 + q22 * qdot24 - q23 * qdot21 - q24 * qdot22));
-         
-        const btScalar q13_damping = damping_common * 
-        (q11 * (q11 * qdot13 - q13 * qdot11 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
-         q12 * (q12 * qdot13 - q13 * qdot12 + q21 * qdot24 - q22 * qdot23 + q23 * qdot22 - q24 * qdot21) +
-         q14 * (q14 * qdot13 - q13 * qdot14 - q21 * qdot22 + q22 * qdot21 + q23 * qdot24 - q24 * qdot23));
-         
-        const btScalar q14_damping = damping_common *
-        (q11 * (q11 * qdot14 - q14 * qdot11 - q21 * qdot24 + q22 * qdot23 - q23 * qdot22 + q24 * qdot21) +
-         q12 * (q12 * qdot14 - q14 * qdot12 - q21 * qdot23 - q22 * qdot24 + q23 * qdot21 + q24 * qdot22) +
-         q13 * (q13 * qdot14 - q14 * qdot13 + q21 * qdot22 - q22 * qdot21 - q23 * qdot24 + q24 * qdot23));
-        
-        const btScalar q21_damping = damping_common *
-        (q22 * (q22 * qdot21 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q21 * qdot22) +
-         q23 * (q23 * qdot21 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q21 * qdot23) +
-         q24 * (q24 * qdot21 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q21 * qdot24));
-         
-        const btScalar q22_damping = damping_common *
-        (q21 * (q21 * qdot22 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q22 * qdot21) +
-         q23 * (q23 * qdot22 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q22 * qdot23) +
-         q24 * (q24 * qdot22 + q11 * qdot13 + q12 * qdot14 - q13 * qdot11 - q14 * qdot12 - q22 * qdot24));
-         
-        const btScalar q23_damping = damping_common *
-        (q21 * (q21 * qdot23 - q11 * qdot13 + q13 * qdot11 - q12 * qdot14 + q14 * qdot12 - q23 * qdot21) +
-         q22 * (q22 * qdot23 + q11 * qdot14 - q12 * qdot13 + q13 * qdot12 - q14 * qdot11 - q22 * qdot22) +
-         q24 * (q24 * qdot23 - q11 * qdot12 + q12 * qdot11 + q13 * qdot14 - q14 * qdot13 - q23 * qdot24));
-         
-        const btScalar q24_damping = damping_common *
-        (q21 * (q21 * qdot24 - q11 * qdot14 + q12 * qdot13 - q13 * qdot12 + q14 * qdot11 - q24 * qdot21) +
-         q22 * (q21 * qdot24 - q11 * qdot13 - q12 * qdot14 + q13 * qdot11 + q14 * qdot12 - q24 * qdot22) +
-         q23 * (q23 * qdot24 + q11 * qdot12 - q12 * qdot11 - q13 * qdot14 + q14 * qdot13 - q24 * qdot23));
+        const btScalar s1 = -(stiffness_common * k1 * B1 + damping_common * B1dot);
+        const btScalar s2 = -(stiffness_common * k2 * B2 + damping_common * B2dot);
+        const btScalar s3 = -(stiffness_common * k3 * B3 + damping_common * B3dot);
       
-        /* Apply torques */ /// @todo double check the sign convention. Looks good numerically.q
-        quat_0->tprime[0] += q11_stiffness + q11_damping;
-        
-        quat_1->tprime[0] += q21_stiffness + q21_damping;
-        
-        quat_0->tprime[1] += q12_stiffness + q12_damping;
-    
-        quat_1->tprime[1] += q22_stiffness + q22_damping;
-        
-        quat_0->tprime[2] += q13_stiffness + q13_damping;
-        
-        quat_1->tprime[2] += q23_stiffness + q23_damping;
-        
-        quat_0->tprime[3] += q14_stiffness + q14_damping;
-        
-        quat_1->tprime[3] += q24_stiffness + q24_damping;
-
+        /* Apply torques */
+        m_bendTprimes0[i] = dB1_0 * s1 + dB2_0 * s2 + dB3_0 * s3;
+        m_bendTprimes1[i] = dB1_1 * s1 + dB2_1 * s2 + dB3_1 * s3;
     }
 }
 
+/**
+ * Angular velocities are in the body frame, so qdot = q * omega / 2
+ * and the torque is the transpose of that map applied to the
+ * generalized quaternion force.
+ */
 void CordeModel::unconstrainedMotion(double dt)
 {
-    for (std::size_t i = 0; i < m_massPoints.size(); i++)
+    const std::size_t n = m_positions.size();
+    for (std::size_t i = 0; i < n; i++)
     {
-        CordePositionElement* p_0 = m_massPoints[i];
         // Velocity update - semi-implicit Euler
-        p_0->vel += dt / p_0->mass * p_0->force;
+        m_velocities[i] += m_forces[i] * (dt * m_inverseMasses[i]);
         // Position update, uses v(t + dt)
-        p_0->pos += dt * p_0->vel;
+        m_positions[i] += m_velocities[i] * dt;
     }
-    for (std::size_t i = 0; i < m_centerlines.size(); i++)
+    
+    const std::size_t nq = m_quaternions.size();
+    for (std::size_t i = 0; i < nq; i++)
     {
+        const btQuaternion& q = m_quaternions[i];
+        const btQuaternion& tprime = m_tprimes[i];
+        
         /* Transpose quaternion torques into Euclidean torques */
-        CordeQuaternionElement* quat_0 = m_centerlines[i];
-        quat_0->transposeTorques();
+        m_torques[i] = btVector3(
+            1.0/2.0 * (q[3] * tprime[0] + q[2] * tprime[1] - q[1] * tprime[2] - q[0] * tprime[3]),
+            1.0/2.0 * (q[0] * tprime[2] - q[2] * tprime[0] + q[3] * tprime[1] - q[1] * tprime[3]),
+            1.0/2.0 * (q[1] * tprime[0] - q[0] * tprime[1] + q[3] * tprime[2] - q[2] * tprime[3]));
         
-        const btVector3 omega = quat_0->omega;
+        const btVector3 omega = m_omegas[i];
         // Since I is diagonal, we can use elementwise multiplication of vectors
-        quat_0->omega += inverseInertia * (quat_0->torques - 
+        const btVector3 newOmega = omega + inverseInertia * (m_torques[i] - 
             omega.cross(computedInertia * omega)) * dt;
-        quat_0->updateQDot();
-        quat_0->q = (quat_0->qdot*dt + quat_0->q).normalize();
+        m_omegas[i] = newOmega;
+        
+        const btQuaternion qdot(
+            1.0/2.0 * (q[3] * newOmega[0] + q[1] * newOmega[2] - q[2] * newOmega[1]),
+            1.0/2.0 * (q[3] * newOmega[1] + q[2] * newOmega[0] - q[0] * newOmega[2]),
+            1.0/2.0 * (q[3] * newOmega[2] + q[0] * newOmega[1] - q[1] * newOmega[0]),
+            -1.0/2.0 * (q[0] * newOmega[0] + q[1] * newOmega[1] + q[2] * newOmega[2]));
+        m_qdots[i] = qdot;
+        m_quaternions[i] = (qdot * dt + q).normalize();
     }
 }
 
-CordeModel::CordePositionElement::CordePositionElement(btVector3 p1, double m) :
-	pos(p1),
-	vel(0.0, 0.0, 0.0),
-	force(0.0, 0.0, 0.0),
-	mass(m)
-{
-    if (m < 0.0)
-    {
-        throw std::invalid_argument("Mass is negative.");
-    }
-}
-
-CordeModel::CordeQuaternionElement::CordeQuaternionElement(btQuaternion q1) :
-    q(q1.normalize()),
-	qdot(0.0, 0.0, 0.0, 0.0),
-    tprime(0.0, 0.0, 0.0, 0.0),
-	torques(0.0, 0.0, 0.0),
-	omega(0.0, 0.0, 0.0)
-{
-    
-}
-
-void CordeModel::CordeQuaternionElement::transposeTorques()
-{
-    torques[0] += 1.0/2.0 * (q[0] * tprime[2] - q[2] * tprime[0] - q[1] * tprime[3] + q[3] * tprime[1]);
-    torques[1] += 1.0/2.0 * (q[1] * tprime[0] - q[0] * tprime[1] - q[2] * tprime[3] + q[3] * tprime[2]);
-    torques[2] += 1.0/2.0 * (q[0] * tprime[0] + q[1] * tprime[1] + q[2] * tprime[2] + q[3] * tprime[3]);
-}
-
-void CordeModel::CordeQuaternionElement::updateQDot()
-{
-    qdot[0] = 1.0/2.0 * (q[0] * omega[2] + q[1] * omega[1] - q[2] * omega[0]);
-    qdot[1] = 1.0/2.0 * (q[1] * omega[2] - q[0] * omega[1] + q[3] * omega[0]);
-    qdot[2] = 1.0/2.0 * (q[0] * omega[0] + q[2] * omega[2] + q[3] * omega[1]);
-    qdot[3] = 1.0/2.0 * (q[3] * omega[2] - q[2] * omega[1] - q[1] * omega[0]);
-}
-
 /// Checks lengths of vectors. @todo add additional invariants
-bool CordeModel::invariant()
+bool CordeModel::invariant() const
 {
-    return (m_massPoints.size() == m_centerlines.size() + 1)
-        && (m_centerlines.size() == linkLengths.size())
-        && (linkLengths.size() == quaternionShapes.size() + 1)
-        && (computedStiffness.size() == 4);
+    // btAlignedObjectArray sizes are ints
+    const int n = m_positions.size();
+    const int nq = m_quaternions.size();
+    const int nLinks = linkLengths.size();
+    const int nShapes = quaternionShapes.size();
+    return (n == nq + 1)
+        && (m_velocities.size() == n)
+        && (m_forces.size() == n)
+        && ((int) m_inverseMasses.size() == n)
+        && (m_qdots.size() == nq)
+        && (m_tprimes.size() == nq)
+        && (m_torques.size() == nq)
+        && (m_omegas.size() == nq)
+        && (nq == nLinks)
+        && (nLinks == nShapes + 1)
+        && (m_linkForces0.size() == nLinks)
+        && (m_bendTprimes0.size() == nShapes)
+        && (computedStiffness.size() == 4)
+        && (m_stableTimestep > 0.0);
 }
@@ -29,13 +29,29 @@
  */
 
 // Bullet Linear Algebra
+#include "LinearMath/btAlignedObjectArray.h"
 #include "LinearMath/btScalar.h"
 #include "LinearMath/btVector3.h"
 #include "LinearMath/btQuaternion.h"
 
 // The C++ Standard Library
+#include <cstddef>
 #include <vector>
 
+// Forward declarations
+class tgBulletSpringCableAnchor;
+
+/**
+ * A Corde string (Spillman and Teschner) of mass points and centerline
+ * quaternions. Element state is kept as one contiguous array per
+ * quantity so the force loops touch memory linearly and have no
+ * dependencies between iterations.
+ *
+ * Each call to step is split into equal substeps no longer than
+ * getStableTimestep(), which is estimated from the stiffness, damping
+ * and element masses, so the string can be stepped at the world's
+ * timestep however stiff it is.
+ */
 class CordeModel
 {
 public:
@@ -74,72 +90,141 @@ public:
 	 */
 	CordeModel(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2, CordeModel::Config& Config);
 	
+	/**
+	 * Same as above, but the ends of the string are pinned to the
+	 * anchors and follow their rigid bodies. The forces the string
+	 * exerts on its end points are applied to the bodies as impulses
+	 * at the end of each step. Either anchor may be NULL to leave
+	 * that end free.
+	 * @param[in] anchor1 - the start of the string, owned by this
+	 * @param[in] anchor2 - the end of the string, owned by this
+	 */
+	CordeModel(tgBulletSpringCableAnchor* anchor1,
+				tgBulletSpringCableAnchor* anchor2,
+				btQuaternion quat1, btQuaternion quat2,
+				CordeModel::Config& Config);
+	
 	~CordeModel();
 	
+	/**
+	 * Advance the string by dt in getNumSubsteps(dt) substeps
+	 */
 	void step (btScalar dt);
 	
+	/**
+	 * The longest substep the integrator will take
+	 */
+	double getStableTimestep() const
+	{
+		return m_stableTimestep;
+	}
+	
+	/**
+	 * The number of substeps a call to step(dt) will take
+	 */
+	std::size_t getNumSubsteps(double dt) const;
+	
+	std::size_t getNumMassPoints() const
+	{
+		return m_positions.size();
+	}
+	
+	const btVector3& getPosition(std::size_t i) const
+	{
+		return m_positions[i];
+	}
+	
+	const btVector3& getVelocity(std::size_t i) const
+	{
+		return m_velocities[i];
+	}
+	
+	const btQuaternion& getQuaternion(std::size_t i) const
+	{
+		return m_quaternions[i];
+	}
+	
 private:
+	void constructorAux(btVector3 pos1, btVector3 pos2, btQuaternion quat1, btQuaternion quat2);
+	
 	void computeConstants();
-
-	void stepPrerequisites();
-
+	
+	void computeStableTimestep();
+	
+	/**
+	 * Move anchored end points to their bodies and match velocities
+	 */
+	void updateAnchors();
+	
 	void computeInternalForces();
 	
+	/**
+	 * Stretch, damping and alignment forces of each link, and the
+	 * alignment torques on its quaternion
+	 */
+	void computeLinkForces();
+	
+	/**
+	 * Bending and torsion torques between neighbouring quaternions
+	 */
+	void computeBendingTorques();
+	
 	void unconstrainedMotion(double dt);
 	
+	void applyAnchorImpulses();
+	
+	CordeModel::Config m_config;
+	
 	/**
-	 * Holds all of the data for one of the mass elements of the string
+	 * NULL if that end of the string is free
 	 */
-	struct CordePositionElement
-	{
-		/**
-		 * Sets pos to p1, mass to m, everything else to zero
-		 * Assumes rod is at rest on start
-		 */
-		CordePositionElement(btVector3 p1, double m);
-		
-		btVector3 pos;
-		btVector3 vel;
-		btVector3 force;
-		double mass;
-	};
+	tgBulletSpringCableAnchor* m_anchor1;
+	tgBulletSpringCableAnchor* m_anchor2;
 	
 	/**
-	 * Holds all of the data for the centerline quaternions of the string
+	 * Accumulated over the substeps of one step
 	 */
-	struct CordeQuaternionElement
-	{	
-		/**
-		 * Sets q to q1.normalized(), everything else to zero
-		 */
-		CordeQuaternionElement(btQuaternion q1);
-		
-		void transposeTorques();
-		/**
-		 * Must be called after transpose torques and omega is updated
-		 */
-		void updateQDot();
-		
-		btQuaternion q;
-		btQuaternion qdot;
-		/**
-		 * Just a 4x1 vector, but easier to store this way.
-		 */
-		btQuaternion tprime;
-		btVector3 torques;
-		btVector3 omega;
-	};
+	btVector3 m_anchorImpulse1;
+	btVector3 m_anchorImpulse2;
 	
-	CordeModel::Config m_config;
+	/** @name Mass points */
+	/**@{*/
+	btAlignedObjectArray<btVector3> m_positions;
+	btAlignedObjectArray<btVector3> m_velocities;
+	btAlignedObjectArray<btVector3> m_forces;
+	/**
+	 * Zero for anchored end points, which move with their body
+	 */
+	std::vector<double> m_inverseMasses;
+	/**@}*/
 	
-	std::vector<CordePositionElement*> m_massPoints;
-	std::vector<CordeQuaternionElement*> m_centerlines;
+	/** @name Centerline quaternions */
+	/**@{*/
+	btAlignedObjectArray<btQuaternion> m_quaternions;
+	btAlignedObjectArray<btQuaternion> m_qdots;
 	/**
-	 * Should have length equal to m_massPoints.size()-1
+	 * Generalized forces on the quaternions. Just a 4x1 vector,
+	 * but easier to store this way.
+	 */
+	btAlignedObjectArray<btQuaternion> m_tprimes;
+	btAlignedObjectArray<btVector3> m_torques;
+	btAlignedObjectArray<btVector3> m_omegas;
+	/**@}*/
+	
+	/** @name Per element contributions, summed after each loop */
+	/**@{*/
+	btAlignedObjectArray<btVector3> m_linkForces0;
+	btAlignedObjectArray<btVector3> m_linkForces1;
+	btAlignedObjectArray<btQuaternion> m_bendTprimes0;
+	btAlignedObjectArray<btQuaternion> m_bendTprimes1;
+	/**@}*/
+	
+	/**
+	 * Should have length equal to m_positions.size()-1
 	 */
 	std::vector<double> linkLengths;
 	/**
-	 * Should have length equal to m_Centerlines.size()-1
+	 * Should have length equal to m_quaternions.size()-1
 	 */
 	std::vector<double> quaternionShapes;
 	
@@ -158,9 +243,11 @@ private:
 	btVector3 computedInertia;
 	btVector3 inverseInertia;
 	
-	bool invariant();
+	double m_unitMass;
+	
+	double m_stableTimestep;
 	
-	double simTime;
+	bool invariant() const;
 };
  
  
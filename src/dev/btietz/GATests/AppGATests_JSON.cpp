@@ -155,6 +155,7 @@ int main(int argc, char** argv)
     {
         score1 +=  output[i];
     }
+    delete[] output;
     
     // Test other direction
     state.clear();
@@ -179,6 +180,8 @@ int main(int argc, char** argv)
             std::cout << "Negative value! " << output2[i] << std::endl;
         }
     }
+    delete[] output2;
+    delete[] inputs;
     
     std::vector<double> scores;
     scores.push_back(score1 - score2);
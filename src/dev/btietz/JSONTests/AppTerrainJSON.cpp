@@ -27,6 +27,52 @@
 #include "AppTerrainJSON.h"
 #include "tgCPGJSONLogger.h"
 
+#include "helpers/FileHelpers.h"
+
+// JSON
+#include <json/json.h>
+
+// POSIX
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// The C++ Standard Library
+#include <cstring>
+#include <stdexcept>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    bool writeAll(int fd, const std::string& buf)
+    {
+        std::size_t sent = 0;
+        while (sent < buf.size())
+        {
+            const ssize_t n = send(fd, buf.data() + sent, buf.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            sent += n;
+        }
+        return true;
+    }
+    
+    bool isBlank(const std::string& line)
+    {
+        return line.find_first_not_of(" \t\r") == std::string::npos;
+    }
+}
+
 AppTerrainJSON::AppTerrainJSON(int argc, char** argv)
 {
     bSetup = false;
@@ -49,8 +95,16 @@ AppTerrainJSON::AppTerrainJSON(int argc, char** argv)
     startAngle = 0;
     lowerPath = "default";
     suffix = "default";
+    server_mode = false;
+    serverSocket = "";
+    
+    m_model = NULL;
+    m_control = NULL;
+    m_modelAdded = false;
 
     handleOptions(argc, argv);
+    
+    m_currentHills = add_hills;
 }
 
 bool AppTerrainJSON::setup()
@@ -72,6 +126,7 @@ bool AppTerrainJSON::setup()
     /// @todo add position and angle to configuration
         SuperballModelContact* myModel =
       new SuperballModelContact(nSegments);
+    m_model = myModel;
 
     // Fifth create the controllers, attach to model
     if (add_controller)
@@ -137,12 +192,18 @@ bool AppTerrainJSON::setup()
     myControl->attach(myLogger);
 #endif        
         myModel->attach(myControl);
+        m_control = myControl;
     }
 
     // Sixth add model & controller to simulation
-    simulation->addModel(myModel);
+    // In server mode the parameter file isn't known until the first request
+    if (!server_mode)
+    {
+        simulation->addModel(myModel);
+        m_modelAdded = true;
+    }
     
-    if (add_blocks)
+    if (add_blocks && !server_mode)
     {
         tgModel* blockField = getBlocks();
         simulation->addObstacle(blockField);
@@ -175,6 +236,8 @@ void AppTerrainJSON::handleOptions(int argc, char **argv)
         ("learning_controller,l", po::value<std::string>(&suffix), "Which learned controller to write to or use. Default = default")
         ("lower_path,P", po::value<std::string>(&lowerPath), "Which resources folder in which you want to store controllers. Default = default")
         ("goal_angle,B", po::value<double>(&goalAngle), "Angle of starting rotation for goal box. Degrees. Default = 0")
+        ("server,R", po::value<bool>(&server_mode)->implicit_value(true), "Build the world once and run trials requested as JSON lines on stdin. Only works with graphics off")
+        ("socket,U", po::value<std::string>(&serverSocket), "Serve trial requests on this Unix domain socket instead of stdin. Implies server")
     ;
 
     po::variables_map vm;
@@ -199,6 +262,11 @@ void AppTerrainJSON::handleOptions(int argc, char **argv)
         timestep_graphics = 1/vm["graph_time"].as<double>();
         std::cout << "Graphics timestep set to: " << timestep_graphics << " seconds.\n";
     }
+    
+    if (vm.count("socket"))
+    {
+        server_mode = true;
+    }
 }
 
 const tgHillyGround::Config AppTerrainJSON::getHillyConfig()
@@ -245,24 +313,27 @@ tgModel* AppTerrainJSON::getBlocks()
     return myObstacle;
 }
 
-tgWorld* AppTerrainJSON::createWorld()
+tgBulletGround* AppTerrainJSON::createGround(bool hills)
 {
-    const tgWorld::Config config(
-        981 // gravity, cm/sec^2
-    );
-    
-    tgBulletGround* ground;
-    
-    if (add_hills)
+    if (hills)
     {
         const tgHillyGround::Config hillGroundConfig = getHillyConfig();
-        ground = new tgHillyGround(hillGroundConfig);
+        return new tgHillyGround(hillGroundConfig);
     }
     else
     {
         const tgBoxGround::Config groundConfig = getBoxConfig();
-        ground = new tgBoxGround(groundConfig);
+        return new tgBoxGround(groundConfig);
     }
+}
+
+tgWorld* AppTerrainJSON::createWorld()
+{
+    const tgWorld::Config config(
+        981 // gravity, cm/sec^2
+    );
+    
+    tgBulletGround* ground = createGround(add_hills);
     
     return new tgWorld(config, ground);
 }
@@ -284,7 +355,11 @@ bool AppTerrainJSON::run()
         setup();
     }
 
-    if (use_graphics)
+    if (server_mode)
+    {
+        serve();
+    }
+    else if (use_graphics)
     {
         // Run until the user stops
         simulation->run();
@@ -295,6 +370,12 @@ bool AppTerrainJSON::run()
         simulate(simulation);
     }
     
+    // A server that never got a request still owns its model
+    if (!m_modelAdded)
+    {
+        delete m_model;
+    }
+    
     ///@todo consider app.cleanup()
    delete simulation;
    delete view;
@@ -351,6 +432,210 @@ void AppTerrainJSON::simulate(tgSimulation *simulation)
     }
 }
 
+void AppTerrainJSON::serve()
+{
+    if (serverSocket != "")
+    {
+        serveSocket(serverSocket);
+    }
+    else
+    {
+        // Models and controllers chat on std::cout, keep stdout for replies
+        std::streambuf* const replies = std::cout.rdbuf(std::cerr.rdbuf());
+        std::ostream out(replies);
+        serveStream(std::cin, out);
+        std::cout.rdbuf(replies);
+    }
+}
+
+std::string AppTerrainJSON::runTrial(const std::string& request)
+{
+    Json::Value reply;
+    Json::Value root;
+    Json::Reader reader;
+    
+    if (!reader.parse(request, root) || !root.isObject() ||
+        !root.isMember("filename"))
+    {
+        reply["status"] = "error";
+        reply["message"] = "Expected a JSON object with a filename";
+        return Json::FastWriter().write(reply);
+    }
+    else if (m_control == NULL)
+    {
+        reply["status"] = "error";
+        reply["message"] = "No controller attached";
+        return Json::FastWriter().write(reply);
+    }
+    
+    const std::string filename = root["filename"].asString();
+    const std::string path = root.get("path", lowerPath).asString();
+    const int steps = root.get("steps", nSteps).asInt();
+    const bool blocks = root.get("blocks", add_blocks).asBool();
+    const bool hills = root.get("hills", add_hills).asBool();
+    
+    reply["filename"] = filename;
+    
+    try
+    {
+        m_control->setControlFile(filename, path);
+        
+        // The model was torn down when the previous trial finished, so
+        // this only resets the world and loads the new parameters
+        if (hills != m_currentHills)
+        {
+            simulation->reset(createGround(hills));
+            m_currentHills = hills;
+        }
+        else if (m_modelAdded)
+        {
+            simulation->reset();
+        }
+        
+        if (!m_modelAdded)
+        {
+            simulation->addModel(m_model);
+            m_modelAdded = true;
+        }
+        
+        if (blocks)
+        {
+            simulation->addObstacle(getBlocks());
+        }
+        
+        try
+        {
+            simulation->run(steps);
+        }
+        catch (const std::runtime_error& e)
+        {
+            // Nothing to do here, score will be set to -1
+        }
+        
+        // The controller appends this trial's scores to its file. The
+        // world itself is cleaned up by the next reset
+        m_model->teardown();
+        
+        Json::Value results;
+        if (!reader.parse(FileHelpers::getFileString(m_control->getControlFilename().c_str()), results))
+        {
+            throw std::runtime_error("Could not read scores back from " +
+                                     m_control->getControlFilename());
+        }
+        
+        const Json::Value& scores = results["scores"];
+        if (!scores.isArray() || scores.size() == 0)
+        {
+            throw std::runtime_error("No scores in " +
+                                     m_control->getControlFilename());
+        }
+        
+        reply["status"] = "ok";
+        reply["scores"] = scores[scores.size() - 1];
+    }
+    catch (std::exception& e)
+    {
+        // Otherwise the next request's reset would score this trial
+        // into that request's file
+        m_control->abandonTrial();
+        m_model->teardown();
+        
+        reply["status"] = "error";
+        reply["message"] = e.what();
+    }
+    
+    return Json::FastWriter().write(reply);
+}
+
+void AppTerrainJSON::serveStream(std::istream& in, std::ostream& out)
+{
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!isBlank(line))
+        {
+            out << runTrial(line) << std::flush;
+        }
+    }
+}
+
+void AppTerrainJSON::serveSocket(const std::string& path)
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        throw std::invalid_argument("Socket path is too long: " + path);
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        throw std::runtime_error("Could not create trial server socket");
+    }
+    
+    // Clear out a socket left behind by a previous server
+    unlink(path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 16) != 0)
+    {
+        close(listener);
+        throw std::runtime_error("Could not listen on " + path + ": " +
+                                 std::strerror(errno));
+    }
+    
+    std::cerr << "Serving trials on " << path << std::endl;
+    
+    // One client at a time, the simulation can only run one trial anyway.
+    // Runs until the process is killed.
+    while (true)
+    {
+        const int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        
+        std::string pending;
+        char buf[4096];
+        bool connected = true;
+        while (connected)
+        {
+            const ssize_t n = read(fd, buf, sizeof(buf));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                break;
+            }
+            pending.append(buf, n);
+            
+            std::size_t eol;
+            while (connected && (eol = pending.find('\n')) != std::string::npos)
+            {
+                const std::string line = pending.substr(0, eol);
+                pending.erase(0, eol + 1);
+                if (!isBlank(line))
+                {
+                    connected = writeAll(fd, runTrial(line));
+                }
+            }
+        }
+        close(fd);
+    }
+    
+    close(listener);
+    unlink(path.c_str());
+}
+
 /**
  * The entry point.
  * @param[in] argc the number of command-line arguments
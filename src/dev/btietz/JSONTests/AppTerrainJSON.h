@@ -62,6 +62,18 @@ public:
     bool setup();
     /** Run the simulation */
     bool run();
+    
+    /**
+     * Serve trials until the client goes away. Each request is one line
+     * of JSON naming a parameter file, e.g.
+     * {"filename": "ctrl_0.json", "path": "default", "steps": 60000,
+     *  "blocks": false, "hills": false}
+     * Everything but filename is optional and defaults to the command
+     * line options. The controller appends its scores to the parameter
+     * file as usual, and the latest scores are also sent back as one line
+     * of JSON. The world is built once, trials only reset the simulation.
+     */
+    void serve();
 
 private:
     /** Parse command line options */
@@ -73,6 +85,9 @@ private:
     
     tgModel* getBlocks();
     
+    /** Hilly or flat ground, per the add_hills convention */
+    tgBulletGround* createGround(bool hills);
+    
     /** Create the tgWorld object */
     tgWorld *createWorld();
 
@@ -85,11 +100,25 @@ private:
     /** Run a series of episodes for nSteps each */
     void simulate(tgSimulation *simulation);
     
+    /** Run one trial server request, returns the one line JSON reply */
+    std::string runTrial(const std::string& request);
+    
+    /** Serve requests read from in, replies are written to out */
+    void serveStream(std::istream& in, std::ostream& out);
+    
+    /** Serve one connection at a time on a Unix domain socket */
+    void serveSocket(const std::string& path);
     
     // Keep these around for cleanup
     tgWorld* world;
     tgSimView* view;
     tgSimulation* simulation;
+    
+    // Kept for server mode, owned by the simulation
+    SuperballModelContact* m_model;
+    JSONFeedbackControl* m_control;
+    bool m_modelAdded;
+    bool m_currentHills;
 
     bool use_graphics;
     bool add_controller;
@@ -111,6 +140,9 @@ private:
     
     std::string suffix;
     
+    bool server_mode;
+    std::string serverSocket;
+    
     bool bSetup;
 };
 
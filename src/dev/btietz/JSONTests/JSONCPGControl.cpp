@@ -143,6 +143,17 @@ m_config(config),
 m_dataObserver("logs/TCData"),
 m_updateTime(0.0),
 bogus(false)
+{
+    setControlFile(args, resourcePath);
+}
+
+JSONCPGControl::~JSONCPGControl() 
+{
+    scores.clear();
+}
+
+void JSONCPGControl::setControlFile(const std::string& args,
+                                    const std::string& resourcePath)
 {
 	if (resourcePath != "")
 	{
@@ -156,9 +167,9 @@ bogus(false)
     controlFilename = controlFilePath + args;
 }
 
-JSONCPGControl::~JSONCPGControl() 
+const std::string& JSONCPGControl::getControlFilename() const
 {
-    scores.clear();
+    return controlFilename;
 }
 
 void JSONCPGControl::onSetup(BaseSpineModelLearning& subject)
@@ -282,6 +293,13 @@ void JSONCPGControl::onStep(BaseSpineModelLearning& subject, double dt)
 
 void JSONCPGControl::onTeardown(BaseSpineModelLearning& subject)
 {
+    // Already torn down (i.e. tgSimulation::teardown followed by reset),
+    // don't append a second score for the same trial
+    if (m_pCPGSys == NULL)
+    {
+        return;
+    }
+    
     scores.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -368,6 +386,22 @@ void JSONCPGControl::onTeardown(BaseSpineModelLearning& subject)
 	m_allControllers.clear();
 }
 
+void JSONCPGControl::abandonTrial()
+{
+    delete m_pCPGSys;
+    m_pCPGSys = NULL;
+    
+    for(size_t i = 0; i < m_allControllers.size(); i++)
+    {
+        delete m_allControllers[i];
+    }
+    m_allControllers.clear();
+    
+    initConditions.clear();
+    scores.clear();
+    bogus = false;
+}
+
 const double JSONCPGControl::getCPGValue(std::size_t i) const
 {
 	// Error handling on input done in CPG_Equations
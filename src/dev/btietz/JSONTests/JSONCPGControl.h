@@ -125,6 +125,26 @@ struct Config
 	
 	double getScore() const;
 	
+    /**
+     * Point the controller at a different parameter file. Takes effect
+     * at the next onSetup, and scores are appended to the same file on
+     * the following onTeardown. Used by long-lived trial servers that
+     * run many parameter sets without rebuilding the simulation.
+     * @param[in] args the filename of the JSON parameters
+     * @param[in] resourcePath the folder under resources, may be empty
+     */
+    void setControlFile(const std::string& args,
+                        const std::string& resourcePath = "");
+    
+    const std::string& getControlFilename() const;
+    
+    /**
+     * Drop a trial that failed to set up or run, without scoring it.
+     * The next onTeardown is then skipped, as if the trial had already
+     * been torn down.
+     */
+    void abandonTrial();
+    
 protected:
     /**
      * Takes a vector of parameters reported by learning, and then 
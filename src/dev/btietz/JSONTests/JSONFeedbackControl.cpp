@@ -225,6 +225,13 @@ void JSONFeedbackControl::onStep(BaseSpineModelLearning& subject, double dt)
 
 void JSONFeedbackControl::onTeardown(BaseSpineModelLearning& subject)
 {
+    // Already torn down (i.e. tgSimulation::teardown followed by reset),
+    // don't append a second score for the same trial
+    if (m_pCPGSys == NULL)
+    {
+        return;
+    }
+    
     scores.clear();
     // @todo - check to make sure we ran for the right amount of time
     
@@ -431,6 +438,7 @@ std::vector<double> JSONFeedbackControl::getFeedback(BaseSpineModelLearning& sub
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -439,6 +447,7 @@ std::vector<double> JSONFeedbackControl::getFeedback(BaseSpineModelLearning& sub
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -368,6 +368,7 @@ std::vector<double> OctahedralTensionControl::getGoalFeedback(const BaseSpineMod
     {
         actions.push_back(output[j]);
     }
+    delete[] output;
     
     transformFeedbackActions(actions);
     
@@ -393,5 +394,6 @@ std::vector<double> OctahedralTensionControl::getGoalFeedback(const BaseSpineMod
 
     
     
+    delete[] inputs;
     return actions;
 }
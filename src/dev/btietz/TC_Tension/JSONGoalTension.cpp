@@ -376,6 +376,7 @@ std::vector<double> JSONGoalTension::getGoalFeedback(const BaseSpineModelGoal* s
     {
         actions.push_back(output[j]);
     }
+    delete[] output;
     
     transformFeedbackActions(actions);
     
@@ -392,6 +393,7 @@ std::vector<double> JSONGoalTension::getGoalFeedback(const BaseSpineModelGoal* s
 
     
     
+    delete[] inputs;
     return actions;
 }
 
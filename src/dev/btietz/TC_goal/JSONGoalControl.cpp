@@ -472,10 +472,12 @@ std::vector<double> JSONGoalControl::getGoalFeedback(const BaseSpineModelGoal* s
             actions.push_back(output[j]);
         }
     }
+    delete[] output;
 
 
     transformFeedbackActions(actions);
     
+    delete[] inputs;
     return actions;
 }
 
@@ -506,6 +508,7 @@ std::vector<double> JSONGoalControl::getFeedback(BaseSpineModelLearning& subject
         {
             actions.push_back(output[j]);
         }
+        delete[] output;
 
         transformFeedbackActions(actions);
         
@@ -513,6 +516,7 @@ std::vector<double> JSONGoalControl::getFeedback(BaseSpineModelLearning& subject
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
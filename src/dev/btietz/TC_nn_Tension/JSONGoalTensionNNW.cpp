@@ -370,6 +370,7 @@ std::vector<double> JSONGoalTensionNNW::getGoalFeedback(const BaseSpineModelGoal
     {
         actions.push_back(output[j]);
     }
+    delete[] output;
     
     transformFeedbackActions(actions);
     
@@ -386,6 +387,7 @@ std::vector<double> JSONGoalTensionNNW::getGoalFeedback(const BaseSpineModelGoal
 
     
     
+    delete[] inputs;
     return actions;
 }
 
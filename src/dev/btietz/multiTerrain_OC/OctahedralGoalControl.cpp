@@ -348,6 +348,7 @@ void OctahedralGoalControl::setGoalTensions(const BaseSpineModelGoal* subject)
     {
         actions.push_back(output[j]);
     }
+    delete[] output;
 
     transformFeedbackActions(actions);
     
@@ -372,4 +373,5 @@ void OctahedralGoalControl::setGoalTensions(const BaseSpineModelGoal* subject)
         tgCPGCableControl* mCPGController = tgCast::cast<tgCPGActuatorControl, tgCPGCableControl>(m_allControllers[i]);
         mCPGController->updateControlLength(actions[i] *startLength + startLength);
     }
+    delete[] inputs;
 }
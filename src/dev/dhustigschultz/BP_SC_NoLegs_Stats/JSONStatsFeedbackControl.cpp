@@ -495,6 +495,7 @@ std::vector<double> JSONStatsFeedbackControl::getFeedback(BaseQuadModelLearning&
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -503,6 +504,7 @@ std::vector<double> JSONStatsFeedbackControl::getFeedback(BaseQuadModelLearning&
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
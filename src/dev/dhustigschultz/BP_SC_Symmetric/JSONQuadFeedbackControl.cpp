@@ -421,6 +421,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -429,6 +430,7 @@ std::vector<double> JSONQuadFeedbackControl::getFeedback(BaseSpineModelLearning&
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -518,6 +518,7 @@ std::vector<double> JSONMetricsFeedbackControl::getFeedback(BaseQuadModelLearnin
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -526,6 +527,7 @@ std::vector<double> JSONMetricsFeedbackControl::getFeedback(BaseQuadModelLearnin
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
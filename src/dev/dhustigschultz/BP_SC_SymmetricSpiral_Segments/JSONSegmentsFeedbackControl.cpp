@@ -745,6 +745,7 @@ std::vector<double> JSONSegmentsFeedbackControl::getFeedback(BaseQuadModelLearni
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -775,6 +776,7 @@ std::vector<double> JSONSegmentsFeedbackControl::getFeedback(BaseQuadModelLearni
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -812,6 +814,7 @@ std::vector<double> JSONSegmentsFeedbackControl::getFeedback(BaseQuadModelLearni
     }*/
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -73,6 +73,12 @@ public:
     
     virtual const std::vector<tgBaseRigid*> getAllRigids() const;
     
+    /** The segment and hip substructures, in the order getSegmentCOM uses */
+    const std::vector<tgModel*>& getAllSegments() const
+    {
+        return m_allSegments;
+    }
+    
     virtual const int getSegments() const;
     
     virtual std::size_t getNumberofMuslces() const
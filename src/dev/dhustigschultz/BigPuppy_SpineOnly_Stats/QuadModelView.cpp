@@ -0,0 +1,107 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file QuadModelView.cpp
+ * @brief Implementation of QuadModelView
+ * $Id$
+ */
+
+// This module
+#include "QuadModelView.h"
+#include "BaseQuadModelLearning.h"
+// This library
+#include "core/tgBaseRigid.h"
+#include "core/tgCast.h"
+#include "core/tgRod.h"
+#include "core/tgSpringCableActuator.h"
+// The C++ Standard Library
+#include <cassert>
+#include <stdexcept>
+
+QuadModelView::QuadModelView()
+{
+}
+
+void QuadModelView::rebuild(BaseQuadModelLearning& subject)
+{
+    clear();
+
+    m_cables = subject.find<tgSpringCableActuator>("all ");
+
+    const std::vector<tgModel*>& segments = subject.getAllSegments();
+    m_segmentStart.push_back(0);
+    for (std::size_t n = 0; n < segments.size(); n++)
+    {
+        const std::vector<tgModel*> descendants = segments[n]->getDescendants();
+
+        const std::vector<tgBaseRigid*> rigids =
+            tgCast::filter<tgModel, tgBaseRigid>(descendants);
+        m_rigids.insert(m_rigids.end(), rigids.begin(), rigids.end());
+
+        const std::vector<tgRod*> rods =
+            tgCast::filter<tgModel, tgRod>(descendants);
+        // Summed in the same order as getSegmentCOMVector
+        double segmentMass = 0.0;
+        for (std::size_t i = 0; i < rods.size(); i++)
+        {
+            assert(rods[i] != NULL);
+            const double rodMass = rods[i]->mass();
+            m_rods.push_back(rods[i]);
+            m_rodMasses.push_back(rodMass);
+            segmentMass += rodMass;
+        }
+        m_segmentStart.push_back(m_rods.size());
+        m_segmentMasses.push_back(segmentMass);
+    }
+}
+
+void QuadModelView::clear()
+{
+    m_cables.clear();
+    m_rigids.clear();
+    m_segmentStart.clear();
+    m_rods.clear();
+    m_rodMasses.clear();
+    m_segmentMasses.clear();
+}
+
+double QuadModelView::getSegmentMass(std::size_t n) const
+{
+    if (n >= m_segmentMasses.size())
+    {
+        throw std::range_error("Not a segment of the view");
+    }
+    return m_segmentMasses[n];
+}
+
+btVector3 QuadModelView::getSegmentCOM(std::size_t n) const
+{
+    const double segmentMass = getSegmentMass(n);
+    // Check to make sure the rods actually had mass
+    assert(segmentMass > 0.0);
+
+    btVector3 segmentCenterOfMass(0, 0, 0);
+    for (std::size_t i = m_segmentStart[n]; i < m_segmentStart[n + 1]; i++)
+    {
+        segmentCenterOfMass += m_rods[i]->centerOfMass() * m_rodMasses[i];
+    }
+    segmentCenterOfMass /= segmentMass;
+
+    return segmentCenterOfMass;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef QUAD_MODEL_VIEW_H
+#define QUAD_MODEL_VIEW_H
+
+/**
+ * @file QuadModelView.h
+ * @brief Handles into a BaseQuadModelLearning, gathered once per episode
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+// Forward declarations
+class BaseQuadModelLearning;
+class tgBaseRigid;
+class tgRod;
+class tgSpringCableActuator;
+
+/**
+ * What a controller reads from its subject every tick, gathered in
+ * onSetup instead of by tag search and tree walks each time. The
+ * pointers belong to the model, so rebuild in onSetup and clear in
+ * onTeardown; the model's children are recreated on every reset.
+ */
+class QuadModelView
+{
+public:
+
+    QuadModelView();
+
+    /**
+     * Gather handles from a subject whose children have been built,
+     * i.e. from a controller's onSetup. Replaces any previous contents.
+     */
+    void rebuild(BaseQuadModelLearning& subject);
+
+    /** Forget every handle, before the model frees them */
+    void clear();
+
+    /** Every tgSpringCableActuator tagged "all", in find order */
+    const std::vector<tgSpringCableActuator*>& getAllCables() const
+    {
+        return m_cables;
+    }
+
+    /** Every rigid of every segment, as BaseQuadModelLearning::getAllRigids */
+    const std::vector<tgBaseRigid*>& getAllRigids() const
+    {
+        return m_rigids;
+    }
+
+    std::size_t getNumSegments() const
+    {
+        return m_segmentMasses.size();
+    }
+
+    double getSegmentMass(std::size_t n) const;
+
+    /**
+     * Same value as BaseQuadModelLearning::getSegmentCOMVector, without
+     * walking the segment or allocating.
+     * @throw std::range_error if n is not a segment
+     */
+    btVector3 getSegmentCOM(std::size_t n) const;
+
+private:
+
+    std::vector<tgSpringCableActuator*> m_cables;
+
+    std::vector<tgBaseRigid*> m_rigids;
+
+    /** Rods of segment n are m_rods[m_segmentStart[n]] to m_rods[m_segmentStart[n + 1] - 1] */
+    std::vector<std::size_t> m_segmentStart;
+
+    std::vector<const tgRod*> m_rods;
+
+    /** Parallel to m_rods */
+    std::vector<double> m_rodMasses;
+
+    std::vector<double> m_segmentMasses;
+};
+
+#endif // QUAD_MODEL_VIEW_H
@@ -763,6 +763,7 @@ std::vector<double> JSONAOHierarchyControl::getFeedback(BaseQuadModelLearning& s
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -770,6 +771,7 @@ std::vector<double> JSONAOHierarchyControl::getFeedback(BaseQuadModelLearning& s
         feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
     }
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -1474,6 +1474,7 @@ std::vector<double> JSONAchillesHierarchyControl::getFeedback(BaseQuadModelLearn
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -1499,6 +1500,7 @@ std::vector<double> JSONAchillesHierarchyControl::getFeedback(BaseQuadModelLearn
 	{
 	    tmpAct.push_back(output[j]);
 	}
+	delete[] output;
 	actions.push_back(tmpAct);
 
 	std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -1506,6 +1508,7 @@ std::vector<double> JSONAchillesHierarchyControl::getFeedback(BaseQuadModelLearn
 	feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
     }
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -46,7 +46,7 @@
 #include "util/CPGEquationsFB.h"
 #include "examples/learningSpines/tgCPGCableControl.h"
 
-#include "neuralNet/Neural Network v2/neuralNetwork.h"
+#include "learning/NeuroEvolution/BatchedNeuralNetwork.h"
 
 #include <json/json.h>
 
@@ -136,6 +136,8 @@ JSONHierarchyFeedbackControl::~JSONHierarchyFeedbackControl()
 
 void JSONHierarchyFeedbackControl::onSetup(BaseQuadModelLearning& subject)
 {
+    m_modelView.rebuild(subject);
+    
     m_pCPGSys = new CPGEquationsFB(100);
 
     Json::Value root; // will contains the root value after parsing.
@@ -207,11 +209,16 @@ void JSONHierarchyFeedbackControl::onSetup(BaseQuadModelLearning& subject)
     
     std::string nnFile = controlFilePath + feedbackParams.get("neuralFilename", "UTF-8").asString();
     
-    nn = new neuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
+    nn = new BatchedNeuralNetwork(m_config.numStates, m_config.numStates*2, m_config.numActions);
     
     nn->loadWeights(nnFile.c_str());
     
-    initConditions = subject.getSegmentCOM(m_config.segmentNumber);
+    const btVector3 initCOM = m_modelView.getSegmentCOM(m_config.segmentNumber);
+    initConditions.assign(3, 0.0);
+    for (std::size_t i = 0; i < 3; i++)
+    {
+        initConditions[i] = initCOM[i];
+    }
     for (int i = 0; i < initConditions.size(); i++)
     {
         std::cout << initConditions[i] << " ";
@@ -290,7 +297,8 @@ void JSONHierarchyFeedbackControl::onStep(BaseQuadModelLearning& subject, double
         m_updateTime = 0;
     }
     
-    double currentHeight = subject.getSegmentCOM(m_config.segmentNumber)[1];
+    // Every physics step, so no tag search or allocation here
+    const double currentHeight = m_modelView.getSegmentCOM(m_config.segmentNumber).getY();
     
     /// Max and min heights added to config
     if (currentHeight > m_config.maxHeight || currentHeight < m_config.minHeight)
@@ -331,7 +339,7 @@ void JSONHierarchyFeedbackControl::onTeardown(BaseQuadModelLearning& subject)
     /// @todo - return length scale as a parameter
     double totalEnergySpent=0;
     
-    std::vector<tgSpringCableActuator* > tmpStrings = subject.find<tgSpringCableActuator> ("all ");
+    const std::vector<tgSpringCableActuator* >& tmpStrings = m_modelView.getAllCables();
     
     for(std::size_t i=0; i<tmpStrings.size(); i++)
     {
@@ -401,6 +409,9 @@ void JSONHierarchyFeedbackControl::onTeardown(BaseQuadModelLearning& subject)
     delete m_pCPGSys;
     m_pCPGSys = NULL;
     
+    // The model frees the cables and rods after this
+    m_modelView.clear();
+    
     for(size_t i = 0; i < m_spineControllers.size(); i++)
     {
         delete m_spineControllers[i];
@@ -1176,63 +1187,42 @@ array_4D JSONHierarchyFeedbackControl::scaleEdgeActions
 
 std::vector<double> JSONHierarchyFeedbackControl::getFeedback(BaseQuadModelLearning& subject)
 {
-    // Placeholder
-    std::vector<double> feedback;
+    const std::vector<tgSpringCableActuator*>& allCables = m_modelView.getAllCables();
     
-    const std::vector<tgSpringCableActuator*>& allCables = subject.find<tgSpringCableActuator> ("all ");
+    const std::size_t numStates = m_config.numStates;
+    const std::size_t numActions = m_config.numActions;
+    const std::size_t n = allCables.size();
+    // inputting 0 for now
+    const std::size_t n2 = m_highControllers.size();
+    if (n + n2 == 0)
+    {
+        return std::vector<double>();
+    }
     
-    double *inputs = new double[m_config.numStates];
+    m_nnInputs.assign((n + n2) * numStates, 0.0);
+    m_nnOutputs.resize((n + n2) * numActions);
     
-    std::size_t n = allCables.size();
     for(std::size_t i = 0; i != n; i++)
     {
-        std::vector< std::vector<double> > actions;
-        
         const tgSpringCableActuator& cable = *(allCables[i]);
         std::vector<double > state = getCableState(cable);
+        assert(state.size() <= numStates);
         
         // Rescale to 0 to 1 (consider doing this inside getState
-        for (std::size_t i = 0; i < state.size(); i++)
-        {
-            inputs[i]=state[i] / 2.0 + 0.5;
-        }
-        
-        double *output = nn->feedForwardPattern(inputs);
-        vector<double> tmpAct;
-        for(int j=0;j<m_config.numActions;j++)
+        for (std::size_t j = 0; j < state.size(); j++)
         {
-            tmpAct.push_back(output[j]);
+            m_nnInputs[i * numStates + j] = state[j] / 2.0 + 0.5;
         }
-        actions.push_back(tmpAct);
-
-        std::vector<double> cableFeedback = transformFeedbackActions(actions);
-        
-        feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
     }
-
-    // inputting 0 for now
-    std::size_t n2 = m_highControllers.size();
-    for (size_t i = 0; i != n2; i++)
+    
+    // Every cable and high level controller in one pass
+    nn->feedForward(&m_nnInputs[0], n + n2, &m_nnOutputs[0]);
+    
+    // Scale values back to -1 to +1
+    std::vector<double> feedback(m_nnOutputs.size());
+    for (std::size_t k = 0; k < feedback.size(); k++)
     {
-	std::vector< std::vector<double> > actions;
-		
-	// Rescale to 0 to 1 (consider doing this inside getState)
-	for (std::size_t i = 0; i < m_config.numStates; i++)
-	{
-	    inputs[i] = 0;
-	}
-		
-	double *output = nn->feedForwardPattern(inputs);
-	vector<double> tmpAct;
-	for(int j=0;j<m_config.numActions;j++)
-	{
-	    tmpAct.push_back(output[j]);
-	}
-	actions.push_back(tmpAct);
-
-	std::vector<double> cableFeedback = transformFeedbackActions(actions);
-		
-	feedback.insert(feedback.end(), cableFeedback.begin(), cableFeedback.end());
+        feedback[k] = m_nnOutputs[k] * 2.0 - 1.0;
     }
     
     return feedback;
@@ -1253,27 +1243,3 @@ std::vector<double> JSONHierarchyFeedbackControl::getCableState(const tgSpringCa
     
 	return state;
 }
-
-std::vector<double> JSONHierarchyFeedbackControl::transformFeedbackActions(std::vector< std::vector<double> >& actions)
-{
-	// Placeholder
-	std::vector<double> feedback;
-    
-    // Leave in place for generalization later
-    const std::size_t numControllers = 1;
-    const std::size_t numActions = m_config.numActions;
-    
-    assert( actions.size() == numControllers);
-    assert( actions[0].size() == numActions);
-    
-    // Scale values back to -1 to +1
-    for( std::size_t i = 0; i < numControllers; i++)
-    {
-        for( std::size_t j = 0; j < numActions; j++)
-        {
-            feedback.push_back(actions[i][j] * 2.0 - 1.0);
-        }
-    }
-    
-	return feedback;
-}
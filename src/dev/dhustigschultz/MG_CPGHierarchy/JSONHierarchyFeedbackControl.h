@@ -29,11 +29,12 @@
  */
 
 #include "dev/dhustigschultz/BP_SC_NoLegs_Stats/JSONQuadCPGControl.h"
+#include "dev/dhustigschultz/BigPuppy_SpineOnly_Stats/QuadModelView.h"
 
 #include <json/value.h>
 
 // Forward Declarations
-class neuralNetwork;
+class BatchedNeuralNetwork;
 class tgSpringCableActuator;
 
 
@@ -147,8 +148,6 @@ protected:
     
     std::vector<double> getCableState(const tgSpringCableActuator& cable);
     
-    std::vector<double> transformFeedbackActions(std::vector< std::vector<double> >& actions);
-    
     JSONHierarchyFeedbackControl::Config m_config;
 
     // @todo: doing separate vectors of controllers, until I can find a way to make them into a vector of vectors, without segfaulting.
@@ -172,10 +171,17 @@ protected:
     std::vector<tgCPGActuatorControl*> m_highControllers;
     
     // @todo generalize this if we need more than one
-    neuralNetwork* nn;
+    BatchedNeuralNetwork* nn;
+
+    // One row per cable, then one per high level controller
+    std::vector<double> m_nnInputs;
+    std::vector<double> m_nnOutputs;
 
     std::vector< std::vector<double> > m_quadCOM;
 
+    // Cables and segment masses of the current episode
+    QuadModelView m_modelView;
+
 };
 
 #endif // JSON_HIERARCHY_FEEDBACK_CONTROL_H
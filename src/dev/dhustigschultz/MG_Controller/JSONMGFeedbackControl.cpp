@@ -577,6 +577,7 @@ std::vector<double> JSONMGFeedbackControl::getFeedback(BaseQuadModelLearning& su
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -585,6 +586,7 @@ std::vector<double> JSONMGFeedbackControl::getFeedback(BaseQuadModelLearning& su
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -444,6 +444,7 @@ std::vector<double> JSONMGFeedbackControlFM1::getFeedback(BaseQuadModelLearning&
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -452,6 +453,7 @@ std::vector<double> JSONMGFeedbackControlFM1::getFeedback(BaseQuadModelLearning&
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
@@ -511,6 +511,7 @@ std::vector<double> JSONMixedLearningControl::getFeedback(BaseSpineModelLearning
         {
             tmpAct.push_back(output[j]);
         }
+        delete[] output;
         actions.push_back(tmpAct);
 
         std::vector<double> cableFeedback = transformFeedbackActions(actions);
@@ -519,6 +520,7 @@ std::vector<double> JSONMixedLearningControl::getFeedback(BaseSpineModelLearning
     }
     
     
+    delete[] inputs;
     return feedback;
 }
 
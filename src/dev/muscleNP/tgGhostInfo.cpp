@@ -67,41 +67,31 @@ tgRigidInfo* tgGhostInfo::createRigidInfo(const tgPair& pair)
 
 
 /// @todo This is the key class to override
-void tgGhostInfo::initRigidBody(tgWorld& world)
+void tgGhostInfo::createCollisionObject(tgWorld& world,
+                                        tgRigidInfo& group,
+                                        float mass,
+                                        const btTransform& transform,
+                                        btCollisionShape* shape,
+                                        const btVector3& localInertia)
 {
-	if(!getCollisionObject()) {
-
-		// we want to do this based on group instead the rigid itself; otherwise we throw away autocompounding.
-		tgRigidInfo* rigid = getRigidInfoGroup();
-
-		// If we're not using autocompounding, use the rigid body itself.
-		// NOTE: This means that auto-compounding can be silently skipped, which means that your parts may not be joined correctly. Do we want that?
-		if(rigid == 0) { 
-			rigid = this;
-		}
-
-		if (rigid->getCollisionObject() == NULL) // Init only if it doesn't have a btRigidBody (has already been initialized)
-		{ 
-		
-			btDynamicsWorld& m_dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(world);
-			
-			btTransform transform = rigid->getTransform();
-			btCollisionShape* shape = rigid->getCollisionShape(world);
-			
-			// Dynamics world will own this
-			btPairCachingGhostObject* ghostObject = new btPairCachingGhostObject();
+	btDynamicsWorld& m_dynamicsWorld = tgBulletUtil::worldToDynamicsWorld(world);
 	
-			ghostObject->setCollisionShape (shape);
-			ghostObject->setWorldTransform(transform);
-			ghostObject->setCollisionFlags (btCollisionObject::CF_NO_CONTACT_RESPONSE);
-			
-			// @todo look up what the second and third arguments of this are
-			m_dynamicsWorld.addCollisionObject(ghostObject,btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::StaticFilter|btBroadphaseProxy::DefaultFilter);
-			
-			rigid->setCollisionObject(ghostObject);
-		}
-
-	}
+	// Dynamics world will own this
+	btPairCachingGhostObject* ghostObject = new btPairCachingGhostObject();
+
+	ghostObject->setCollisionShape (shape);
+	ghostObject->setWorldTransform(transform);
+	ghostObject->setCollisionFlags (btCollisionObject::CF_NO_CONTACT_RESPONSE);
+	
+	// @todo look up what the second and third arguments of this are
+	m_dynamicsWorld.addCollisionObject(ghostObject,btBroadphaseProxy::CharacterFilter, btBroadphaseProxy::StaticFilter|btBroadphaseProxy::DefaultFilter);
+	
+	group.setCollisionObject(ghostObject);
+}
+
+void tgGhostInfo::finishRigidBody()
+{
+	// Ghosts have no friction or restitution, unlike boxes
 }
 
 tgModel* tgGhostInfo::createModel(tgWorld& world)
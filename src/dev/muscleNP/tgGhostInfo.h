@@ -102,7 +102,15 @@ public:
      */ 
     tgRigidInfo* createRigidInfo(const tgPair& pair);
 	
-    virtual void initRigidBody(tgWorld& world);
+    /** Makes a btPairCachingGhostObject instead of a btRigidBody */
+    virtual void createCollisionObject(tgWorld& world,
+                                       tgRigidInfo& group,
+                                       float mass,
+                                       const btTransform& transform,
+                                       btCollisionShape* shape,
+                                       const btVector3& localInertia);
+
+    virtual void finishRigidBody();
 
     virtual tgModel* createModel(tgWorld& world);
 
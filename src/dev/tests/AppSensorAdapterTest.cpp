@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppSensorAdapterTest.cpp
+ * @brief Checks the default adapters between tgSensor's numeric and
+ * string data methods
+ * $Id$
+ */
+
+// This library
+#include "core/tgSenseable.h"
+#include "sensors/tgSensor.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /** Two headings, shared by the sensors below */
+    std::vector<std::string> twoHeadings()
+    {
+        std::vector<std::string> headings;
+        headings.push_back("test().A");
+        headings.push_back("test().B");
+        return headings;
+    }
+
+    /** Overrides only sampleSensorData, like the sensors in this library */
+    class NumericSensor : public tgSensor
+    {
+    public:
+        NumericSensor(tgSenseable* pSens) : tgSensor(pSens) { }
+
+        virtual std::vector<std::string> getSensorDataHeadings()
+        {
+            return twoHeadings();
+        }
+
+        virtual void sampleSensorData(double* data)
+        {
+            data[0] = 1.5;
+            data[1] = -2.0;
+        }
+    };
+
+    /** Overrides only getSensorData, like sensors written before the split */
+    class StringSensor : public tgSensor
+    {
+    public:
+        StringSensor(tgSenseable* pSens) : tgSensor(pSens) { }
+
+        virtual std::vector<std::string> getSensorDataHeadings()
+        {
+            return twoHeadings();
+        }
+
+        virtual std::vector<std::string> getSensorData()
+        {
+            std::vector<std::string> data;
+            data.push_back("0.25");
+            data.push_back("3");
+            return data;
+        }
+    };
+
+    /** Overrides neither, so the defaults would call each other */
+    class EmptySensor : public tgSensor
+    {
+    public:
+        EmptySensor(tgSenseable* pSens) : tgSensor(pSens) { }
+
+        virtual std::vector<std::string> getSensorDataHeadings()
+        {
+            return twoHeadings();
+        }
+    };
+
+    /** @return true, or false after printing what failed */
+    bool check(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            std::cout << "FAILED: " << what << std::endl;
+        }
+        return condition;
+    }
+
+    /** @return true if both defaults throw std::logic_error */
+    bool throwsForEmptySensor(tgSensor& sensor)
+    {
+        bool ok = true;
+        try
+        {
+            sensor.getSensorData();
+            ok = check(false, "getSensorData on an empty sensor");
+        }
+        catch (const std::logic_error&)
+        {
+        }
+        try
+        {
+            double data[2];
+            sensor.sampleSensorData(data);
+            ok = check(false, "sampleSensorData on an empty sensor") && ok;
+        }
+        catch (const std::logic_error&)
+        {
+        }
+        return ok;
+    }
+}
+
+/**
+ * A sensor that only writes numbers must still give strings, a sensor
+ * that only gives strings must still write numbers, and a sensor that
+ * does neither must throw rather than recurse.
+ * @return 0 if every check passes
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppSensorAdapterTest" << std::endl;
+
+    tgSenseable senseable;
+    bool ok = true;
+
+    NumericSensor numeric(&senseable);
+    const std::vector<std::string> strings = numeric.getSensorData();
+    ok = check(numeric.getSensorDataWidth() == 2, "numeric sensor width") && ok;
+    ok = check(strings.size() == 2 && strings[0] == "1.5" && strings[1] == "-2",
+               "numeric sensor formatted as strings") && ok;
+
+    StringSensor text(&senseable);
+    double values[2] = { 0.0, 0.0 };
+    text.sampleSensorData(values);
+    ok = check(values[0] == 0.25 && values[1] == 3.0,
+               "string sensor parsed as numbers") && ok;
+
+    EmptySensor empty(&senseable);
+    ok = throwsForEmptySensor(empty) && ok;
+    // The guard must be released after the throw
+    ok = throwsForEmptySensor(empty) && ok;
+
+    std::cout << (ok ? "All sensor adapter checks passed" :
+                       "Sensor adapter checks failed") << std::endl;
+    return ok ? 0 : 1;
+}
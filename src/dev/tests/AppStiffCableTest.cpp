@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppStiffCableTest.cpp
+ * @brief Hangs a 1 kg rod from a cable with k = 1e7 N/m, with explicit
+ * and implicit batched cables
+ * $Id$
+ */
+
+// This application
+#include "HangingMassModel.h"
+// This library
+#include "core/tgBasicActuator.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// The C++ Standard Library
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const double gravity = 9.81;
+    const double stiffness = 1.0e7;
+    const double damping = 10.0;
+
+    /**
+     * Hang the mass for the given time and return the largest distance
+     * of the cable's length from its static length, k * x = m * g, or a
+     * negative value if the length stopped being finite
+     * @param[in] dt the world timestep
+     * @param[in] implicit tgWorld::Config::implicitCables
+     * @param[in] seconds simulated time
+     */
+    double hang(double dt, bool implicit, double seconds)
+    {
+        tgWorld::Config config(gravity);
+        config.batchCables = true;
+        config.implicitCables = implicit;
+        tgWorld world(config);
+
+        tgSimView view(world, dt);
+        tgSimulation simulation(view);
+
+        HangingMassModel* const myModel =
+            new HangingMassModel(stiffness, damping);
+        simulation.addModel(myModel);
+
+        const tgBasicActuator* const cable = myModel->cable();
+        const double staticLength = cable->getRestLength() +
+            myModel->hangingMass()->mass() * gravity / stiffness;
+
+        double result = 0.0;
+        const int steps = static_cast<int>(seconds / dt + 0.5);
+        for (int i = 0; i < steps; i++)
+        {
+            simulation.step(dt);
+            const double error =
+                std::fabs(cable->getCurrentLength() - staticLength);
+            // Also catches NaN
+            if (!(error < 1.0e6))
+            {
+                return -1.0;
+            }
+            result = error > result ? error : result;
+        }
+        return result;
+    }
+
+    /** @return true if the run stayed within tolerance */
+    bool report(const char* name, double dt, double error, double tolerance)
+    {
+        std::cout << name << " at dt " << dt << ": ";
+        if (error < 0.0)
+        {
+            std::cout << "unstable" << std::endl;
+            return false;
+        }
+        std::cout << "largest offset from static length " << error
+                  << std::endl;
+        return error < tolerance;
+    }
+}
+
+/**
+ * The cable's natural period is 2 ms, so explicit cables are unstable
+ * at a 1 ms timestep. Implicit cables should hold the mass within a
+ * millimeter of its static length at 1 ms and 5 ms.
+ * @return 0 if both implicit runs are stable
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppStiffCableTest" << std::endl;
+
+    const double seconds = 2.0;
+    const double tolerance = 0.001;
+
+    const double explicitError = hang(0.001, false, seconds);
+    const double implicitError = hang(0.001, true, seconds);
+    const double largeStepError = hang(0.005, true, seconds);
+
+    report("Explicit", 0.001, explicitError, tolerance);
+    const bool implicitStable =
+        report("Implicit", 0.001, implicitError, tolerance);
+    const bool largeStepStable =
+        report("Implicit", 0.005, largeStepError, tolerance);
+
+    return implicitStable && largeStepStable ? 0 : 1;
+}
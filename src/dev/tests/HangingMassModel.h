@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ *
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef HANGING_MASS_MODEL_H
+#define HANGING_MASS_MODEL_H
+
+/**
+ * @file HangingMassModel.h
+ * @brief A rod of about 1 kg hanging from a fixed rod by one cable
+ * $Id$
+ */
+
+#include "core/tgModel.h"
+#include "core/tgBasicActuator.h"
+#include "core/tgRod.h"
+#include "tgcreator/tgBuildSpec.h"
+#include "tgcreator/tgBasicActuatorInfo.h"
+#include "tgcreator/tgRodInfo.h"
+#include "tgcreator/tgStructure.h"
+#include "tgcreator/tgStructureInfo.h"
+
+#include <vector>
+
+/**
+ * A static rod from y = 3 to y = 4, and a rod hanging below it from
+ * y = 2 to y = 1, joined end to end by a single vertical cable with no
+ * pretension. Lengths are in meters, so use a gravity of 9.81.
+ */
+class HangingMassModel : public tgModel
+{
+public:
+
+    /**
+     * @param[in] stiffness of the cable
+     * @param[in] damping of the cable
+     */
+    HangingMassModel(double stiffness, double damping) :
+    tgModel(),
+    m_stiffness(stiffness),
+    m_damping(damping),
+    m_pCable(NULL),
+    m_pMass(NULL)
+    {
+    }
+
+    virtual ~HangingMassModel()
+    {
+    }
+
+    virtual void setup(tgWorld& world)
+    {
+        const double radius = 0.05;
+        // 1 kg over the rod's volume of pi * 0.05^2 * 1 m^3
+        const double density = 127.32395;
+        const tgRod::Config fixedConfig(radius, 0.0);
+        const tgRod::Config massConfig(radius, density);
+
+        // Anchor at the rod ends, the cable runs along the rods' axis
+        const tgBasicActuator::Config cableConfig(m_stiffness, m_damping,
+                                                  0.0, false, 1000.0, 100.0,
+                                                  0.1, 0.1, 0.0,
+                                                  false, false);
+
+        tgStructure s;
+        s.addNode(0, 4, 0);
+        s.addNode(0, 3, 0);
+        s.addNode(0, 2, 0);
+        s.addNode(0, 1, 0);
+        s.addPair(0, 1, "fixed");
+        s.addPair(2, 3, "mass");
+        s.addPair(1, 2, "cable");
+
+        tgBuildSpec spec;
+        spec.addBuilder("fixed", new tgRodInfo(fixedConfig));
+        spec.addBuilder("mass", new tgRodInfo(massConfig));
+        spec.addBuilder("cable", new tgBasicActuatorInfo(cableConfig));
+
+        tgStructureInfo structureInfo(s, spec);
+        structureInfo.buildInto(*this, world);
+
+        const std::vector<tgBasicActuator*> cables =
+            find<tgBasicActuator>("cable");
+        const std::vector<tgRod*> masses = find<tgRod>("mass");
+        m_pCable = cables.empty() ? NULL : cables[0];
+        m_pMass = masses.empty() ? NULL : masses[0];
+
+        tgModel::setup(world);
+    }
+
+    virtual void teardown()
+    {
+        m_pCable = NULL;
+        m_pMass = NULL;
+        tgModel::teardown();
+    }
+
+    /** The cable, or NULL before setup */
+    const tgBasicActuator* cable() const
+    {
+        return m_pCable;
+    }
+
+    /** The hanging rod, or NULL before setup */
+    const tgRod* hangingMass() const
+    {
+        return m_pMass;
+    }
+
+private:
+
+    const double m_stiffness;
+    const double m_damping;
+    tgBasicActuator* m_pCable;
+    tgRod* m_pMass;
+};
+
+#endif // HANGING_MASS_MODEL_H
@@ -348,7 +348,7 @@ std::vector<double> TetraSpineStaticModel_hf::getStringMaxTensions() const
         std::cout << i << " " << m_sca.getTags();
         
         tgSpringCableActuator::SpringCableActuatorHistory stringHist = m_sca.getHistory();
-        std::deque<double>& tensionHist = stringHist.tensionHistory;
+        const tgRingBuffer<double>& tensionHist = stringHist.tensionHistory;
         maxTens.push_back( *(std::max_element(tensionHist.begin(), tensionHist.end())) );
         
         std::cout <<" "<< tensionHist[5] << " " << maxTens[i] << std::endl;
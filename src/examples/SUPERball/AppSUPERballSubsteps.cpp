@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file AppSUPERballSubsteps.cpp
+ * @brief Checks tgWorld::Config::cableSubsteps against a smaller timestep
+ * by dropping SUPERball on flat ground
+ * $Id$
+ */
+
+// This application
+#include "T6Model.h"
+// This library
+#include "core/terrain/tgBoxGround.h"
+#include "core/tgRod.h"
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "core/tgWorld.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    /**
+     * Drop SUPERball from the height T6Model builds it at, without a
+     * controller, and return the centers of mass of its rods
+     * @param[in] dt the world timestep
+     * @param[in] substeps tgWorld::Config::cableSubsteps
+     * @param[in] seconds simulated time, long enough to land and settle
+     */
+    std::vector<btVector3> drop(double dt, int substeps, double seconds)
+    {
+        // Flat ground, so every rod makes contact
+        const tgBoxGround::Config groundConfig(btVector3(0.0, 0.0, 0.0));
+        // the world will delete this
+        tgBoxGround* ground = new tgBoxGround(groundConfig);
+
+        tgWorld::Config config(98.1); // gravity, dm/sec^2
+        config.batchCables = true;
+        config.cableSubsteps = substeps;
+        tgWorld world(config, ground);
+
+        tgSimView view(world, dt);
+        tgSimulation simulation(view);
+
+        T6Model* const myModel = new T6Model();
+        simulation.addModel(myModel);
+        simulation.run(static_cast<int>(seconds / dt + 0.5));
+
+        std::vector<btVector3> result;
+        const std::vector<tgRod*> rods = myModel->find<tgRod>("rod");
+        for (std::size_t i = 0; i < rods.size(); i++)
+        {
+            result.push_back(rods[i]->centerOfMass());
+        }
+        return result;
+    }
+
+    /** The largest distance between corresponding rods */
+    double maxDistance(const std::vector<btVector3>& a,
+                       const std::vector<btVector3>& b)
+    {
+        double result = 0.0;
+        for (std::size_t i = 0; i < a.size() && i < b.size(); i++)
+        {
+            const double d = a[i].distance(b[i]);
+            result = d > result ? d : result;
+        }
+        return result;
+    }
+}
+
+/**
+ * Drops SUPERball three times: at a small reference timestep, at a
+ * timestep substeps times larger, and at the larger timestep split into
+ * cable substeps. The substepped run should stay with the reference
+ * through the impact, the plain large step should not.
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1] is the number of substeps, 4 by default
+ * @return 0 if the substepped run matches the reference
+ */
+int main(int argc, char** argv)
+{
+    std::cout << "AppSUPERballSubsteps" << std::endl;
+
+    const int substeps = argc > 1 ? std::atoi(argv[1]) : 4;
+    if (substeps < 1)
+    {
+        std::cerr << "Substeps must be positive" << std::endl;
+        return 1;
+    }
+
+    const double dt = 0.001 * substeps;
+    const double seconds = 3.0;
+    // Rods are 16.84 dm long, so this is within a few millimeters
+    const double tolerance = 0.05;
+
+    const std::vector<btVector3> reference = drop(dt / substeps, 1, seconds);
+    const std::vector<btVector3> plain = drop(dt, 1, seconds);
+    const std::vector<btVector3> substepped = drop(dt, substeps, seconds);
+
+    const double plainError = maxDistance(plain, reference);
+    const double substepError = maxDistance(substepped, reference);
+
+    std::cout << "dt " << dt << " with " << substeps << " cable substeps"
+              << " against dt " << dt / substeps << std::endl;
+    std::cout << "Largest rod offset without substeps: " << plainError
+              << std::endl;
+    std::cout << "Largest rod offset with substeps: " << substepError
+              << std::endl;
+
+    return substepError < tolerance ? 0 : 1;
+}
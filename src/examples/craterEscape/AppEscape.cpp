@@ -26,6 +26,7 @@
 // This application
 #include "EscapeModel.h"
 #include "EscapeController.h"
+#include "EscapeTrialWorker.h"
 
 // This library
 #include "core/terrain/tgBoxGround.h"
@@ -35,18 +36,47 @@
 #include "core/tgSimViewGraphics.h"
 #include "core/tgSimulation.h"
 #include "core/tgWorld.h"
+#include "learning/AnnealEvolution/AnnealEvolution.h"
+#include "learning/Parallel/ProcessTrialFarm.h"
 
 // Bullet Physics
 #include "LinearMath/btVector3.h"
 
 // The C++ Standard Library
+#include <cstdlib>
 #include <iostream>
 
+tgBoxGround::Config createGroundConfig();
 tgBoxGround *createGround();
+tgWorld::Config createWorldConfig();
 tgWorld *createWorld();
 tgSimViewGraphics *createGraphicsView(tgWorld *world);
 tgSimView *createView(tgWorld *world);
 void simulate(tgSimulation *simulation);
+void learn(const std::string& suffix, std::size_t nProcesses, int nGenerations);
+
+/** Gives each worker process its own EscapeTrialWorker */
+class EscapeTrialWorkerFactory : public TrialWorkerFactory<AnnealEvoMember>
+{
+public:
+    EscapeTrialWorkerFactory(double stepSize, int nSteps, double initialLength) :
+    m_stepSize(stepSize),
+    m_nSteps(nSteps),
+    m_initialLength(initialLength)
+    {
+    }
+
+    virtual TrialWorker<AnnealEvoMember>* createWorker(std::size_t index)
+    {
+        return new EscapeTrialWorker(createWorldConfig(), createGroundConfig(),
+                                     m_stepSize, m_nSteps, m_initialLength);
+    }
+
+private:
+    const double m_stepSize;
+    const int m_nSteps;
+    const double m_initialLength;
+};
 
 /**
  * Runs a series of episodes. 
@@ -55,11 +85,23 @@ void simulate(tgSimulation *simulation);
  *     the maximum distance from the tensegrity's starting point 
  *     at any point during the episode
  * NB: Running episodes and using graphics are mutually exclusive features
+ * @param[in] argc the number of command-line arguments
+ * @param[in] argv argv[1], if supplied, is the suffix for the controller;
+ * argv[2], if supplied, is a number of worker processes to learn with
+ * instead of running a single episode, and argv[3] the number of
+ * generations to learn for (1 by default)
  */
 int main(int argc, char** argv)
 {
     std::cout << "AppEscapeCrater" << std::endl;
 
+    const int nProcesses = (argc > 2) ? std::atoi(argv[2]) : 0;
+    if (nProcesses > 0) {
+        const int nGenerations = (argc > 3) ? std::atoi(argv[3]) : 1;
+        learn((argc > 1) ? argv[1] : "default", nProcesses, nGenerations);
+        return 0;
+    }
+
     // First create the world
     tgWorld *world = createWorld();
 
@@ -102,7 +144,7 @@ int main(int argc, char** argv)
     return 0;
 }
 
-tgBoxGround *createGround() {
+tgBoxGround::Config createGroundConfig() {
     // Determine the angle of the ground in radians. All 0 is flat
     const double yaw = 0.0;
     const double pitch = 0.0;
@@ -112,19 +154,24 @@ tgBoxGround *createGround() {
     const double restitution = 0.0;  // Default: 0.0
     const btVector3 size = btVector3(10000.0, 2, 10000.0); // Default: (500.0, 1.5, 500.0)
     const btVector3 origin = btVector3(0.0, 0.0, 0.0); // Default: (0.0, 0.0, 0.0)
-    const tgBoxGround::Config groundConfig(eulerAngles, friction, restitution,
-                                           size, origin);
+    return tgBoxGround::Config(eulerAngles, friction, restitution,
+                               size, origin);
+}
+
+tgBoxGround *createGround() {
     // the world will delete this
-    return new tgBoxGround(groundConfig);
+    return new tgBoxGround(createGroundConfig());
 }
 
-tgWorld *createWorld() {
-    const tgWorld::Config config(98.1); // gravity, cm/sec^2  Use this to adjust length scale of world.
+tgWorld::Config createWorldConfig() {
     // NB: by changing the setting below from 981 to 98.1, we've
     // scaled the world length scale to decimeters not cm.
+    return tgWorld::Config(98.1); // gravity, cm/sec^2  Use this to adjust length scale of world.
+}
 
+tgWorld *createWorld() {
     tgBoxGround* ground = createGround();
-    return new tgWorld(config, ground);
+    return new tgWorld(createWorldConfig(), ground);
 }
 
 /** Use for displaying tensegrities in simulation */
@@ -151,3 +198,21 @@ void simulate(tgSimulation *simulation) {
     }
 }
 
+/**
+ * Evolve the controller with AnnealEvolution, running each generation's
+ * episodes in worker processes. Each worker builds its own world, so
+ * no graphics are shown.
+ */
+void learn(const std::string& suffix, std::size_t nProcesses, int nGenerations) {
+    const double timestep_physics = 1.0 / 60.0 / 10.0; // Seconds, as in createView
+    const int nSteps = 60000; // As in simulate
+    const double initialLength = 9.0; // decimeters, as in main
+
+    AnnealEvolution evolution(suffix, "Config.ini", "craterEscape/");
+    EscapeTrialWorkerFactory factory(timestep_physics, nSteps, initialLength);
+    ProcessTrialFarm<AnnealEvolution> farm(evolution, factory, nProcesses);
+
+    for (int i=0; i<nGenerations; i++) {
+        farm.evaluateGeneration();
+    }
+}
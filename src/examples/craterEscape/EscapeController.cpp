@@ -54,6 +54,7 @@ EscapeController::EscapeController(const double initialLength,
     m_initialLengths(initialLength),
     m_totalTime(0.0),
     maxStringLengthFactor(0.50),
+    fixedActions(false),
     nClusters(8),
     musclesPerCluster(3),
     suffix(args),
@@ -82,13 +83,18 @@ void EscapeController::onSetup(EscapeModel& subject)
 
     populateClusters(subject);
     initPosition = subject.getBallCOM();
-    setupAdapter();
     initializeSineWaves(); // For muscle actuation
 
-    std::vector<double> state; // For config file usage (including Monte Carlo simulations)
+    if (fixedActions) {
+        actions = givenActions;
+    } else {
+        setupAdapter();
+
+        std::vector<double> state; // For config file usage (including Monte Carlo simulations)
 
-    //get the actions (between 0 and 1) from evolution (todo)
-    actions = evolutionAdapter.step(dt,state);
+        //get the actions (between 0 and 1) from evolution (todo)
+        actions = evolutionAdapter.step(dt,state);
+    }
  
     //transform them to the size of the structure
     actions = transformActions(actions);
@@ -119,7 +125,7 @@ void EscapeController::onStep(EscapeModel& subject, double dt)
 // So far, only score used for eventual fitness calculation of an Escape Model
 // is the maximum distance from the origin reached during that subject's episode
 void EscapeController::onTeardown(EscapeModel& subject) {
-    std::vector<double> scores; //scores[0] == displacement, scores[1] == energySpent
+    scores.clear(); //scores[0] == displacement, scores[1] == energySpent
     double distance = displacement(subject);
     double energySpent = totalEnergySpent(subject);
 
@@ -128,11 +134,21 @@ void EscapeController::onTeardown(EscapeModel& subject) {
     scores.push_back(energySpent);
 
     std::cout << "Tearing down" << std::endl;
-    evolutionAdapter.endEpisode(scores);
+    if (!fixedActions) {
+        evolutionAdapter.endEpisode(scores);
+    }
 
     // If any of subject's dynamic objects need to be freed, this is the place to do so
 }
 
+void EscapeController::setActions(const std::vector< std::vector<double> >& act) {
+    if (act.size() != (std::size_t) nClusters) {
+        throw std::invalid_argument("Need one set of actions per cluster");
+    }
+    givenActions = act;
+    fixedActions = true;
+}
+
 /** 
  * Returns the modified actions 2D vector such that 
  *   each action value is now scaled to fit the model
@@ -57,6 +57,19 @@ class EscapeController : public tgObserver<EscapeModel>
 
         virtual void onTeardown(EscapeModel& subject);
 
+        /**
+         * Use these actions, one vector of four values between 0 and 1
+         * per cluster, instead of asking AnnealEvolution. Scores are
+         * then kept for getScores() instead of being reported.
+         */
+        void setActions(const std::vector< std::vector<double> >& act);
+
+        /** Distance and energy spent in the last episode */
+        const std::vector<double>& getScores() const
+        {
+            return scores;
+        }
+
     protected:
         virtual std::vector< std::vector <double> > transformActions(std::vector< std::vector <double> > act);
 
@@ -71,6 +84,9 @@ class EscapeController : public tgObserver<EscapeModel>
         // Evolution and Adapter
         AnnealAdapter evolutionAdapter;
         std::vector< std::vector<double> > actions; // For modifications between episodes
+        bool fixedActions; // Set by setActions
+        std::vector< std::vector<double> > givenActions;
+        std::vector<double> scores;
 
         // Muscle Clusters
         int nClusters;
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file EscapeTrialWorker.cpp
+ * @brief Contains the implementation of class EscapeTrialWorker.
+ * $Id$
+ */
+
+// This module
+#include "EscapeTrialWorker.h"
+// This application
+#include "EscapeController.h"
+#include "EscapeModel.h"
+// This library
+#include "core/tgSimView.h"
+#include "core/tgSimulation.h"
+#include "models/obstacles/tgCraterDeep.h"
+// Bullet Physics
+#include "LinearMath/btVector3.h"
+
+EscapeTrialWorker::EscapeTrialWorker(const tgWorld::Config& worldConfig,
+                                     const tgBoxGround::Config& groundConfig,
+                                     double stepSize,
+                                     int nSteps,
+                                     double initialLength) :
+m_worldConfig(worldConfig),
+m_groundConfig(groundConfig),
+m_stepSize(stepSize),
+m_nSteps(nSteps),
+m_initialLength(initialLength)
+{
+}
+
+std::vector<double>
+EscapeTrialWorker::runTrial(const std::vector<AnnealEvoMember*>& controllers,
+                            unsigned long long seed)
+{
+    // One member per cluster, as AnnealAdapter::step hands them out
+    std::vector< std::vector<double> > actions;
+    for (std::size_t i = 0; i < controllers.size(); i++)
+    {
+        actions.push_back(controllers[i]->statelessParameters);
+    }
+
+    // Must outlive the simulation, which scores it on teardown
+    EscapeController controller(m_initialLength);
+    controller.setActions(actions);
+    {
+        // the world will delete this
+        tgBoxGround* ground = new tgBoxGround(m_groundConfig);
+        tgWorld world(m_worldConfig, ground);
+        tgSimView view(world, m_stepSize);
+        tgSimulation simulation(view);
+
+        EscapeModel* const model = new EscapeModel();
+        model->attach(&controller);
+        simulation.addModel(model);
+        simulation.addModel(new tgCraterDeep(btVector3(0, 0, 0)));
+
+        simulation.run(m_nSteps);
+    }
+    return controller.getScores();
+}
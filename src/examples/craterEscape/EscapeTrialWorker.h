@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef ESCAPE_TRIAL_WORKER_H
+#define ESCAPE_TRIAL_WORKER_H
+
+/**
+ * @file EscapeTrialWorker.h
+ * @brief Contains the definition of class EscapeTrialWorker.
+ * $Id$
+ */
+
+// This library
+#include "core/tgWorld.h"
+#include "core/terrain/tgBoxGround.h"
+#include "learning/AnnealEvolution/AnnealEvoMember.h"
+#include "learning/Parallel/TrialWorker.h"
+// The C++ Standard Library
+#include <vector>
+
+/**
+ * Runs one episode of AppEscape for a set of AnnealEvolution members:
+ * a fresh world with the deep crater, an EscapeModel and an
+ * EscapeController that takes its actions from the members.
+ */
+class EscapeTrialWorker : public TrialWorker<AnnealEvoMember>
+{
+public:
+
+    /**
+     * @param[in] worldConfig the world of every trial
+     * @param[in] groundConfig the ground of every trial
+     * @param[in] stepSize the physics timestep, in seconds
+     * @param[in] nSteps steps per trial
+     * @param[in] initialLength the muscles' initial length
+     */
+    EscapeTrialWorker(const tgWorld::Config& worldConfig,
+                      const tgBoxGround::Config& groundConfig,
+                      double stepSize,
+                      int nSteps,
+                      double initialLength);
+
+    /**
+     * Nothing in the episode is random, so the seed is not used
+     * @return the distance and energy spent, as the controller would
+     * report them to the adapter
+     */
+    virtual std::vector<double> runTrial(const std::vector<AnnealEvoMember*>& controllers,
+                                         unsigned long long seed);
+
+private:
+    const tgWorld::Config m_worldConfig;
+    const tgBoxGround::Config m_groundConfig;
+    const double m_stepSize;
+    const int m_nSteps;
+    const double m_initialLength;
+};
+
+#endif // ESCAPE_TRIAL_WORKER_H
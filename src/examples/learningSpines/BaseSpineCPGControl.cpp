@@ -26,6 +26,7 @@
 
 #include "BaseSpineCPGControl.h"
 
+#include <stdexcept>
 #include <string>
 
 
@@ -43,6 +44,7 @@
 
 #include "util/CPGEquations.h"
 #include "util/CPGNode.h"
+#include "core/tgSnapshot.h"
 
 //#define LOGGING
 
@@ -310,20 +312,10 @@ void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
     
     for(int i=0; i<tmpStrings.size(); i++)
     {
-        tgSpringCableActuator::SpringCableActuatorHistory stringHist = tmpStrings[i]->getHistory();
-        
-        for(int j=1; j<stringHist.tensionHistory.size(); j++)
-        {
-            const double previousTension = stringHist.tensionHistory[j-1];
-            const double previousLength = stringHist.restLengths[j-1];
-            const double currentLength = stringHist.restLengths[j];
-            //TODO: examine this assumption - free spinning motor may require more power
-            double motorSpeed = (currentLength-previousLength);
-            if(motorSpeed > 0) // Vestigial code
-                motorSpeed = 0;
-            const double workDone = previousTension * motorSpeed;
-            totalEnergySpent += workDone;
-        }
+        // Accumulated every step by the actuator, so this does not depend
+        // on the history capacity or decimation
+        //TODO: examine this assumption - free spinning motor may require more power
+        totalEnergySpent += tmpStrings[i]->getHistory().energySpent;
     }
     
     scores.push_back(totalEnergySpent);
@@ -341,6 +333,47 @@ void BaseSpineCPGControl::onTeardown(BaseSpineModelLearning& subject)
 	m_allControllers.clear();
 }
 
+void BaseSpineCPGControl::onSaveState(BaseSpineModelLearning& subject,
+                                      tgSnapshot& snapshot)
+{
+    snapshot.write(m_updateTime);
+    
+    if (m_pCPGSys == NULL)
+    {
+        snapshot.write(0.0);
+        return;
+    }
+    
+    const std::vector<double>& xVars = m_pCPGSys->getXVars();
+    snapshot.write(xVars.size());
+    for (std::size_t i = 0; i < xVars.size(); i++)
+    {
+        snapshot.write(xVars[i]);
+    }
+}
+
+void BaseSpineCPGControl::onRestoreState(BaseSpineModelLearning& subject,
+                                         tgSnapshot& snapshot)
+{
+    m_updateTime = snapshot.read();
+    
+    const std::size_t n = static_cast<std::size_t>(snapshot.read());
+    const std::size_t expected = (m_pCPGSys == NULL) ? 0 : m_pCPGSys->getXVars().size();
+    if (n != expected)
+    {
+        throw std::runtime_error("Snapshot has a different number of CPG variables");
+    }
+    else if (n > 0)
+    {
+        std::vector<double> xVars(n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            xVars[i] = snapshot.read();
+        }
+        m_pCPGSys->updateNodeData(xVars);
+    }
+}
+
 const double BaseSpineCPGControl::getCPGValue(std::size_t i) const
 {
 	// Error handling on input done in CPG_Equations
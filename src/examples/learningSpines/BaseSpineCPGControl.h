@@ -125,6 +125,11 @@ struct Config
     virtual void onSetup(BaseSpineModelLearning& subject);
     
     virtual void onTeardown(BaseSpineModelLearning& subject);
+    
+    /** Saves the control timer and the CPG's integrator state */
+    virtual void onSaveState(BaseSpineModelLearning& subject, tgSnapshot& snapshot);
+    
+    virtual void onRestoreState(BaseSpineModelLearning& subject, tgSnapshot& snapshot);
 
 	const double getCPGValue(std::size_t i) const;
 	
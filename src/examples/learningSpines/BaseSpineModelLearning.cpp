@@ -68,6 +68,20 @@ void BaseSpineModelLearning::teardown()
     m_muscleMap.clear();
 }
 
+void BaseSpineModelLearning::saveState(tgSnapshot& snapshot)
+{
+    notifySaveState(snapshot);
+    
+    tgModel::saveState(snapshot);
+}
+
+void BaseSpineModelLearning::restoreState(tgSnapshot& snapshot)
+{
+    notifyRestoreState(snapshot);
+    
+    tgModel::restoreState(snapshot);
+}
+
 void BaseSpineModelLearning::step(double dt)
 {
     /* CPG update occurs in the controller so that we can decouple it
@@ -60,6 +60,11 @@ public:
         
     virtual void step(double dt);
     
+    /** Lets the controllers save their state, then saves the children */
+    virtual void saveState(tgSnapshot& snapshot);
+    
+    virtual void restoreState(tgSnapshot& snapshot);
+    
     virtual std::vector<double> getSegmentCOM(const int n) const;
     
     virtual btVector3 getSegmentCOMVector(const int n) const;
@@ -34,6 +34,7 @@
 #include "controllers/tgImpedanceController.h"
 #include "util/CPGEquations.h"
 #include "core/tgCast.h"
+#include "core/tgSnapshot.h"
 
 // The C++ Standard Library
 #include <iostream>
@@ -99,6 +100,22 @@ void tgCPGActuatorControl::onStep(tgSpringCableActuator& subject, double dt)
 	}
 }
 
+void tgCPGActuatorControl::onSaveState(tgSpringCableActuator& subject,
+                                       tgSnapshot& snapshot)
+{
+    snapshot.write(m_controlTime);
+    snapshot.write(m_totalTime);
+    snapshot.write(m_commandedTension);
+}
+
+void tgCPGActuatorControl::onRestoreState(tgSpringCableActuator& subject,
+                                          tgSnapshot& snapshot)
+{
+    m_controlTime = snapshot.read();
+    m_totalTime = snapshot.read();
+    m_commandedTension = snapshot.read();
+}
+
 void tgCPGActuatorControl::assignNodeNumber (CPGEquations& CPGSys, array_2D nodeParams)
 {
     // Ensure that this hasn't already been assigned
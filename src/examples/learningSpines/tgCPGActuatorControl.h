@@ -53,6 +53,11 @@ public:
     virtual void onAttach(tgSpringCableActuator& subject);
     
     virtual void onStep(tgSpringCableActuator& subject, double dt);
+    
+    /** Saves the control timers and the last commanded tension */
+    virtual void onSaveState(tgSpringCableActuator& subject, tgSnapshot& snapshot);
+    
+    virtual void onRestoreState(tgSpringCableActuator& subject, tgSnapshot& snapshot);
 	
 	/**
      * Can call these any time, but they'll only have the intended effect
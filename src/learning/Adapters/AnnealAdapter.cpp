@@ -93,14 +93,14 @@ void AnnealAdapter::endEpisode(vector<double> scores)
     {
         vector< double > tmp(1);
         tmp[0]=-1;
-        annealEvo->updateScores(tmp);
+        annealEvo->updateScores(currentControllers, tmp);
         cout<<"Exploded"<<endl;
     }
     else
     {
         cout<<"Dist Moved: "<<scores[0]<<" energy: "<<scores[1]<<endl;
 //      double combinedScore=scores[0]*1.0-scores[1]*1.0;
-        annealEvo->updateScores(scores);
+        annealEvo->updateScores(currentControllers, scores);
     }
     return;
 }
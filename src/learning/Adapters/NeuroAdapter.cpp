@@ -93,6 +93,7 @@ vector<vector<double> > NeuroAdapter::step(double deltaTimeSeconds,vector<double
 			{
 				tmpAct.push_back(output[j]);
 			}
+			delete[] output;
 			actions.push_back(tmpAct);
 		}
 		delete[]inputs;
@@ -120,14 +121,14 @@ void NeuroAdapter::endEpisode(vector<double> scores)
 	{
 		vector< double > tmp(1);
 		tmp[0]=-1;
-		neuroEvo->updateScores(tmp);
+		neuroEvo->updateScores(currentControllers, tmp);
 		cout<<"Exploded"<<endl;
 	}
 	else
 	{
 		cout<<"Dist Moved: "<<scores[0]<<" energy: "<<scores[1]<<endl;
 //		double combinedScore=scores[0]*1.0-scores[1]*1.0;
-		neuroEvo->updateScores(scores);
+		neuroEvo->updateScores(currentControllers, scores);
 	}
 	return;
 }
@@ -28,6 +28,7 @@
 #include "AnnealEvoMember.h"
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <assert.h>
 #include <stdexcept>
 
@@ -96,6 +97,8 @@ void AnnealEvoMember::saveToFile(const char * outputFilename)
 {
 
     ofstream ss(outputFilename);
+    // Enough digits to read back exactly the same doubles
+    ss.precision(numeric_limits<double>::digits10 + 2);
     for(std::size_t i=0;i<statelessParameters.size();i++)
     {
         ss<<statelessParameters[i];
@@ -29,6 +29,8 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "learning/Parallel/TrialSeed.h"
+#include <cstdlib>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -58,6 +60,7 @@ suffix(suff),
 Temp(1.0)
 {
     currentTest=0;
+    trialCount=0;
     subTests = 0;
     generationNumber=0;
 	
@@ -84,9 +87,22 @@ Temp(1.0)
     seeded = myconfigdataaa.getintvalue("startSeed");
     
     bool learning = myconfigdataaa.getintvalue("learning");
+    
+    // A fixed master seed makes the run reproducible, otherwise pick one
+    // and report it so the run can be repeated
+    if (myconfigdataaa.iskey("masterSeed"))
+    {
+        masterSeed = strtoull(myconfigdataaa.data["masterSeed"].c_str(), NULL, 10);
+    }
+    else
+    {
+        masterSeed = rdtsc();
+    }
+    cout << "masterSeed=" << masterSeed << endl;
+    evoConfig = myconfigdataaa;
 
-    srand(rdtsc());
-    eng.seed(rdtsc());
+    srand(deriveTrialSeed(masterSeed, 0));
+    eng.seed(deriveTrialSeed(masterSeed, 1));
 
     for(int j=0;j<numberOfControllers;j++)
     {
@@ -184,13 +200,17 @@ double diffclock(clock_t clock1,clock_t clock2)
 }
 #endif
 
-vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
+int AnnealEvolution::testsPerGeneration() const
 {
-    int testsToDo=0;
     if(coevolution)
-        testsToDo=numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
+        return numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
     else
-        testsToDo=populationSize; //stop when we test each element once
+        return populationSize; //stop when we test each element once
+}
+
+vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
+{
+    const int testsToDo = testsPerGeneration();
 
     if(currentTest == testsToDo)
     {
@@ -219,6 +239,7 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
         selectedControllers.push_back(populations.at(i)->getMember(selectedOne));
     }
     
+    trialCount++;
     subTests++;
     
     if (subTests == numberOfSubtests)
@@ -231,7 +252,32 @@ vector <AnnealEvoMember *> AnnealEvolution::nextSetOfControllers()
     return selectedControllers;
 }
 
+vector< vector <AnnealEvoMember *> > AnnealEvolution::nextGenerationOfControllers()
+{
+    vector< vector <AnnealEvoMember *> > generation;
+    // The first call rolls over to a new generation if the last one is done
+    do
+    {
+        generation.push_back(nextSetOfControllers());
+    }
+    while (currentTest < testsPerGeneration());
+
+    return generation;
+}
+
+unsigned long long AnnealEvolution::getTrialSeed(std::size_t i) const
+{
+    // Offset past the seeds used for srand and eng in the constructor
+    return deriveTrialSeed(masterSeed, i + 2);
+}
+
 void AnnealEvolution::updateScores(vector <double> multiscore)
+{
+    updateScores(selectedControllers, multiscore);
+}
+
+void AnnealEvolution::updateScores(const vector <AnnealEvoMember *>& controllers,
+                                    vector <double> multiscore)
 {
     if(multiscore.size()==2)
         this->scoresOfTheGeneration.push_back(multiscore);
@@ -244,9 +290,9 @@ void AnnealEvolution::updateScores(vector <double> multiscore)
     payloadLog.open((resourcePath + "logs/scores.csv").c_str(),ios::app);
     payloadLog<<multiscore[0]<<","<<multiscore[1];
     
-    for(std::size_t oneElem=0;oneElem<selectedControllers.size();oneElem++)
+    for(std::size_t oneElem=0;oneElem<controllers.size();oneElem++)
     {
-        AnnealEvoMember * controllerPointer=selectedControllers.at(oneElem);
+        AnnealEvoMember * controllerPointer=controllers.at(oneElem);
 
         controllerPointer->pastScores.push_back(score);
         double prevScore=controllerPointer->maxScore;
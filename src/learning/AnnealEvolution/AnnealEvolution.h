@@ -36,18 +36,63 @@
 class AnnealEvolution
 {
 public:
+    /** The type of member handed out to controllers and trial workers */
+    typedef AnnealEvoMember member_type;
+
     AnnealEvolution(std::string suffix, std::string config = "config.ini", std::string path = "");
     ~AnnealEvolution();
     void mutateEveryController();
     void orderAllPopulations();
     void evaluatePopulation();
     std::vector< AnnealEvoMember *> nextSetOfControllers();
+    /**
+     * Returns every trial remaining in the current generation, in the
+     * order nextSetOfControllers() would have handed them out. If the
+     * previous generation is complete the populations are ordered and
+     * mutated first, so all of its scores must already be in.
+     * Members may repeat across trials (subtests, coevolution)
+     */
+    std::vector< std::vector< AnnealEvoMember *> > nextGenerationOfControllers();
     void updateScores(std::vector<double> scores);
+    /**
+     * Score an explicit set of controllers rather than the last set
+     * returned by nextSetOfControllers(). Used when several trials
+     * are in flight at once.
+     */
+    void updateScores(const std::vector< AnnealEvoMember *>& controllers,
+                        std::vector<double> scores);
+    /**
+     * Seed for trial number i, derived from the master seed. Trials are
+     * numbered in the order nextSetOfControllers() hands them out, so
+     * a run with a fixed masterSeed is reproducible trial by trial
+     * however the trials are distributed.
+     */
+    unsigned long long getTrialSeed(std::size_t i) const;
+    /** The number of trials handed out so far */
+    std::size_t getTrialCount() const
+    {
+        return trialCount;
+    }
+    unsigned long long getMasterSeed() const
+    {
+        return masterSeed;
+    }
+    /** The configuration the members were built from */
+    const configuration& getConfig() const
+    {
+        return evoConfig;
+    }
     const std::string suffix;
     /// @todo make this const if we decide to force everyone to put their logs in resources
     std::string resourcePath;
     
 private:
+    int testsPerGeneration() const;
+
+    configuration evoConfig;
+    unsigned long long masterSeed;
+    std::size_t trialCount;
+
     int populationSize;
     int numberOfControllers;
     std::tr1::ranlux64_base_01 eng;
@@ -0,0 +1,169 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file BatchedNeuralNetwork.cpp
+ * @brief Implementation of BatchedNeuralNetwork
+ * $Id$
+ */
+
+#include "BatchedNeuralNetwork.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    /**
+     * Rows evaluated together. Their hidden activations stay in L1 while
+     * the hidden to output weights are applied to them.
+     */
+    const std::size_t blockRows = 32;
+
+    /** neuralNetwork's bias neurons */
+    const double bias = -1.0;
+
+    inline double sigmoid(double x)
+    {
+        return 1.0 / (1.0 + std::exp(-x));
+    }
+}
+
+BatchedNeuralNetwork::BatchedNeuralNetwork(std::size_t numInputs,
+                                           std::size_t numHidden,
+                                           std::size_t numOutputs) :
+m_numInputs(numInputs),
+m_numHidden(numHidden),
+m_numOutputs(numOutputs),
+m_inputHidden((numInputs + 1) * numHidden, 0.0),
+m_hiddenOutput((numHidden + 1) * numOutputs, 0.0)
+{
+    if (numInputs == 0 || numHidden == 0 || numOutputs == 0)
+    {
+        throw std::invalid_argument("Every layer needs at least one neuron");
+    }
+}
+
+void BatchedNeuralNetwork::loadWeights(const std::string& filename)
+{
+    std::ifstream file(filename.c_str());
+    if (!file)
+    {
+        throw std::runtime_error("Could not open " + filename);
+    }
+
+    std::vector<double> weights;
+    std::string token;
+    while (std::getline(file, token, ','))
+    {
+        // A token may span a line break
+        std::istringstream values(token);
+        double w;
+        while (values >> w)
+        {
+            weights.push_back(w);
+        }
+    }
+
+    try
+    {
+        setWeights(weights);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+void BatchedNeuralNetwork::setWeights(const std::vector<double>& weights)
+{
+    if (weights.size() != m_inputHidden.size() + m_hiddenOutput.size())
+    {
+        throw std::invalid_argument("Wrong number of weights for the network");
+    }
+    std::copy(weights.begin(), weights.begin() + m_inputHidden.size(),
+              m_inputHidden.begin());
+    std::copy(weights.begin() + m_inputHidden.size(), weights.end(),
+              m_hiddenOutput.begin());
+}
+
+void BatchedNeuralNetwork::feedForward(const double* inputs,
+                                       std::size_t batchSize,
+                                       double* outputs)
+{
+    for (std::size_t row = 0; row < batchSize; row += blockRows)
+    {
+        const std::size_t rows = std::min(blockRows, batchSize - row);
+        feedForwardBlock(inputs + row * m_numInputs, rows,
+                         outputs + row * m_numOutputs);
+    }
+}
+
+void BatchedNeuralNetwork::feedForwardBlock(const double* inputs,
+                                            std::size_t rows,
+                                            double* outputs)
+{
+    m_hidden.resize(blockRows * m_numHidden);
+
+    // The innermost loops run along contiguous weight rows and
+    // accumulators, so the compiler can vectorize them
+    for (std::size_t r = 0; r < rows; r++)
+    {
+        const double* const in = inputs + r * m_numInputs;
+        double* const hidden = &m_hidden[r * m_numHidden];
+        std::fill(hidden, hidden + m_numHidden, 0.0);
+        for (std::size_t i = 0; i < m_numInputs; i++)
+        {
+            const double x = in[i];
+            const double* const w = &m_inputHidden[i * m_numHidden];
+            for (std::size_t j = 0; j < m_numHidden; j++)
+            {
+                hidden[j] += x * w[j];
+            }
+        }
+        const double* const wBias = &m_inputHidden[m_numInputs * m_numHidden];
+        for (std::size_t j = 0; j < m_numHidden; j++)
+        {
+            hidden[j] = sigmoid(hidden[j] + bias * wBias[j]);
+        }
+    }
+
+    for (std::size_t r = 0; r < rows; r++)
+    {
+        const double* const hidden = &m_hidden[r * m_numHidden];
+        double* const out = outputs + r * m_numOutputs;
+        std::fill(out, out + m_numOutputs, 0.0);
+        for (std::size_t j = 0; j < m_numHidden; j++)
+        {
+            const double h = hidden[j];
+            const double* const w = &m_hiddenOutput[j * m_numOutputs];
+            for (std::size_t k = 0; k < m_numOutputs; k++)
+            {
+                out[k] += h * w[k];
+            }
+        }
+        const double* const wBias = &m_hiddenOutput[m_numHidden * m_numOutputs];
+        for (std::size_t k = 0; k < m_numOutputs; k++)
+        {
+            out[k] = sigmoid(out[k] + bias * wBias[k]);
+        }
+    }
+}
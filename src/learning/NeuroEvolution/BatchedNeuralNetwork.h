@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef BATCHED_NEURAL_NETWORK_H
+#define BATCHED_NEURAL_NETWORK_H
+
+/**
+ * @file BatchedNeuralNetwork.h
+ * @brief Feedforward of many input patterns through one network at once
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * The same single hidden layer network as neuralNetwork, with sigmoid
+ * activations and a bias neuron of -1 on the input and hidden layers,
+ * evaluated for a whole batch of patterns per call. Controllers that
+ * run one network per cable fill one row per cable and make a single
+ * call each tick, instead of one feedForwardPattern (and one
+ * allocation) per cable.
+ *
+ * Outputs match neuralNetwork::feedForwardPattern bit for bit: each
+ * neuron sums its inputs in the same order.
+ */
+class BatchedNeuralNetwork
+{
+public:
+
+    BatchedNeuralNetwork(std::size_t numInputs,
+                         std::size_t numHidden,
+                         std::size_t numOutputs);
+
+    /**
+     * Read weights written by neuralNetwork::saveWeights.
+     * @throw std::runtime_error if the file can't be read or holds
+     * the wrong number of weights
+     */
+    void loadWeights(const std::string& filename);
+
+    /**
+     * @param[in] weights input to hidden (bias row last), then hidden to
+     * output (bias row last), each row major with one row per source
+     * neuron; the order of neuralNetwork's weight files
+     * @throw std::invalid_argument if the size is wrong
+     */
+    void setWeights(const std::vector<double>& weights);
+
+    /**
+     * Evaluate batchSize patterns. Row r of inputs starts at
+     * inputs[r * getNumInputs()], and row r of the result is written to
+     * outputs[r * getNumOutputs()]. Allocates nothing once the scratch
+     * space has grown to the block size.
+     */
+    void feedForward(const double* inputs, std::size_t batchSize,
+                     double* outputs);
+
+    std::size_t getNumInputs() const
+    {
+        return m_numInputs;
+    }
+
+    std::size_t getNumHidden() const
+    {
+        return m_numHidden;
+    }
+
+    std::size_t getNumOutputs() const
+    {
+        return m_numOutputs;
+    }
+
+private:
+
+    /** Evaluate rows, no more than blockRows of them */
+    void feedForwardBlock(const double* inputs, std::size_t rows,
+                          double* outputs);
+
+    const std::size_t m_numInputs;
+    const std::size_t m_numHidden;
+    const std::size_t m_numOutputs;
+
+    /** (m_numInputs + 1) x m_numHidden, row major */
+    std::vector<double> m_inputHidden;
+
+    /** (m_numHidden + 1) x m_numOutputs, row major */
+    std::vector<double> m_hiddenOutput;
+
+    /** Hidden activations of the current block */
+    std::vector<double> m_hidden;
+};
+
+#endif // BATCHED_NEURAL_NETWORK_H
@@ -28,6 +28,7 @@
 #include "neuralNet/Neural Network v2/neuralNetwork.h"
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <assert.h>
 #include <stdexcept>
 
@@ -136,6 +137,8 @@ void NeuroEvoMember::saveToFile(const char * outputFilename)
 	else
 	{
 		ofstream ss(outputFilename);
+		// Enough digits to read back exactly the same doubles
+		ss.precision(numeric_limits<double>::digits10 + 2);
 		for(std::size_t i=0;i<statelessParameters.size();i++)
 		{
 			ss<<statelessParameters[i];
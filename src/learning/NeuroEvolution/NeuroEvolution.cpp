@@ -28,7 +28,9 @@
 #include "learning/Configuration/configuration.h"
 #include "core/tgString.h"
 #include "helpers/FileHelpers.h"
+#include "learning/Parallel/TrialSeed.h"
 // The C++ Standard Library
+#include <cstdlib>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -57,6 +59,8 @@ NeuroEvolution::NeuroEvolution(std::string suff, std::string config, std::string
 suffix(suff)
 {
 	currentTest=0;
+	trialCount=0;
+	subTests=0;
 	generationNumber=0;
 	if (path != "")
 	{
@@ -83,13 +87,26 @@ suffix(suff)
     
     bool learning = myconfigdataaa.getintvalue("learning");
     
+    // A fixed master seed makes the run reproducible, otherwise pick one
+    // and report it so the run can be repeated
+    if (myconfigdataaa.iskey("masterSeed"))
+    {
+        masterSeed = strtoull(myconfigdataaa.data["masterSeed"].c_str(), NULL, 10);
+    }
+    else
+    {
+        masterSeed = rdtsc();
+    }
+    cout << "masterSeed=" << masterSeed << endl;
+    evoConfig = myconfigdataaa;
+    
     if (populationSize < numberOfElementsToMutate + numberOfChildren)
     {
         throw std::invalid_argument("Population will grow with given parameters");
     }
     
-   srand(rdtsc());
-	eng.seed(rdtsc());
+	srand(deriveTrialSeed(masterSeed, 0));
+	eng.seed(deriveTrialSeed(masterSeed, 1));
 
 	for(int j=0;j<numberOfControllers;j++)
 	{
@@ -191,13 +208,17 @@ double diffclock(clock_t clock1,clock_t clock2)
 	return diffms;
 }
 
-vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
+int NeuroEvolution::testsPerGeneration() const
 {
-	int testsToDo=0;
 	if(coevolution)
-		testsToDo=numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
+		return numberOfTestsBetweenGenerations; //stop when we reach x amount of random tests
 	else
-		testsToDo=populationSize; //stop when we test each element once
+		return populationSize; //stop when we test each element once
+}
+
+vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
+{
+	const int testsToDo = testsPerGeneration();
 
 	if(currentTest == testsToDo)
 	{
@@ -243,16 +264,41 @@ vector <NeuroEvoMember *> NeuroEvolution::nextSetOfControllers()
 	return selectedControllers;
 }
 
+vector< vector <NeuroEvoMember *> > NeuroEvolution::nextGenerationOfControllers()
+{
+	vector< vector <NeuroEvoMember *> > generation;
+	// The first call rolls over to a new generation if the last one is done
+	do
+	{
+		generation.push_back(nextSetOfControllers());
+	}
+	while (currentTest < testsPerGeneration());
+
+	return generation;
+}
+
+unsigned long long NeuroEvolution::getTrialSeed(std::size_t i) const
+{
+	// Offset past the seeds used for srand and eng in the constructor
+	return deriveTrialSeed(masterSeed, i + 2);
+}
+
 void NeuroEvolution::updateScores(vector <double> multiscore)
+{
+	updateScores(selectedControllers, multiscore);
+}
+
+void NeuroEvolution::updateScores(const vector <NeuroEvoMember *>& controllers,
+									vector <double> multiscore)
 {
 	if(multiscore.size()==2)
 		this->scoresOfTheGeneration.push_back(multiscore);
 	else
 		multiscore.push_back(-1.0);
 	double score=1.0* multiscore[0] - 0.0 * multiscore[1];
-	for(std::size_t oneElem=0;oneElem<selectedControllers.size();oneElem++)
+	for(std::size_t oneElem=0;oneElem<controllers.size();oneElem++)
 	{
-		NeuroEvoMember * controllerPointer=selectedControllers.at(oneElem);
+		NeuroEvoMember * controllerPointer=controllers.at(oneElem);
 
 		controllerPointer->pastScores.push_back(score);
 		double prevScore=controllerPointer->maxScore;
@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef MEMBER_BLOB_H
+#define MEMBER_BLOB_H
+
+/**
+ * @file MemberBlob.h
+ * @brief Converts evolution members to and from their .nnw file contents
+ * $Id$
+ */
+
+// POSIX
+#include <stdlib.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Members only know how to save themselves to a file, and the neural
+ * network format belongs to an external library, so go through a
+ * private temporary file. The blob is exactly what saveToFile writes.
+ *
+ * Stateless parameters are written with 17 significant digits, which
+ * read back to the same doubles. The neural network library writes
+ * its weights with 6, so use saveExact for anything a worker evaluates
+ * on the member's behalf.
+ */
+namespace MemberBlob
+{
+    inline std::string makeTempFile()
+    {
+        char path[] = "/tmp/ntrtMemberXXXXXX";
+        const int fd = mkstemp(path);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not create temporary parameter file");
+        }
+        close(fd);
+        return path;
+    }
+
+    template <class Member>
+    std::string save(Member& member)
+    {
+        const std::string path = makeTempFile();
+        member.saveToFile(path.c_str());
+
+        std::ifstream in(path.c_str(), std::ios::binary);
+        std::ostringstream blob;
+        blob << in.rdbuf();
+        in.close();
+        unlink(path.c_str());
+        return blob.str();
+    }
+
+    template <class Member>
+    void load(Member& member, const std::string& blob)
+    {
+        const std::string path = makeTempFile();
+        {
+            std::ofstream out(path.c_str(), std::ios::binary);
+            out << blob;
+        }
+        try
+        {
+            member.loadFromFile(path.c_str());
+        }
+        catch (...)
+        {
+            unlink(path.c_str());
+            throw;
+        }
+        unlink(path.c_str());
+    }
+
+    /**
+     * Save the member, then load the blob back into it, so the member
+     * holds bit for bit what any other member loading the blob will.
+     * A format that rounds changes the member to the rounded values.
+     * @throw std::runtime_error if saving again gives a different
+     * blob, i.e. the format does not read back what it wrote
+     */
+    template <class Member>
+    std::string saveExact(Member& member)
+    {
+        const std::string blob = save(member);
+        load(member, blob);
+        if (save(member) != blob)
+        {
+            throw std::runtime_error("Member parameters change when saved and loaded again");
+        }
+        return blob;
+    }
+}
+
+#endif // MEMBER_BLOB_H
@@ -0,0 +1,207 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef PROCESS_TRIAL_FARM_H
+#define PROCESS_TRIAL_FARM_H
+
+/**
+ * @file ProcessTrialFarm.h
+ * @brief Evaluates a generation of learning trials in worker processes
+ * $Id$
+ */
+
+#include "MemberBlob.h"
+#include "TrialProcessPool.h"
+#include "TrialWorker.h"
+#include "learning/Configuration/configuration.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * Builds a TrialWorker inside a worker process, after the fork, so
+ * each process has its own world and simulation.
+ */
+template <class Member>
+class TrialWorkerFactory
+{
+public:
+    virtual ~TrialWorkerFactory() { }
+    virtual TrialWorker<Member>* createWorker(std::size_t index) = 0;
+};
+
+/**
+ * Evaluates the trials of NeuroEvolution or AnnealEvolution in
+ * parallel. Workers must be processes, not threads: Bullet's profiler
+ * (BT_PROFILE) keeps its state in globals, and so do parts of the
+ * simulator, so two worlds cannot step at once in one process.
+ *
+ * Each trial is sent to a worker as its per-trial seed plus the .nnw
+ * contents of each member, from MemberBlob::saveExact so both sides
+ * hold the same parameters bit for bit. The worker loads them into its
+ * own members, runs the trial and returns the scores and the
+ * parameters as they were at the end of the trial. Those are copied back in trial order,
+ * so controllers that adjust their parameters online still work.
+ */
+template <class Evolution>
+class ProcessTrialFarm
+{
+public:
+    typedef typename Evolution::member_type Member;
+
+    /**
+     * Forks the worker processes. Construct this after the evolution
+     * object, but before creating any worlds or starting any threads.
+     * @param[in] factory must outlive the farm
+     */
+    ProcessTrialFarm(Evolution& evolution,
+                        TrialWorkerFactory<Member>& factory,
+                        std::size_t numProcesses) :
+    m_evolution(evolution),
+    m_handlerFactory(evolution, factory),
+    m_pool(numProcesses, m_handlerFactory)
+    {
+    }
+
+    std::size_t getNumProcesses() const
+    {
+        return m_pool.getNumProcesses();
+    }
+
+    /**
+     * Evaluate every remaining trial of the current generation and
+     * report the scores before the next orderAllPopulations().
+     */
+    void evaluateGeneration()
+    {
+        const std::vector< std::vector<Member*> > trials =
+            m_evolution.nextGenerationOfControllers();
+        const std::size_t firstTrial = m_evolution.getTrialCount() - trials.size();
+
+        std::vector<TrialProcessPool::Request> requests(trials.size());
+        for (std::size_t i = 0; i < trials.size(); i++)
+        {
+            requests[i].seed = m_evolution.getTrialSeed(firstTrial + i);
+            for (std::size_t j = 0; j < trials[i].size(); j++)
+            {
+                // The evolution keeps exactly what the worker evaluates
+                requests[i].blobs.push_back(MemberBlob::saveExact(*trials[i][j]));
+            }
+        }
+
+        const std::vector<TrialProcessPool::Response> responses =
+            m_pool.evaluate(requests);
+
+        for (std::size_t i = 0; i < trials.size(); i++)
+        {
+            const TrialProcessPool::Response& response = responses[i];
+            // Empty if the worker died, keep what we sent
+            for (std::size_t j = 0; j < response.blobs.size() && j < trials[i].size(); j++)
+            {
+                if (response.blobs[j] != requests[i].blobs[j])
+                {
+                    MemberBlob::load(*trials[i][j], response.blobs[j]);
+                }
+            }
+
+            std::vector<double> scores = response.scores;
+            if (scores.empty())
+            {
+                // Same convention as the adapters' endEpisode
+                scores.push_back(-1.0);
+            }
+            m_evolution.updateScores(trials[i], scores);
+        }
+    }
+
+private:
+
+    /** Lives in the worker process */
+    class Handler : public TrialProcessPool::Handler
+    {
+    public:
+        Handler(const Evolution& evolution, TrialWorker<Member>* worker) :
+        m_worker(worker)
+        {
+            // A fresh member per population to load parameters into
+            configuration config = evolution.getConfig();
+            const int numControllers = config.getintvalue("numberOfControllers");
+            for (int i = 0; i < numControllers; i++)
+            {
+                m_members.push_back(new Member(config));
+            }
+        }
+
+        virtual ~Handler()
+        {
+            for (std::size_t i = 0; i < m_members.size(); i++)
+            {
+                delete m_members[i];
+            }
+            delete m_worker;
+        }
+
+        virtual TrialProcessPool::Response handle(const TrialProcessPool::Request& request)
+        {
+            std::vector<Member*> controllers;
+            for (std::size_t i = 0; i < request.blobs.size() && i < m_members.size(); i++)
+            {
+                MemberBlob::load(*m_members[i], request.blobs[i]);
+                controllers.push_back(m_members[i]);
+            }
+
+            TrialProcessPool::Response response;
+            response.scores = m_worker->runTrial(controllers, request.seed);
+            for (std::size_t i = 0; i < controllers.size(); i++)
+            {
+                response.blobs.push_back(MemberBlob::save(*controllers[i]));
+            }
+            return response;
+        }
+
+    private:
+        TrialWorker<Member>* const m_worker;
+        std::vector<Member*> m_members;
+    };
+
+    class HandlerFactory : public TrialProcessPool::HandlerFactory
+    {
+    public:
+        HandlerFactory(const Evolution& evolution,
+                        TrialWorkerFactory<Member>& factory) :
+        m_evolution(evolution),
+        m_factory(factory)
+        {
+        }
+
+        virtual TrialProcessPool::Handler* createHandler(std::size_t worker)
+        {
+            return new Handler(m_evolution, m_factory.createWorker(worker));
+        }
+
+    private:
+        const Evolution& m_evolution;
+        TrialWorkerFactory<Member>& m_factory;
+    };
+
+    Evolution& m_evolution;
+    HandlerFactory m_handlerFactory;
+    TrialProcessPool m_pool;
+};
+
+#endif // PROCESS_TRIAL_FARM_H
@@ -0,0 +1,491 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file TrialProcessPool.cpp
+ * @brief Implementation of TrialProcessPool
+ * $Id$
+ */
+
+#include "TrialProcessPool.h"
+// POSIX
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+// The C++ Standard Library
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+#ifndef MSG_NOSIGNAL
+// Mac OS X uses SO_NOSIGPIPE instead, see spawn()
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    const uint32_t kStatusOk = 0;
+    const uint32_t kStatusError = 1;
+
+    /** A worker that dies this many times without finishing a trial is fatal */
+    const int kMaxConsecutiveDeaths = 5;
+
+    void appendU32(std::string& buf, uint32_t value)
+    {
+        buf.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void appendU64(std::string& buf, uint64_t value)
+    {
+        buf.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void appendString(std::string& buf, const std::string& value)
+    {
+        appendU32(buf, value.size());
+        buf.append(value);
+    }
+
+    bool writeAll(int fd, const std::string& buf)
+    {
+        std::size_t sent = 0;
+        while (sent < buf.size())
+        {
+            const ssize_t n = send(fd, buf.data() + sent, buf.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            sent += n;
+        }
+        return true;
+    }
+
+    /** @return false on end of file or error */
+    bool readAll(int fd, void* buf, std::size_t size)
+    {
+        char* const p = static_cast<char*>(buf);
+        std::size_t got = 0;
+        while (got < size)
+        {
+            const ssize_t n = read(fd, p + got, size - got);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            got += n;
+        }
+        return true;
+    }
+
+    bool readU32(int fd, uint32_t& value)
+    {
+        return readAll(fd, &value, sizeof(value));
+    }
+
+    bool readString(int fd, std::string& value)
+    {
+        uint32_t size;
+        if (!readU32(fd, size))
+        {
+            return false;
+        }
+        value.resize(size);
+        return size == 0 || readAll(fd, &value[0], size);
+    }
+
+    bool readStrings(int fd, std::vector<std::string>& values)
+    {
+        uint32_t count;
+        if (!readU32(fd, count))
+        {
+            return false;
+        }
+        values.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!readString(fd, values[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string encodeRequest(const TrialProcessPool::Request& request)
+    {
+        std::string buf;
+        appendU64(buf, request.seed);
+        appendU32(buf, request.blobs.size());
+        for (std::size_t i = 0; i < request.blobs.size(); i++)
+        {
+            appendString(buf, request.blobs[i]);
+        }
+        return buf;
+    }
+
+    bool readRequest(int fd, TrialProcessPool::Request& request)
+    {
+        uint64_t seed;
+        if (!readAll(fd, &seed, sizeof(seed)))
+        {
+            return false;
+        }
+        request.seed = seed;
+        return readStrings(fd, request.blobs);
+    }
+
+    std::string encodeResponse(const TrialProcessPool::Response& response)
+    {
+        std::string buf;
+        appendU32(buf, kStatusOk);
+        appendU32(buf, response.scores.size());
+        if (!response.scores.empty())
+        {
+            buf.append(reinterpret_cast<const char*>(&response.scores[0]),
+                        response.scores.size() * sizeof(double));
+        }
+        appendU32(buf, response.blobs.size());
+        for (std::size_t i = 0; i < response.blobs.size(); i++)
+        {
+            appendString(buf, response.blobs[i]);
+        }
+        return buf;
+    }
+
+    std::string encodeError(const std::string& what)
+    {
+        std::string buf;
+        appendU32(buf, kStatusError);
+        appendString(buf, what);
+        return buf;
+    }
+
+    /**
+     * Answer the outstanding trial with an error and leave the worker
+     * process, skipping the parent's static destructors and atexit
+     * handlers. Never returns.
+     */
+    void abandonWorker(int fd, const std::string& what)
+    {
+        writeAll(fd, encodeError(what));
+        close(fd);
+        _exit(1);
+    }
+}
+
+TrialProcessPool::TrialProcessPool(std::size_t numProcesses,
+                                    HandlerFactory& factory) :
+m_factory(factory)
+{
+    if (numProcesses == 0)
+    {
+        throw std::invalid_argument("Need at least one worker process");
+    }
+
+    m_workers.resize(numProcesses);
+    for (std::size_t i = 0; i < numProcesses; i++)
+    {
+        m_workers[i].pid = -1;
+        m_workers[i].fd = -1;
+        m_workers[i].trial = -1;
+    }
+    for (std::size_t i = 0; i < numProcesses; i++)
+    {
+        spawn(i);
+    }
+}
+
+TrialProcessPool::~TrialProcessPool()
+{
+    for (std::size_t i = 0; i < m_workers.size(); i++)
+    {
+        reap(i);
+    }
+}
+
+void TrialProcessPool::spawn(std::size_t index)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+    {
+        throw std::runtime_error("Could not create trial worker socket");
+    }
+#ifdef SO_NOSIGPIPE
+    const int on = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    // Otherwise the child inherits and later repeats anything unwritten
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(NULL);
+
+    const pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("Could not fork trial worker");
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        // Other workers' sockets must not stay open in this process,
+        // or they would never see end of file when the parent exits
+        for (std::size_t i = 0; i < m_workers.size(); i++)
+        {
+            if (m_workers[i].fd >= 0)
+            {
+                close(m_workers[i].fd);
+            }
+        }
+        serve(index, fds[1]);
+    }
+
+    close(fds[1]);
+    m_workers[index].pid = pid;
+    m_workers[index].fd = fds[0];
+    m_workers[index].trial = -1;
+}
+
+void TrialProcessPool::reap(std::size_t index)
+{
+    Worker& worker = m_workers[index];
+    if (worker.fd >= 0)
+    {
+        close(worker.fd);
+        worker.fd = -1;
+    }
+    if (worker.pid > 0)
+    {
+        int status;
+        while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        worker.pid = -1;
+    }
+    worker.trial = -1;
+}
+
+void TrialProcessPool::serve(std::size_t index, int fd)
+{
+    Handler* handler = NULL;
+    std::string startError;
+    try
+    {
+        handler = m_factory.createHandler(index);
+    }
+    catch (const std::exception& e)
+    {
+        startError = e.what();
+    }
+    catch (...)
+    {
+        startError = "unknown exception";
+    }
+    if (handler == NULL)
+    {
+        std::cerr << "Trial worker " << index << " failed to start: "
+                    << startError << std::endl;
+        // Answer the first trial, so evaluate reports why rather than
+        // restarting a worker that can never start
+        Request request;
+        if (readRequest(fd, request))
+        {
+            abandonWorker(fd, "Trial worker failed to start: " + startError);
+        }
+        _exit(1);
+    }
+
+    try
+    {
+        Request request;
+        while (readRequest(fd, request))
+        {
+            std::string reply;
+            try
+            {
+                reply = encodeResponse(handler->handle(request));
+            }
+            catch (const std::exception& e)
+            {
+                reply = encodeError(e.what());
+            }
+            catch (...)
+            {
+                reply = encodeError("unknown exception");
+            }
+            if (!writeAll(fd, reply))
+            {
+                break;
+            }
+        }
+
+        delete handler;
+    }
+    catch (const std::exception& e)
+    {
+        abandonWorker(fd, e.what());
+    }
+    catch (...)
+    {
+        abandonWorker(fd, "unknown exception");
+    }
+
+    close(fd);
+    // Skip static destructors and atexit handlers, they belong to the parent
+    _exit(0);
+}
+
+std::vector<TrialProcessPool::Response>
+TrialProcessPool::evaluate(const std::vector<Request>& requests)
+{
+    std::vector<Response> responses(requests.size());
+    std::vector<int> deaths(m_workers.size(), 0);
+    std::size_t next = 0;
+    std::size_t outstanding = 0;
+    bool failed = false;
+    std::string error;
+
+    while (true)
+    {
+        // Hand out work to idle workers
+        for (std::size_t i = 0; i < m_workers.size() && !failed; i++)
+        {
+            Worker& worker = m_workers[i];
+            if (worker.trial >= 0 || next >= requests.size())
+            {
+                continue;
+            }
+            worker.trial = next++;
+            outstanding++;
+            if (!writeAll(worker.fd, encodeRequest(requests[worker.trial])))
+            {
+                // Leave it to poll to notice the hang up
+                continue;
+            }
+        }
+
+        if (outstanding == 0)
+        {
+            break;
+        }
+
+        std::vector<pollfd> fds;
+        std::vector<std::size_t> busy;
+        for (std::size_t i = 0; i < m_workers.size(); i++)
+        {
+            if (m_workers[i].trial >= 0)
+            {
+                pollfd p;
+                p.fd = m_workers[i].fd;
+                p.events = POLLIN;
+                p.revents = 0;
+                fds.push_back(p);
+                busy.push_back(i);
+            }
+        }
+
+        if (poll(&fds[0], fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("poll failed while waiting for trial workers");
+        }
+
+        for (std::size_t j = 0; j < fds.size(); j++)
+        {
+            if (fds[j].revents == 0)
+            {
+                continue;
+            }
+            const std::size_t i = busy[j];
+            Worker& worker = m_workers[i];
+            Response& response = responses[worker.trial];
+
+            uint32_t status;
+            bool ok = readU32(worker.fd, status);
+            if (ok && status == kStatusOk)
+            {
+                uint32_t numScores;
+                ok = readU32(worker.fd, numScores);
+                if (ok)
+                {
+                    response.scores.resize(numScores);
+                    ok = numScores == 0 ||
+                        readAll(worker.fd, &response.scores[0],
+                                numScores * sizeof(double));
+                }
+                ok = ok && readStrings(worker.fd, response.blobs);
+            }
+            else if (ok)
+            {
+                std::string what;
+                ok = readString(worker.fd, what);
+                if (ok && !failed)
+                {
+                    failed = true;
+                    error = what;
+                }
+            }
+
+            outstanding--;
+            if (ok)
+            {
+                deaths[i] = 0;
+                worker.trial = -1;
+            }
+            else
+            {
+                // The worker died: score the trial as exploded and replace it
+                std::cerr << "Trial worker " << i << " died during trial "
+                            << worker.trial << ", restarting" << std::endl;
+                response = Response();
+                reap(i);
+                if (++deaths[i] >= kMaxConsecutiveDeaths)
+                {
+                    throw std::runtime_error("Trial worker keeps dying, giving up");
+                }
+                spawn(i);
+            }
+        }
+    }
+
+    if (failed)
+    {
+        throw std::runtime_error("Trial failed in worker process: " + error);
+    }
+    return responses;
+}
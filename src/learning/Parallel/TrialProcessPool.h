@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TRIAL_PROCESS_POOL_H
+#define TRIAL_PROCESS_POOL_H
+
+/**
+ * @file TrialProcessPool.h
+ * @brief A pool of forked worker processes that evaluate learning trials
+ * $Id$
+ */
+
+// POSIX
+#include <sys/types.h>
+// The C++ Standard Library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Forks a fixed number of worker processes connected to the parent by
+ * Unix domain sockets. Each worker builds its own handler after the
+ * fork, so no Bullet state is shared between trials running at the
+ * same time. The parent side is single threaded: it hands requests to
+ * idle workers and waits for replies with poll(). A worker that dies
+ * mid-trial (e.g. a segfault in a contact callback) is reported as an
+ * empty score vector and replaced with a fresh process.
+ *
+ * The pool knows nothing about evolution; see ProcessTrialFarm.
+ */
+class TrialProcessPool
+{
+public:
+
+    /** One trial: a seed and a parameter blob per population */
+    struct Request
+    {
+        unsigned long long seed;
+        std::vector<std::string> blobs;
+    };
+
+    /** Scores, and the parameter blobs as they were after the trial */
+    struct Response
+    {
+        std::vector<double> scores;
+        std::vector<std::string> blobs;
+    };
+
+    /** Evaluates requests inside a worker process */
+    class Handler
+    {
+    public:
+        virtual ~Handler() { }
+        virtual Response handle(const Request& request) = 0;
+    };
+
+    /** Called in each worker process right after the fork */
+    class HandlerFactory
+    {
+    public:
+        virtual ~HandlerFactory() { }
+        virtual Handler* createHandler(std::size_t worker) = 0;
+    };
+
+    /**
+     * Fork the workers. Flush any open streams before calling this,
+     * since the children inherit unwritten buffers.
+     * @param[in] numProcesses must be positive
+     * @param[in] factory must outlive the pool, workers are restarted
+     * with it
+     */
+    TrialProcessPool(std::size_t numProcesses, HandlerFactory& factory);
+
+    /** Closes the sockets, which tells the workers to exit, and reaps them */
+    ~TrialProcessPool();
+
+    std::size_t getNumProcesses() const
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * Evaluate all requests and return the responses in request order.
+     * Throws std::runtime_error if a handler threw, or could not be
+     * created, inside a worker, or if a worker keeps dying. Destroy the pool after an exception, as
+     * replies to other outstanding requests may still be queued.
+     */
+    std::vector<Response> evaluate(const std::vector<Request>& requests);
+
+private:
+
+    struct Worker
+    {
+        pid_t pid;
+        int fd;
+        /** The request being evaluated, or -1 if idle */
+        long trial;
+    };
+
+    void spawn(std::size_t index);
+    void reap(std::size_t index);
+
+    /** Run in the child. Never returns. */
+    void serve(std::size_t index, int fd);
+
+    HandlerFactory& m_factory;
+    std::vector<Worker> m_workers;
+};
+
+#endif // TRIAL_PROCESS_POOL_H
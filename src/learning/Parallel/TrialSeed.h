@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TRIAL_SEED_H
+#define TRIAL_SEED_H
+
+/**
+ * @file TrialSeed.h
+ * @brief Derives independent per-trial seeds from a single master seed
+ * $Id$
+ */
+
+/**
+ * Mix the master seed with a trial number (splitmix64), so that
+ * neighbouring trials get uncorrelated seeds and any trial can be
+ * reproduced without replaying the ones before it.
+ */
+inline unsigned long long deriveTrialSeed(unsigned long long masterSeed,
+                                            unsigned long long trial)
+{
+    unsigned long long z = masterSeed + (trial + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#endif // TRIAL_SEED_H
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TRIAL_WORKER_H
+#define TRIAL_WORKER_H
+
+/**
+ * @file TrialWorker.h
+ * @brief Interface for objects that can evaluate one learning trial
+ * $Id$
+ */
+
+#include <vector>
+
+/**
+ * A TrialWorker owns everything needed to run a trial: typically a
+ * tgWorld, a tgSimulation, a model and a controller that takes its
+ * parameters from the members it is handed rather than from an
+ * adapter. ProcessTrialFarm creates one worker in each worker process,
+ * and it runs one trial at a time. See EscapeTrialWorker in
+ * examples/craterEscape.
+ *
+ * The members are the worker's own copies. Changes made to them
+ * during the trial are copied back to the evolution's members.
+ */
+template <class Member>
+class TrialWorker
+{
+public:
+    virtual ~TrialWorker() { }
+
+    /**
+     * Run a single trial and return its scores, in the same format
+     * the adapters pass to updateScores (distance, energy).
+     * An empty vector is scored as an explosion.
+     * @param[in] controllers one member from each population
+     * @param[in] seed the seed for this trial. Use it (not the time)
+     * for any noise or randomized terrain so the trial is reproducible.
+     */
+    virtual std::vector<double> runTrial(const std::vector<Member*>& controllers,
+                                            unsigned long long seed) = 0;
+};
+
+#endif // TRIAL_WORKER_H
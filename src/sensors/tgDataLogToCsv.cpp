@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgDataLogToCsv.cpp
+ * @brief Command line tool that converts a binary tgDataLogger2 log to CSV
+ * $Id$
+ */
+
+// This application
+#include "tgDataLogger2.h"
+// The C++ Standard Library
+#include <exception>
+#include <iostream>
+#include <string>
+
+/**
+ * Usage: tgDataLogToCsv log.bin [log.txt]
+ * If no output name is given, the extension of the input is replaced
+ * with .txt (or .txt is appended).
+ */
+int main(int argc, char** argv)
+{
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " binaryLog [csvFile]" << std::endl;
+    return 1;
+  }
+  const std::string input = argv[1];
+  std::string output;
+  if (argc == 3) {
+    output = argv[2];
+  }
+  else {
+    const std::size_t dot = input.find_last_of('.');
+    const std::size_t slash = input.find_last_of('/');
+    output = (dot != std::string::npos
+	      && (slash == std::string::npos || dot > slash)) ?
+      input.substr(0, dot) + ".txt" : input + ".txt";
+  }
+
+  try {
+    const std::size_t n = tgDataLogger2::convertBinaryToCsv(input, output);
+    std::cout << "Wrote " << n << " records to " << output << std::endl;
+  }
+  catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -36,6 +36,26 @@
 #include <sstream> // for converting a size_t to a string.
 #include <cstdlib> // for getenv, converting ~ to $HOME.
 
+const char* const tgDataLogger2::binaryMagic = "tgDataLogger2 binary v1";
+
+namespace
+{
+  // Size of the stream buffer used for the log file.
+  const std::size_t kWriteBufferSize = 1 << 20;
+
+  // Count the columns in a heading line: every heading ends in a comma.
+  std::size_t countColumns(const std::string& headingLine)
+  {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < headingLine.size(); i++) {
+      if (headingLine[i] == ',') {
+	n++;
+      }
+    }
+    return n;
+  }
+}
+
 /**
  * The constructor for this class only assigns the filename prefix.
  * The actual filename is created in setup.
@@ -43,9 +63,12 @@
  * appending to the same one.)
  * Call the constructor of the parent class anyway, though it does nothing.
  */
-tgDataLogger2::tgDataLogger2(std::string fileNamePrefix) :
+tgDataLogger2::tgDataLogger2(std::string fileNamePrefix, Format format) :
   tgDataManager(),
-  m_fileNamePrefix(fileNamePrefix)
+  m_fileNamePrefix(fileNamePrefix),
+  m_format(format),
+  m_writeBuffer(kWriteBufferSize),
+  m_totalTime(0.0)
 {
   // A quick check on the passed-in string: it must not be the empty
   // string. Must be a correct linux path.
@@ -91,6 +114,9 @@ tgDataLogger2::tgDataLogger2()
  */
 tgDataLogger2::~tgDataLogger2()
 {
+  // The writer thread calls writeRecord, so it must finish while this
+  // object is still whole.
+  stopAsync();
   // TO-DO: should we double-check and close the tgOutput filestream here too?
 }
 
@@ -99,7 +125,8 @@ tgDataLogger2::~tgDataLogger2()
  * (1) create the full filename, based on the current time from the operating system,
  * (2) create the sensors based on the sensor infos that have been added and 
  *     the senseable objects that have also been added,
- * (3) opens the log file and writes a heading line (then closes the file.)
+ * (3) opens the log file and writes a heading line. The file stays open
+ *     until teardown.
  */
 void tgDataLogger2::setup()
 {
@@ -120,18 +147,30 @@ void tgDataLogger2::setup()
   currentTime = localtime(&rawtime);
   strftime(fileTime, fileTimeSize, "%m%d%Y_%H%M%S", currentTime);
   // Result: fileTime is a string with the time information.
-  m_fileName = m_fileNamePrefix + "_" + fileTime + ".txt";
+  m_fileName = m_fileNamePrefix + "_" + fileTime
+    + (m_format == BINARY ? ".bin" : ".txt");
+  m_totalTime = 0.0;
 
   // DEBUGGING output:
   std::cout << "tgDataLogger2 will be saving data to the file: " << std::endl
 	    << m_fileName << std::endl;
 
-  // Attempt to open the log file
-  tgOutput.open(m_fileName.c_str());
+  // Attempt to open the log file. The buffer must be installed before
+  // the file is opened for it to take effect.
+  if (tgOutput.is_open()) {
+    tgOutput.close();
+  }
+  tgOutput.clear();
+  tgOutput.rdbuf()->pubsetbuf(&m_writeBuffer[0], m_writeBuffer.size());
+  tgOutput.open(m_fileName.c_str(), std::ios::out | std::ios::binary);
   if (!tgOutput.is_open()) {
     throw std::runtime_error("Log file could not be opened. Usually, this is because the directory you specified does not exist. Check for spelling errors.");
   }
 
+  if (m_format == BINARY) {
+    tgOutput << binaryMagic << "\n";
+  }
+
   // Output a first line of the header.
   tgOutput << "tgDataLogger2 started logging at time " << fileTime << ", with "
 	   << m_sensors.size() << " sensors on " << m_senseables.size()
@@ -156,10 +195,25 @@ void tgDataLogger2::setup()
     }
   }
   // End with a new line.
-  tgOutput << std::endl;
+  tgOutput << "\n";
 
-  // Done! Close the output for now, will be re-opened during step.
-  tgOutput.close();
+  // One slot for the time, plus one per heading. Each sensor reports its
+  // width once, here.
+  m_sensorWidths.clear();
+  std::size_t width = 1;
+  for (std::size_t i=0; i < m_sensors.size(); i++) {
+    const std::size_t sensorWidth = m_sensors[i]->getSensorDataWidth();
+    if (sensorWidth != m_sensors[i]->getSensorDataHeadings().size()) {
+      throw std::runtime_error("A sensor's data width does not match its number of headings.");
+    }
+    m_sensorWidths.push_back(sensorWidth);
+    width += sensorWidth;
+  }
+  m_record.assign(width, 0.0);
+
+  // From here on, only the writer thread touches tgOutput if setAsync
+  // was requested.
+  startAsync(m_record.size());
   
   // Postcondition
   assert(invariant());
@@ -167,6 +221,7 @@ void tgDataLogger2::setup()
 
 /**
  * The parent's teardown method handles the sensors and sensor infos.
+ * Closing the log file flushes the write buffer.
  */
 void tgDataLogger2::teardown()
 {
@@ -181,8 +236,9 @@ void tgDataLogger2::teardown()
 /**
  * The step method is where data is actually collected!
  * This data logger will do two things here:
- * (1) iterate through all the sensors, collect their data, 
- * (2) write that line of data to the log file (then close the log again.)
+ * (1) iterate through all the sensors, collect their numeric data, 
+ * (2) write that record to the log file's buffer, or hand it to the
+ *     writer thread in asynchronous mode (see tgDataManager::setAsync).
  */
 void tgDataLogger2::step(double dt) 
 {
@@ -192,31 +248,45 @@ void tgDataLogger2::step(double dt)
   }
   else
   {
-    // Open the log file for writing, appending and not overwriting.
-    tgOutput.open(m_fileName.c_str(), std::ios::app);
     // For the timestamp: first, add dt to the total time
     m_totalTime += dt;
-    // Then output the time.
-    tgOutput << m_totalTime << ",";
-    // Collect the data and output it to the file!
-    for (size_t i=0; i < m_sensors.size(); i++) {
-      // Get the vector of sensor data from this sensor
-      std::vector<std::string> sensordata = m_sensors[i]->getSensorData();
-      // Iterate and output each data sample
-      for (std::size_t j=0; j < sensordata.size(); j++) {
-	// Include a comma, since this is a comma-separated-value log file.
-	tgOutput << sensordata[j] << ",";
+    // Fill the record in heading order, each sensor writing straight into
+    // its columns, and let the base class write it (here or on the
+    // writer thread).
+    std::size_t k = 0;
+    m_record[k++] = m_totalTime;
+    for (std::size_t i=0; i < m_sensors.size(); i++) {
+      if (m_sensorWidths[i] > 0) {
+	m_sensors[i]->sampleSensorData(&m_record[k]);
       }
+      k += m_sensorWidths[i];
     }
-    tgOutput << std::endl;
-    // Close the output, to be re-opened next step.
-    tgOutput.close();
+    assert(k == m_record.size());
+    submitRecord(m_record);
   }
 
   // Postcondition
   assert(invariant());
 }
 
+/**
+ * Write one numeric record, either as raw doubles or as a CSV line.
+ * Runs on the writer thread in asynchronous mode.
+ */
+void tgDataLogger2::writeRecord(const double* record, std::size_t width)
+{
+  if (m_format == BINARY) {
+    tgOutput.write(reinterpret_cast<const char*>(record),
+		   width * sizeof(double));
+  }
+  else {
+    for (std::size_t i = 0; i < width; i++) {
+      tgOutput << record[i] << ",";
+    }
+    tgOutput << "\n";
+  }
+}
+
 /**
  * The toString method for tgDataLogger2 should have some specific information
  * about (for example) the log file...
@@ -226,11 +296,57 @@ std::string tgDataLogger2::toString() const
   std::string p = "  ";  
   std::ostringstream os;
   os << tgDataManager::toString()
-     << "This tgDataManager is a tgDataLogger2. " << std::endl;
+     << "This tgDataManager is a tgDataLogger2, writing "
+     << (m_format == BINARY ? "binary" : "CSV") << " data to "
+     << m_fileName << std::endl;
 
   return os.str();
 }
 
+/**
+ * Read the text header of a binary log (magic line, info line, heading
+ * line), then copy records one at a time into CSV lines.
+ */
+std::size_t tgDataLogger2::convertBinaryToCsv(const std::string& binaryFileName,
+					      const std::string& csvFileName)
+{
+  std::ifstream input(binaryFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    throw std::runtime_error("Could not open binary log " + binaryFileName);
+  }
+  std::string magic, info, headings;
+  if (!std::getline(input, magic) || magic != binaryMagic
+      || !std::getline(input, info) || !std::getline(input, headings)) {
+    throw std::runtime_error(binaryFileName + " is not a binary tgDataLogger2 log.");
+  }
+  const std::size_t numColumns = countColumns(headings);
+  if (numColumns == 0) {
+    throw std::runtime_error(binaryFileName + " has no columns.");
+  }
+
+  std::ofstream output(csvFileName.c_str());
+  if (!output.is_open()) {
+    throw std::runtime_error("Could not open CSV file " + csvFileName);
+  }
+  output << info << "\n" << headings << "\n";
+
+  std::vector<double> record(numColumns);
+  const std::streamsize recordBytes = numColumns * sizeof(double);
+  std::size_t numRecords = 0;
+  while (input.read(reinterpret_cast<char*>(&record[0]), recordBytes)) {
+    for (std::size_t i = 0; i < numColumns; i++) {
+      output << record[i] << ",";
+    }
+    output << "\n";
+    numRecords++;
+  }
+  if (input.gcount() != 0) {
+    std::cerr << "Warning: " << binaryFileName
+	      << " ends with a partial record, which was ignored." << std::endl;
+  }
+  return numRecords;
+}
+
 std::ostream&
 operator<<(std::ostream& os, const tgDataLogger2& obj)
 {
@@ -30,22 +30,48 @@
 #include "tgDataManager.h"
 // Includes from the C++ standard library
 #include <fstream> // for writing to a file
+#include <string>
+#include <vector>
 
 /**
  * tgDataLogger2 is a tgDataManager. It records data from sensors and outputs
- * that data to a log file, in comma-separated-value (CSV) format.
+ * that data to a log file, either in comma-separated-value (CSV) format or
+ * as fixed-width binary records (see Format). The log file stays open, with
+ * a large write buffer, from setup until teardown. With
+ * tgDataManager::setAsync, formatting and disk writes move to a background
+ * thread.
  */
 class tgDataLogger2 : public tgDataManager
 {
  public:
 
+  /**
+   * The output format of the log file.
+   * CSV writes one text line per step.
+   * BINARY writes the same text header as CSV, preceded by a magic line,
+   * and then one record per step of (1 + number of headings) doubles in
+   * native byte order: the time, then every sensor column in heading order.
+   * Use convertBinaryToCsv (or the tgDataLogToCsv tool) to read it back.
+   */
+  enum Format
+  {
+    CSV,
+    BINARY
+  };
+
+  /**
+   * The first line of every binary log file.
+   */
+  static const char* const binaryMagic;
+
   /**
    * The constructor for tgDataLogger2 takes in a string that specifies the location
    * of the log file to create.
    * @param[in] fileNamePrefix a string that specifies the path to the log file that 
    * will be written. The current time will be appended to this prefix.
+   * @param[in] format whether to write CSV text or binary records.
    */
-  tgDataLogger2(std::string fileNamePrefix);
+  tgDataLogger2(std::string fileNamePrefix, Format format = CSV);
 
   /**
    * Since folks will probably forget that a file name is needed,
@@ -75,8 +101,8 @@ class tgDataLogger2 : public tgDataManager
   virtual void teardown();
 
   /**
-   * The step function for tgDataLogger2 will open the log file for output,
-   * write a line of sensor data, then close the log file.
+   * The step function for tgDataLogger2 will write one record of sensor
+   * data to the (already open) log file.
    * Declared virtual here just in case any classes inherit from this.
    * @param[in] dt a double, the amount of time since the last step. 
    */
@@ -88,10 +114,27 @@ class tgDataLogger2 : public tgDataManager
    */
   virtual std::string toString() const;
 
+  /**
+   * Convert a log file written in BINARY format into the CSV format that
+   * the CSV mode would have produced.
+   * @param[in] binaryFileName the path to an existing binary log
+   * @param[in] csvFileName the path of the CSV file to write
+   * @return the number of records converted
+   * @throw std::runtime_error if a file cannot be opened or the input is
+   * not a binary tgDataLogger2 log
+   */
+  static std::size_t convertBinaryToCsv(const std::string& binaryFileName,
+					const std::string& csvFileName);
+
   // TO-DO: write a new invariant for this subclass, instead of using the parent's.
 
  protected:
 
+  /**
+   * Write one record of time and sensor data in the configured format.
+   */
+  virtual void writeRecord(const double* record, std::size_t width);
+
   /**
    * Store the full name of the file for writing data.
    * note that this is NOT what is passed into the constructor:
@@ -113,6 +156,27 @@ class tgDataLogger2 : public tgDataManager
    */
   std::ofstream tgOutput;
 
+  /**
+   * The output format chosen at construction.
+   */
+  Format m_format;
+
+  /**
+   * The write buffer handed to tgOutput, so that each step does not
+   * become a system call.
+   */
+  std::vector<char> m_writeBuffer;
+
+  /**
+   * One record, reused every step: time, then all sensor columns.
+   */
+  std::vector<double> m_record;
+
+  /**
+   * The number of columns of each sensor, in the order of m_sensors.
+   */
+  std::vector<std::size_t> m_sensorWidths;
+
   /**
    * Keep track of the total time that the simulation has run.
    * This is for adding a timestamp into the log file.
@@ -29,8 +29,11 @@
 #include "tgSensor.h"
 #include "core/tgSenseable.h"
 #include "tgSensorInfo.h"
+#include "tgSampleRing.h"
 // The C++ Standard Library
 //#include <stdio.h> // for sprintf
+#include <sched.h> // for sched_yield
+#include <unistd.h> // for usleep
 #include <iostream>
 #include <stdexcept>
 #include <cassert>
@@ -38,7 +41,13 @@
 /**
  * Nothing to do, in this abstract base class.
  */
-tgDataManager::tgDataManager()
+tgDataManager::tgDataManager() :
+  m_asyncCapacity(0),
+  m_overflowPolicy(BLOCK),
+  m_pRing(NULL),
+  m_stopWriter(false),
+  m_droppedRecords(0),
+  m_skipNext(false)
 {
   // Postcondition
   assert(invariant());
@@ -52,6 +61,10 @@ tgDataManager::tgDataManager()
  */
 tgDataManager::~tgDataManager()
 {
+  // Subclasses that write asynchronously should have stopped already:
+  // by now their writeRecord is gone. This only reclaims the thread.
+  stopAsync();
+
   //DEBUGGING
   //std::cout << "tgDataManager destructor." << std::endl;
   
@@ -138,6 +151,9 @@ void tgDataManager::setup()
  */
 void tgDataManager::teardown()
 {  
+  // Flush any records still in flight before the sensors go away.
+  stopAsync();
+
   // First, delete the sensors.
   // Note that it's good practice to set deleted pointers to NULL here.
   for (std::size_t i = 0; i < m_sensors.size(); i++)
@@ -245,6 +261,129 @@ std::string tgDataManager::toString() const
 }
 
 
+void tgDataManager::setAsync(std::size_t capacity, OverflowPolicy policy)
+{
+  m_asyncCapacity = capacity;
+  m_overflowPolicy = policy;
+}
+
+/**
+ * Nothing to write in this base class.
+ */
+void tgDataManager::writeRecord(const double* record, std::size_t width)
+{
+}
+
+void tgDataManager::startAsync(std::size_t width)
+{
+  stopAsync();
+  m_droppedRecords = 0;
+  m_skipNext = false;
+  if (m_asyncCapacity == 0 || width == 0)
+  {
+    return;
+  }
+  m_pRing = new tgSampleRing(m_asyncCapacity, width);
+  m_stopWriter = false;
+  if (pthread_create(&m_writer, NULL, &tgDataManager::writerThread, this) != 0)
+  {
+    delete m_pRing;
+    m_pRing = NULL;
+    throw std::runtime_error("Could not start the data manager writer thread.");
+  }
+}
+
+void tgDataManager::submitRecord(const std::vector<double>& record)
+{
+  if (m_pRing == NULL)
+  {
+    writeRecord(&record[0], record.size());
+    return;
+  }
+  assert(record.size() == m_pRing->recordWidth());
+
+  if (m_overflowPolicy == DECIMATE &&
+      m_pRing->size() * 4 > m_pRing->capacity() * 3)
+  {
+    m_skipNext = !m_skipNext;
+    if (m_skipNext)
+    {
+      m_droppedRecords++;
+      return;
+    }
+  }
+
+  if (!m_pRing->tryPush(&record[0]))
+  {
+    if (m_overflowPolicy == BLOCK)
+    {
+      while (!m_pRing->tryPush(&record[0]))
+      {
+        sched_yield();
+      }
+    }
+    else
+    {
+      m_droppedRecords++;
+    }
+  }
+}
+
+void tgDataManager::stopAsync()
+{
+  if (m_pRing == NULL)
+  {
+    return;
+  }
+  m_stopWriter = true;
+  __sync_synchronize();
+  pthread_join(m_writer, NULL);
+  delete m_pRing;
+  m_pRing = NULL;
+}
+
+/**
+ * Drain the ring until asked to stop, then drain whatever is left.
+ * Yields, then sleeps briefly, when there is nothing to write.
+ */
+void* tgDataManager::writerThread(void* pManager)
+{
+  tgDataManager& manager = *static_cast<tgDataManager*>(pManager);
+  tgSampleRing& ring = *manager.m_pRing;
+  std::vector<double> record(ring.recordWidth());
+  // Empty polls since the last record; yield for a while before sleeping
+  // so a steady producer is not held up by the sleep granularity.
+  std::size_t idle = 0;
+  while (true)
+  {
+    if (ring.tryPop(&record[0]))
+    {
+      manager.writeRecord(&record[0], record.size());
+      idle = 0;
+    }
+    else if (manager.m_stopWriter)
+    {
+      // The producer has stopped; one last pass catches anything pushed
+      // before the flag was set.
+      __sync_synchronize();
+      while (ring.tryPop(&record[0]))
+      {
+        manager.writeRecord(&record[0], record.size());
+      }
+      break;
+    }
+    else if (++idle < 100)
+    {
+      sched_yield();
+    }
+    else
+    {
+      usleep(200);
+    }
+  }
+  return NULL;
+}
+
 bool tgDataManager::invariant() const
 {
   // TO-DO:
@@ -33,8 +33,11 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+// Posix threads, for the asynchronous writer
+#include <pthread.h>
 
 // Forward declarations
+class tgSampleRing;
 class tgSensor;
 class tgSensorInfo;
 
@@ -48,6 +51,22 @@ class tgDataManager
 {
 public: 
 
+    /**
+     * What submitRecord does in asynchronous mode when the ring of
+     * pending records is full.
+     * DROP discards the new record.
+     * BLOCK waits for the writer thread to make room.
+     * DECIMATE keeps only every other record while the ring is more than
+     * three quarters full (and drops when it is completely full), so a
+     * slow disk thins the log instead of truncating it.
+     */
+    enum OverflowPolicy
+    {
+        DROP,
+        BLOCK,
+        DECIMATE
+    };
+
     /**
     * The default constructor. Nothing to do in this base class,
     * but subclasses might do something (e.g. set up a path name for
@@ -103,8 +122,70 @@ public:
      */
     virtual std::string toString() const;
 
+    /**
+     * Request that records be written by a background thread. Takes
+     * effect at the next setup, for subclasses that support it (those that
+     * call startAsync); others ignore it.
+     * @param[in] capacity the number of records buffered between the
+     * simulation and the writer thread. Zero turns asynchronous mode off.
+     * @param[in] policy what to do when the buffer is full
+     */
+    void setAsync(std::size_t capacity, OverflowPolicy policy = BLOCK);
+
+    /**
+     * @return true if a writer thread is currently running
+     */
+    bool isAsync() const
+    {
+        return m_pRing != NULL;
+    }
+
+    /**
+     * @return the number of records discarded by the DROP or DECIMATE
+     * policies since the last setup
+     */
+    std::size_t getDroppedRecords() const
+    {
+        return m_droppedRecords;
+    }
+
+ protected:
+
+    /**
+     * Output one record. Called from submitRecord in synchronous mode, or
+     * from the writer thread in asynchronous mode, so implementations must
+     * only touch state that the simulation thread leaves alone while the
+     * writer runs. The default does nothing.
+     * @param[in] record width doubles
+     * @param[in] width the record width passed to startAsync
+     */
+    virtual void writeRecord(const double* record, std::size_t width);
+
+    /**
+     * Start the writer thread if setAsync requested it. Subclasses call
+     * this at the end of setup, once any header has been written.
+     * @param[in] width the number of doubles in every record
+     */
+    void startAsync(std::size_t width);
+
+    /**
+     * Hand a record to the writer thread, or write it immediately when
+     * not in asynchronous mode. Never blocks unless the policy is BLOCK.
+     */
+    void submitRecord(const std::vector<double>& record);
+
+    /**
+     * Write every pending record and join the writer thread. Safe to call
+     * when no thread is running. Subclasses call this before closing
+     * their output.
+     */
+    void stopAsync();
+
  private:
 
+    /** pthread entry point for the writer thread. */
+    static void* writerThread(void* pManager);
+
     /**
      * A helper function for setup. Since there will be a loop over
      * the sensor infos, this function abstracts it away.
@@ -136,6 +217,29 @@ protected:
      */
     std::vector<tgSenseable*> m_senseables;
 
+ private:
+
+    /** Requested ring capacity, 0 for synchronous writing. */
+    std::size_t m_asyncCapacity;
+
+    /** Requested overflow policy. */
+    OverflowPolicy m_overflowPolicy;
+
+    /** Pending records, non-NULL while the writer thread runs. */
+    tgSampleRing* m_pRing;
+
+    /** The writer thread. */
+    pthread_t m_writer;
+
+    /** Set by stopAsync to tell the writer to drain and exit. */
+    volatile bool m_stopWriter;
+
+    /** Records discarded since the last startAsync. */
+    std::size_t m_droppedRecords;
+
+    /** Alternates while decimating. */
+    bool m_skipNext;
+
 };
 
 /**
@@ -115,10 +115,17 @@ std::vector<std::string> tgRodSensor::getSensorDataHeadings() {
   return headings;
 }
 
+/**
+ * The number of columns never changes: position, orientation and mass.
+ */
+std::size_t tgRodSensor::getSensorDataWidth() {
+  return 7;
+}
+
 /**
  * The method that collects the actual data from this tgRod.
  */
-std::vector<std::string> tgRodSensor::getSensorData() {
+void tgRodSensor::sampleSensorData(double* data) {
   // Similar to getSensorDataHeading, cast the a pointer to a tgRod right now.
   tgRod* m_pRod = tgCast::cast<tgSenseable, tgRod>(m_pSens);
   // Check: if the cast failed, this will return 0.
@@ -129,58 +136,14 @@ std::vector<std::string> tgRodSensor::getSensorData() {
   btVector3 orient = m_pRod->orientation();
   // Note that the 'orientation' method also returns a btVector3.
 
-  // The list of sensor data that will be returned:
-  std::vector<std::string> sensordata;
-
-  /**
-   * The original version of this section of code, which 
-   * output one string, looked like:
-   * std::stringstream sensordata;
-   * sensordata << com[0] << ","
-   *	     << com[1] << ","
-   *	     << com[2] << ","
-   *	     << orient[0] << ","
-   *	     << orient[1] << ","
-   *	     << orient[2] << ","
-   *	     << m_pRod->mass() << ",";
-   */
-  
-  // The floats (btScalars?) need to be converted to strings
-  // via a stringstream.
-  std::stringstream ss;
-
-  // com[0]
-  ss << com[0];
-  sensordata.push_back( ss.str() );
-  // Reset the stream.
-  ss.str("");
-  
-  // com[1]
-  ss << com[1];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // com[2]
-  ss << com[2];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // orient[0]
-  ss << orient[0];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // orient[1]
-  ss << orient[1];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // orient[2]
-  ss << orient[2];
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  // mass
-  ss << m_pRod->mass();
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  
-  return sensordata;
+  // Same order as the headings.
+  data[0] = com[0];
+  data[1] = com[1];
+  data[2] = com[2];
+  data[3] = orient[0];
+  data[4] = orient[1];
+  data[5] = orient[2];
+  data[6] = m_pRod->mass();
 }
 
 //end.
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgSampleRing.cpp
+ * @brief Contains the implementation of class tgSampleRing.
+ * $Id$
+ */
+
+// This module
+#include "tgSampleRing.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <stdexcept>
+
+// Full memory barrier. The counters are only ever written by one side, so
+// ordering the record copy against the counter update is all that is needed.
+#define TG_SAMPLE_RING_BARRIER() __sync_synchronize()
+
+tgSampleRing::tgSampleRing(std::size_t capacity, std::size_t recordWidth) :
+    m_capacity(capacity),
+    m_recordWidth(recordWidth),
+    m_pushed(0),
+    m_popped(0)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("Sample ring capacity is zero.");
+    }
+    else if (recordWidth == 0)
+    {
+        throw std::invalid_argument("Sample ring record width is zero.");
+    }
+    m_data.resize(capacity * recordWidth);
+}
+
+bool tgSampleRing::tryPush(const double* record)
+{
+    const unsigned long long pushed = m_pushed;
+    TG_SAMPLE_RING_BARRIER();
+    if (pushed - m_popped >= m_capacity)
+    {
+        return false;
+    }
+    std::copy(record, record + m_recordWidth,
+              &m_data[(pushed % m_capacity) * m_recordWidth]);
+    // Publish the record only after it has been written
+    TG_SAMPLE_RING_BARRIER();
+    m_pushed = pushed + 1;
+    return true;
+}
+
+bool tgSampleRing::tryPop(double* record)
+{
+    const unsigned long long popped = m_popped;
+    TG_SAMPLE_RING_BARRIER();
+    if (popped == m_pushed)
+    {
+        return false;
+    }
+    // Do not read the slot before seeing the producer's count
+    TG_SAMPLE_RING_BARRIER();
+    const double* slot = &m_data[(popped % m_capacity) * m_recordWidth];
+    std::copy(slot, slot + m_recordWidth, record);
+    // Release the slot only after it has been read
+    TG_SAMPLE_RING_BARRIER();
+    m_popped = popped + 1;
+    return true;
+}
+
+std::size_t tgSampleRing::size() const
+{
+    TG_SAMPLE_RING_BARRIER();
+    return static_cast<std::size_t>(m_pushed - m_popped);
+}
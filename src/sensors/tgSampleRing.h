@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_SAMPLE_RING_H
+#define TG_SAMPLE_RING_H
+
+/**
+ * @file tgSampleRing.h
+ * @brief Contains the definition of class tgSampleRing, a lock-free
+ * single-producer single-consumer queue of fixed-width numeric records.
+ * $Id$
+ */
+
+// The C++ Standard Library
+#include <cstddef>
+#include <vector>
+
+/**
+ * A preallocated ring of records, each recordWidth doubles long. Exactly
+ * one thread may call tryPush (the simulation) and exactly one other thread
+ * may call tryPop (a writer), without locks. Neither call allocates.
+ */
+class tgSampleRing
+{
+public:
+
+    /**
+     * @param[in] capacity the number of records the ring holds, > 0
+     * @param[in] recordWidth the number of doubles per record, > 0
+     * @throw std::invalid_argument if either is zero
+     */
+    tgSampleRing(std::size_t capacity, std::size_t recordWidth);
+
+    /**
+     * Copy one record into the ring.
+     * @param[in] record recordWidth doubles
+     * @return false if the ring is full, in which case nothing is copied
+     */
+    bool tryPush(const double* record);
+
+    /**
+     * Copy the oldest record out of the ring.
+     * @param[out] record room for recordWidth doubles
+     * @return false if the ring is empty
+     */
+    bool tryPop(double* record);
+
+    /** The number of records waiting. Exact only on the calling side. */
+    std::size_t size() const;
+
+    std::size_t capacity() const { return m_capacity; }
+
+    std::size_t recordWidth() const { return m_recordWidth; }
+
+private:
+
+    /** capacity * recordWidth doubles. */
+    std::vector<double> m_data;
+
+    const std::size_t m_capacity;
+
+    const std::size_t m_recordWidth;
+
+    /** Records pushed so far; written only by the producer. */
+    volatile unsigned long long m_pushed;
+
+    /** Records popped so far; written only by the consumer. */
+    volatile unsigned long long m_popped;
+};
+
+#endif // TG_SAMPLE_RING_H
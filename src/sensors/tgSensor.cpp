@@ -29,18 +29,21 @@
 #include "core/tgSenseable.h"
 
 // Includes from the c++ standard library:
+#include <cstdlib> // for strtod
+#include <sstream>
 #include <stdexcept>
 
 /**
- * This cpp file only implements the constructor for tgSensor.
- * Note that tgSensor is an abstract class with two pure virtual member
- * functions, so you cannot instantiate a tgSensor.
+ * Note that tgSensor is an abstract class (getSensorDataHeadings is pure
+ * virtual), so you cannot instantiate a tgSensor.
  * However, a constructor is provided here for ease of managing pointers
  * in child classes.
  * The shorthand syntax for variable assignment is used here.
  * "m_pSens" stands for "my pointer to a tgSenseable object."
  */
-tgSensor::tgSensor(tgSenseable* pSens) : m_pSens(pSens)
+tgSensor::tgSensor(tgSenseable* pSens) :
+  m_pSens(pSens),
+  m_inDefaultAdapter(false)
 {
   if (pSens == NULL) {
     throw std::invalid_argument("Pointer to pSenseable is NULL inside tgSensor.");
@@ -54,4 +57,75 @@ tgSensor::~tgSensor()
   // likely a tgModel, which is handled by other classes.
 }
 
+namespace
+{
+  /**
+   * Marks a default adapter as running for its scope, and throws if one
+   * already is: the sensor overrides neither sampleSensorData nor
+   * getSensorData.
+   */
+  class AdapterGuard
+  {
+  public:
+    AdapterGuard(bool& inAdapter) : m_inAdapter(inAdapter)
+    {
+      if (m_inAdapter) {
+        throw std::logic_error("tgSensor must override sampleSensorData or "
+                               "getSensorData.");
+      }
+      m_inAdapter = true;
+    }
+
+    ~AdapterGuard()
+    {
+      m_inAdapter = false;
+    }
+
+  private:
+    bool& m_inAdapter;
+  };
+}
+
+/**
+ * Sensors that know their layout override this with a constant.
+ */
+std::size_t tgSensor::getSensorDataWidth()
+{
+  return getSensorDataHeadings().size();
+}
+
+/**
+ * Adapter for sensors that only implement the string API.
+ */
+void tgSensor::sampleSensorData(double* data)
+{
+  AdapterGuard guard(m_inDefaultAdapter);
+  const std::vector<std::string> sensordata = getSensorData();
+  for (std::size_t i = 0; i < sensordata.size(); i++) {
+    data[i] = std::strtod(sensordata[i].c_str(), NULL);
+  }
+}
+
+/**
+ * Adapter for sensors that only implement the numeric API. The values are
+ * formatted with a default stringstream, as the sensors always have been.
+ */
+std::vector<std::string> tgSensor::getSensorData()
+{
+  AdapterGuard guard(m_inDefaultAdapter);
+  std::vector<double> values(getSensorDataWidth());
+  if (!values.empty()) {
+    sampleSensorData(&values[0]);
+  }
+  std::vector<std::string> sensordata;
+  sensordata.reserve(values.size());
+  std::stringstream ss;
+  for (std::size_t i = 0; i < values.size(); i++) {
+    ss.str("");
+    ss << values[i];
+    sensordata.push_back(ss.str());
+  }
+  return sensordata;
+}
+
 //end.
@@ -32,13 +32,17 @@ class tgSenseable;
 
 // From the C++ standard library:
 #include <iostream> //for strings
+#include <cstddef> // for size_t
+#include <string>
 #include <vector> // for returning lists of strings
 
 /**
  * This class defines methods for use with sensors.
  * Any individual sensor (ex., a tgRodSensor) will need to re-implement
  * both of these methods.
- * Note that we make everything pure virtual here to force re-definition.
+ * Headings are pure virtual here to force re-definition. Data can be
+ * provided either as numbers (sampleSensorData) or as strings
+ * (getSensorData); each defaults to an adapter around the other.
  * Sensing data from objects occurs in two places in the NTRTsim workflow.
  * First, when setting up the simulation, a heading for the data is given.
  * This describes the data that will be returned.
@@ -80,14 +84,37 @@ public:
    */
   virtual std::vector<std::string> getSensorDataHeadings() = 0;
 
+  /**
+   * The number of values this sensor reports, which must equal the number
+   * of headings. Callers ask once (e.g. at setup) and size their buffers
+   * from it. The default counts the headings; sensors with a fixed layout
+   * should override it with a constant.
+   * @return the number of columns of sensor data
+   */
+  virtual std::size_t getSensorDataWidth();
+
+  /**
+   * Write the current data from this sensor into a buffer supplied by the
+   * caller, in the same order as the headings. Does not allocate in the
+   * sensors in this library.
+   * The default implementation parses the strings from getSensorData(),
+   * so sensors written against the string API keep working.
+   * @param[out] data room for getSensorDataWidth() doubles
+   */
+  virtual void sampleSensorData(double* data);
+
   /**
    * Return the data from this class itself.
    * Note that this MUST have the same number of elements as is returned by
    * the getDataHeading function.
+   * The default implementation formats the values from sampleSensorData().
+   * A sensor must override at least one of sampleSensorData and
+   * getSensorData, since each default calls the other. If it overrides
+   * neither, the defaults throw std::logic_error rather than recursing.
    * @return a list of strings, each being a piece of sensor data,
    * in the same order as the headings.
    */
-  virtual std::vector<std::string> getSensorData() = 0;
+  virtual std::vector<std::string> getSensorData();
 
   // TO-DO: should any of this be const?
 
@@ -101,6 +128,14 @@ protected:
    */
   tgSenseable* m_pSens;
 
+private:
+
+  /**
+   * Set while one of the default adapters is calling the other, so that
+   * a sensor which overrides neither is caught instead of recursing.
+   */
+  bool m_inDefaultAdapter;
+
 };
 
 #endif //TG_SENSOR_H
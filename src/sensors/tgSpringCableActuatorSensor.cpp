@@ -109,10 +109,17 @@ std::vector<std::string> tgSpringCableActuatorSensor::getSensorDataHeadings() {
   return headings;
 }
 
+/**
+ * The number of columns never changes: rest length, length and tension.
+ */
+std::size_t tgSpringCableActuatorSensor::getSensorDataWidth() {
+  return 3;
+}
+
 /**
  * The method that collects the actual data from this tgSpringCableActuator.
  */
-std::vector<std::string> tgSpringCableActuatorSensor::getSensorData() {
+void tgSpringCableActuatorSensor::sampleSensorData(double* data) {
   // Similar to getSensorDataHeading, cast the a pointer
   // to a tgSpringCableActuator right now.
   tgSpringCableActuator* m_pSCA =
@@ -122,29 +129,10 @@ std::vector<std::string> tgSpringCableActuatorSensor::getSensorData() {
   // to a tgSpringCableActuator!!!
   assert( m_pSCA != 0);
 
-  // The list of sensor data that will be returned:
-  std::vector<std::string> sensordata;
-
-  // The floats doubles need to be converted to strings via a stringstream.
-  std::stringstream ss;
-
-  // rest length
-  ss << m_pSCA->getRestLength();
-  sensordata.push_back( ss.str() );
-  // Reset the stream.
-  ss.str("");
-
-  // current length
-  ss << m_pSCA->getCurrentLength();
-  sensordata.push_back( ss.str() );
-  ss.str("");
-
-  // tension
-  ss << m_pSCA->getTension();
-  sensordata.push_back( ss.str() );
-  ss.str("");
-  
-  return sensordata;
+  // Same order as the headings.
+  data[0] = m_pSCA->getRestLength();
+  data[1] = m_pSCA->getCurrentLength();
+  data[2] = m_pSCA->getTension();
 }
 
 //end.
@@ -52,10 +52,12 @@ public:
   virtual ~tgSpringCableActuatorSensor();
 
   /**
-   * Similarly, this class will implement the two data colleciton methods.
+   * Similarly, this class will implement the headings and the numeric
+   * data collection methods. The string getSensorData comes from tgSensor.
    */
   virtual std::vector<std::string> getSensorDataHeadings();
-  virtual std::vector<std::string> getSensorData();
+  virtual std::size_t getSensorDataWidth();
+  virtual void sampleSensorData(double* data);
 
 };
 
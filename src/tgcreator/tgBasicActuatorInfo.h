@@ -75,6 +75,11 @@ public:
 
     virtual void initConnector(tgWorld& world);
 
+    virtual bool initsWithoutWorld() const
+    {
+        return true;
+    }
+
     virtual tgModel* createModel(tgWorld& world);
 
     double getMass();
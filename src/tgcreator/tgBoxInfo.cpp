@@ -70,9 +70,8 @@ tgRigidInfo* tgBoxInfo::createRigidInfo(const tgPair& pair)
     return new tgBoxInfo(m_config, pair);
 }
 
-void tgBoxInfo::initRigidBody(tgWorld& world)
+void tgBoxInfo::finishRigidBody()
 {
-    tgRigidInfo::initRigidBody(world);
     assert(m_collisionObject != NULL);
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
@@ -105,13 +104,12 @@ btCollisionShape* tgBoxInfo::getCollisionShape(tgWorld& world) const
         const double height = m_config.height;
         const double length = getLength();
         // Nominally x, y, z should we adjust here or the transform?
-        m_collisionShape =
-            new btBoxShape(btVector3(width, length / 2.0, height));
     
-        // Add the collision shape to the array so we can delete it later
+        // Shared with boxes of the same size; the world owns it
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
-        bulletWorld.addCollisionShape(m_collisionShape);
+        m_collisionShape =
+            bulletWorld.getBoxShape(btVector3(width, length / 2.0, height));
     }
     return m_collisionShape;
 }
@@ -161,6 +161,15 @@ public:
      */
     //    virtual std::set<btVector3> getContainedNodes() const;
 
+    /**
+     * Points on the surface are contained too
+     * @retval false
+     */
+    virtual bool containsOnlyListedNodes() const
+    {
+        return false;
+    }
+
 protected:
 
     /**
@@ -27,6 +27,7 @@
 #ifndef TG_BUILD_SPEC_H
 #define TG_BUILD_SPEC_H
 
+#include <cstddef>
 #include <vector>
 
 #include "core/tgTagSearch.h"
@@ -71,7 +72,7 @@ public:
         tgConnectorInfo* infoFactory;
     };
 
-    tgBuildSpec() {}
+    tgBuildSpec() : m_buildThreads(1) {}
     virtual ~tgBuildSpec();
 
     void addBuilder(std::string tag_search, tgRigidInfo* infoFactory);
@@ -87,10 +88,31 @@ public:
     {
         return m_connectorAgents;
     }
+
+    /**
+     * Threads used to prepare rigid bodies and connectors. The default of
+     * one builds serially. More, or zero for one per processor, is an
+     * opt-in for large models: every getCollisionShape and every
+     * connector that initsWithoutWorld() in the structure then runs on
+     * build threads, so they must not touch the dynamics world, the
+     * profiler or other unsynchronized globals. The rigid and connector
+     * infos in this library only create shapes through the world's
+     * locked shape collections.
+     */
+    void setBuildThreads(std::size_t numThreads)
+    {
+        m_buildThreads = numThreads;
+    }
+
+    std::size_t getBuildThreads() const
+    {
+        return m_buildThreads;
+    }
     
 private:
     std::vector<RigidAgent*> m_rigidAgents;
     std::vector<ConnectorAgent*> m_connectorAgents;  
+    std::size_t m_buildThreads;
 };
 
 #endif
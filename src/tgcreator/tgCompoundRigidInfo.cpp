@@ -189,6 +189,18 @@ bool tgCompoundRigidInfo::sharesNodesWith(const tgRigidInfo& other) const
     return false;
 }
     
+bool tgCompoundRigidInfo::containsOnlyListedNodes() const
+{
+    for (int ii = 0; ii < m_rigids.size(); ii++)
+    {
+        if (!m_rigids[ii]->containsOnlyListedNodes())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::set<btVector3> tgCompoundRigidInfo::getContainedNodes() const
 {
     /// @todo Use std::accumulate()
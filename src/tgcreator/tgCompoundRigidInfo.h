@@ -201,6 +201,11 @@ class tgCompoundRigidInfo : public tgRigidInfo
      */
     std::set<btVector3> getContainedNodes() const;
 
+    /**
+     * True if it is for every rigid in this compound
+     */
+    virtual bool containsOnlyListedNodes() const;
+
 protected:
 
     /**
@@ -88,6 +88,11 @@ public:
      */
     virtual void initConnector(tgWorld& world);
 
+    virtual bool initsWithoutWorld() const
+    {
+        return true;
+    }
+
     /**
      * Return the tgCompressionSpringActuator that's been built
      * from the tgBulletCompressionSpring.
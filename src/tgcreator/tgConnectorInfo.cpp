@@ -29,6 +29,7 @@
 #include "tgPair.h"
 #include "tgPairs.h"
 #include "tgRigidInfo.h"
+#include "tgRigidNodeIndex.h"
 
 #include "core/tgTagSearch.h"
 
@@ -79,11 +80,28 @@ void tgConnectorInfo::chooseRigids(std::set<tgRigidInfo*> rigids)
     }
 }
 
+void tgConnectorInfo::chooseRigids(const tgRigidNodeIndex& index)
+{
+    if(getFromRigidInfo() == 0) { // if it hasn't already been set
+        setFromRigidInfo(chooseRigid(index, getFrom()));
+    }
+    
+    if(getToRigidInfo() == 0) { // if it hasn't already been set
+        setToRigidInfo(chooseRigid(index, getTo()));
+    }
+}
+
 tgRigidInfo* tgConnectorInfo::chooseRigid(std::set<tgRigidInfo*> rigids, const btVector3& v) {
+    return chooseAmong(findRigidsContaining(rigids, v), v);
+}
+
+tgRigidInfo* tgConnectorInfo::chooseRigid(const tgRigidNodeIndex& index, const btVector3& v) {
+    return chooseAmong(index.findRigidsContaining(v), v);
+}
 
-    std::set<tgRigidInfo*> candidateRigids = findRigidsContaining(rigids, v);
+tgRigidInfo* tgConnectorInfo::chooseAmong(const std::set<tgRigidInfo*>& candidateRigids, const btVector3& v) {
     
-    tgRigidInfo* chosenRigid;
+    tgRigidInfo* chosenRigid = NULL;
     if (candidateRigids.size() == 1) {
       // Choose the first element since there's only one
       chosenRigid = *(candidateRigids.begin());  
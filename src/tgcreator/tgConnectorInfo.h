@@ -35,6 +35,7 @@ class tgPair;
 class tgPairs;
 class tgTagSearch;
 class tgRigidInfo;
+class tgRigidNodeIndex;
 class btRigidBody;
 class tgModel;
 class tgWorld;
@@ -93,6 +94,16 @@ public:
     virtual std::vector<tgConnectorInfo*> createConnectorInfos(const tgPairs& pairs, const tgTagSearch& tagSearch);
     
     virtual void initConnector(tgWorld& world) = 0;
+
+    /**
+     * True if initConnector only reads the rigid bodies and never touches
+     * the world, so tgStructureInfo may run it on a build thread.
+     * Subclasses that override initConnector must revisit this.
+     */
+    virtual bool initsWithoutWorld() const
+    {
+        return false;
+    }
     
     virtual tgModel* createModel(tgWorld& world) = 0;
     
@@ -158,10 +169,22 @@ public:
     }
 
     
+    /**
+     * Choose rigids through an index shared by all connectors of a
+     * structure, rather than by asking every rigid
+     */
+    virtual void chooseRigids(const tgRigidNodeIndex& index);
+
     tgRigidInfo* chooseRigid(std::set<tgRigidInfo*> rigids, const btVector3& v);
     
+    tgRigidInfo* chooseRigid(const tgRigidNodeIndex& index, const btVector3& v);
     
 protected:
+    /**
+     * Pick the rigid for v among those containing it
+     */
+    tgRigidInfo* chooseAmong(const std::set<tgRigidInfo*>& candidateRigids, const btVector3& v);
+
     tgRigidInfo* findClosestCenterOfMass(std::set<tgRigidInfo*> rigids, const btVector3& v);
 
     // @todo: should this be protected/private?
@@ -27,8 +27,14 @@
 #include "tgRigidAutoCompound.h"
 
 #include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+#include "LinearMath/btVector3.h"
 #include "tgCompoundRigidInfo.h"
+#include <algorithm>
 #include <map>
+#include <set>
+#include <tr1/functional>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
 
 // Debugging
 #include <iostream>
@@ -36,6 +42,42 @@
 
 using namespace std;
 
+namespace
+{
+    /**
+     * Hash of a node position. Nodes are matched exactly, as in
+     * tgRigidInfo::sharesNodesWith. std::tr1::hash gives 0.0 and -0.0 the
+     * same hash, so equal positions always hash equally.
+     */
+    struct NodeHash
+    {
+        std::size_t operator()(const btVector3& v) const
+        {
+            std::tr1::hash<btScalar> h;
+            std::size_t seed = h(v.x());
+            seed ^= h(v.y()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= h(v.z()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+
+    struct NodeEqual
+    {
+        bool operator()(const btVector3& a, const btVector3& b) const
+        {
+            return a == b;
+        }
+    };
+
+    /** A rigid being expanded, and how far through its neighbors we are. */
+    struct SearchFrame
+    {
+        std::size_t rigid;
+        std::vector<std::size_t> neighbors;
+        std::size_t next;
+    };
+}
+
     
 // @todo: we want to start using this and get rid of the set-based constructor, but until we can refactor...
 tgRigidAutoCompound::tgRigidAutoCompound(std::vector<tgRigidInfo*> rigids)
@@ -78,20 +120,86 @@ void tgRigidAutoCompound::setRigidInfoForGroup(tgRigidInfo* rigidInfo, std::dequ
     }
 }
 
+/**
+ * Groups rigids that share nodes, transitively. Every node is hashed once
+ * to the rigids that contain it, so the cost is linear in the number of
+ * nodes rather than a pairwise sharesNodesWith between all rigids.
+ * The traversal visits neighbors in their original order, so groups and
+ * the rigids within them come out in the same order findGroup produced.
+ */
 void tgRigidAutoCompound::groupRigids()
 {
-    std::deque<tgRigidInfo*> ungrouped = std::deque<tgRigidInfo*>(m_rigids); // Copy of m_rigids
+    // Unique rigids in their original order
+    std::vector<tgRigidInfo*> rigids;
+    {
+        std::tr1::unordered_set<tgRigidInfo*> seen;
+        for (std::size_t i = 0; i < m_rigids.size(); i++) {
+            if (seen.insert(m_rigids[i]).second) {
+                rigids.push_back(m_rigids[i]);
+            }
+        }
+    }
+    const std::size_t n = rigids.size();
+
+    // Which rigids contain each node, in increasing index order
+    typedef std::tr1::unordered_map<btVector3, std::vector<std::size_t>,
+                                     NodeHash, NodeEqual> NodeMap;
+    NodeMap rigidsAtNode;
+    std::vector< std::vector<btVector3> > nodesOfRigid(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::set<btVector3> nodes = rigids[i]->getContainedNodes();
+        nodesOfRigid[i].assign(nodes.begin(), nodes.end());
+        for (std::size_t k = 0; k < nodesOfRigid[i].size(); k++) {
+            rigidsAtNode[nodesOfRigid[i][k]].push_back(i);
+        }
+    }
 
-    while(ungrouped.size() > 0) {
-        // go through each ungrouped element and find the groups for it
-        tgRigidInfo* elem = ungrouped[0]; // Note: the 0 element is removed by findGroup, so ungrouped[0] is different each iteration
+    std::vector<bool> grouped(n, false);
+    for (std::size_t start = 0; start < n; start++) {
+        if (grouped[start]) {
+            continue;
+        }
+        std::deque<tgRigidInfo*> group;
+        // Depth first, as the recursion in findGroup did, but with an
+        // explicit stack so long chains of rigids cannot overflow it
+        std::vector<SearchFrame> stack;
+        std::size_t current = start;
+        while (true) {
+            grouped[current] = true;
+            group.push_back(rigids[current]);
 
-        // Find all elements linked to the first item in ungrouped
-        // This will also remove the elements in the group from ungrouped
-        std::deque<tgRigidInfo*> group = findGroup(elem, ungrouped);
+            stack.push_back(SearchFrame());
+            SearchFrame& frame = stack.back();
+            frame.rigid = current;
+            frame.next = 0;
+            const std::vector<btVector3>& nodes = nodesOfRigid[current];
+            for (std::size_t k = 0; k < nodes.size(); k++) {
+                const std::vector<std::size_t>& others = rigidsAtNode[nodes[k]];
+                frame.neighbors.insert(frame.neighbors.end(), others.begin(), others.end());
+            }
+            std::sort(frame.neighbors.begin(), frame.neighbors.end());
+            frame.neighbors.erase(std::unique(frame.neighbors.begin(), frame.neighbors.end()),
+                                  frame.neighbors.end());
 
-        // Add the group to the groups list
-        m_groups.push_back(group);            
+            // Find the next ungrouped neighbor, backing out of finished rigids
+            bool found = false;
+            while (!stack.empty() && !found) {
+                SearchFrame& top = stack.back();
+                while (top.next < top.neighbors.size() && grouped[top.neighbors[top.next]]) {
+                    top.next++;
+                }
+                if (top.next < top.neighbors.size()) {
+                    current = top.neighbors[top.next++];
+                    found = true;
+                } else {
+                    stack.pop_back();
+                }
+            }
+            if (!found) {
+                break;
+            }
+        }
+        m_groups.push_back(group);
     }
 }
 
@@ -66,6 +66,7 @@ protected:
     void groupRigids();
 
     // Find all rigids that should be in a group with the given rigid
+    // Quadratic in the number of rigids; groupRigids no longer uses it
     // @todo: This may contain an off-by-one error (the last rigid may not be grouped properly...)
     std::deque<tgRigidInfo*> findGroup(tgRigidInfo* rigid, std::deque<tgRigidInfo*>& ungrouped);
         
@@ -92,34 +92,54 @@ std::vector<tgRigidInfo*> tgRigidInfo::createRigidInfos(const tgPairs& pairs, co
 
 
 void tgRigidInfo::initRigidBody(tgWorld& world)
+{
+    if (!getCollisionObject())
     {
-        if(!getRigidBody()) {
-
-            // we want to do this based on group instead the rigid itself; otherwise we throw away autocompounding.
-            tgRigidInfo* rigid = getRigidInfoGroup();
-
-            // If we're not using autocompounding, use the rigid body itself.
-            // NOTE: This means that auto-compounding can be silently skipped, which means that your parts may not be joined correctly. Do we want that?
-            if(rigid == 0) { 
-                rigid = this;
-            }
+        // we want to do this based on group instead the rigid itself; otherwise we throw away autocompounding.
+        tgRigidInfo* rigid = getRigidInfoGroup();
+
+        // If we're not using autocompounding, use the rigid body itself.
+        // NOTE: This means that auto-compounding can be silently skipped, which means that your parts may not be joined correctly. Do we want that?
+        if (rigid == 0)
+        {
+            rigid = this;
+        }
 
-            if (rigid->getRigidBody() == NULL) { // Init only if it doesn't have a btRigidBody (has already been initialized)
-
-                double mass = rigid->getMass();
-                btTransform transform = rigid->getTransform();
-                btCollisionShape* shape = rigid->getCollisionShape(world);
-                
-                btRigidBody* body = 
-          tgBulletUtil::createRigidBody(&tgBulletUtil::worldToDynamicsWorld(world),
-                        mass,
-                        transform,
-                        shape);
-                body->setFlags(BT_ENABLE_GYROPSCOPIC_FORCE);
-                rigid->setRigidBody(body);
+        // Init only if it doesn't have a collision object (has already been initialized)
+        if (rigid->getCollisionObject() == NULL)
+        {
+            // createRigidBody takes a float, so the inertia is computed with one
+            const float mass = rigid->getMass();
+            const btTransform transform = rigid->getTransform();
+            btCollisionShape* const shape = rigid->getCollisionShape(world);
+            btVector3 localInertia(0.0, 0.0, 0.0);
+            if (mass != 0.f)
+            {
+                shape->calculateLocalInertia(mass, localInertia);
             }
+            createCollisionObject(world, *rigid, mass, transform, shape,
+                                  localInertia);
         }
     }
+    finishRigidBody();
+}
+
+void tgRigidInfo::createCollisionObject(tgWorld& world,
+                                        tgRigidInfo& group,
+                                        float mass,
+                                        const btTransform& transform,
+                                        btCollisionShape* shape,
+                                        const btVector3& localInertia)
+{
+    btRigidBody* body = 
+      tgBulletUtil::createRigidBody(&tgBulletUtil::worldToDynamicsWorld(world),
+                                    mass,
+                                    transform,
+                                    shape,
+                                    localInertia);
+    body->setFlags(BT_ENABLE_GYROPSCOPIC_FORCE);
+    group.setRigidBody(body);
+}
 
 btRigidBody* tgRigidInfo::getRigidBody() 
 { 
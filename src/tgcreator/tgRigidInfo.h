@@ -120,8 +120,37 @@ public:
 
     virtual std::vector<tgRigidInfo*> createRigidInfos(const tgPairs& pairs, const tgTagSearch& tagSearch);
 
+    /**
+     * Create the collision object for this rigid's group, if there isn't
+     * one yet, then call finishRigidBody(). Subclasses customize the two
+     * hooks below rather than this, so tgStructureInfo can prepare the
+     * shapes on build threads and still get the same result.
+     */
     virtual void initRigidBody(tgWorld& world);
 
+    /**
+     * Make the collision object for group from a prepared shape and mass
+     * properties, add it to the world and assign it to group. Called
+     * serially, on the first rigid of each group in build order. The
+     * default makes a btRigidBody.
+     * @param[in,out] group this rigid's group, or this rigid if ungrouped
+     */
+    virtual void createCollisionObject(tgWorld& world,
+                                       tgRigidInfo& group,
+                                       float mass,
+                                       const btTransform& transform,
+                                       btCollisionShape* shape,
+                                       const btVector3& localInertia);
+
+    /**
+     * Apply per-rigid settings (e.g. friction) once the collision object
+     * exists. Called serially for every rigid, in build order, so the
+     * last rigid of a group has the final say. The default does nothing.
+     */
+    virtual void finishRigidBody()
+    {
+    }
+
     virtual tgModel* createModel(tgWorld& world) = 0;
 
     /**
@@ -311,6 +340,17 @@ public:
      */
     virtual std::set<btVector3> getContainedNodes() const = 0;
 
+    /**
+     * Can containsNode() only be true at (or within a fuzzy tolerance of)
+     * the nodes in getContainedNodes()? If so, tgRigidNodeIndex finds this
+     * rigid by position; otherwise it asks this rigid about every point.
+     * Defaults to false, which is always correct.
+     */
+    virtual bool containsOnlyListedNodes() const
+    {
+        return false;
+    }
+
     /**
      * Does this rigid have any nodes in common with the given tgRigidInfo object?
      * @param]in] other a reference to a tgRigidInfo object
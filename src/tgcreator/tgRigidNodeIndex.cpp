@@ -0,0 +1,136 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+/**
+ * @file tgRigidNodeIndex.cpp
+ * @brief Implementation of class tgRigidNodeIndex
+ * $Id$
+ */
+
+// This module
+#include "tgRigidNodeIndex.h"
+// This library
+#include "tgRigidInfo.h"
+// The C++ Standard Library
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    /**
+     * Side of a hash cell. Nodes closer than this are rare, and only
+     * cost an extra containsNode() call when they share a cell.
+     */
+    const double cellSize = 1e-3;
+
+    /**
+     * How far a point may be from a node and still be contained, with a
+     * wide margin over the fuzzy comparisons the rigids use
+     */
+    const double tolerance = 1e-6;
+
+    long cellCoordinate(double x)
+    {
+        return static_cast<long>(std::floor(x / cellSize));
+    }
+}
+
+std::size_t tgRigidNodeIndex::CellHash::operator()(const Cell& c) const
+{
+    std::tr1::hash<long> h;
+    std::size_t seed = h(c.x);
+    seed ^= h(c.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= h(c.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+tgRigidNodeIndex::Cell tgRigidNodeIndex::cellOf(const btVector3& v)
+{
+    Cell c;
+    c.x = cellCoordinate(v.x());
+    c.y = cellCoordinate(v.y());
+    c.z = cellCoordinate(v.z());
+    return c;
+}
+
+tgRigidNodeIndex::tgRigidNodeIndex(const std::vector<tgRigidInfo*>& rigids)
+{
+    for (std::size_t i = 0; i < rigids.size(); i++)
+    {
+        tgRigidInfo* const pRigid = rigids[i];
+        assert(pRigid != NULL);
+        if (!pRigid->containsOnlyListedNodes())
+        {
+            m_unindexed.push_back(pRigid);
+            continue;
+        }
+        const std::set<btVector3> nodes = pRigid->getContainedNodes();
+        for (std::set<btVector3>::const_iterator it = nodes.begin();
+             it != nodes.end(); ++it)
+        {
+            std::vector<tgRigidInfo*>& cell = m_cells[cellOf(*it)];
+            if (std::find(cell.begin(), cell.end(), pRigid) == cell.end())
+            {
+                cell.push_back(pRigid);
+            }
+        }
+    }
+}
+
+std::set<tgRigidInfo*>
+tgRigidNodeIndex::findRigidsContaining(const btVector3& v) const
+{
+    std::set<tgRigidInfo*> found;
+
+    // Usually a single cell, unless v is within tolerance of a cell wall
+    const Cell lo = cellOf(v - btVector3(tolerance, tolerance, tolerance));
+    const Cell hi = cellOf(v + btVector3(tolerance, tolerance, tolerance));
+    Cell c;
+    for (c.x = lo.x; c.x <= hi.x; c.x++)
+    {
+        for (c.y = lo.y; c.y <= hi.y; c.y++)
+        {
+            for (c.z = lo.z; c.z <= hi.z; c.z++)
+            {
+                const CellMap::const_iterator it = m_cells.find(c);
+                if (it == m_cells.end())
+                {
+                    continue;
+                }
+                const std::vector<tgRigidInfo*>& cell = it->second;
+                for (std::size_t i = 0; i < cell.size(); i++)
+                {
+                    if (cell[i]->containsNode(v))
+                    {
+                        found.insert(cell[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < m_unindexed.size(); i++)
+    {
+        if (m_unindexed[i]->containsNode(v))
+        {
+            found.insert(m_unindexed[i]);
+        }
+    }
+    return found;
+}
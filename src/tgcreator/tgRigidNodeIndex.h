@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2012, United States Government, as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All rights reserved.
+ * 
+ * The NASA Tensegrity Robotics Toolkit (NTRT) v1 platform is licensed
+ * under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0.
+ * 
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+*/
+
+#ifndef TG_RIGID_NODE_INDEX_H
+#define TG_RIGID_NODE_INDEX_H
+
+/**
+ * @file tgRigidNodeIndex.h
+ * @brief Definition of class tgRigidNodeIndex
+ * $Id$
+ */
+
+// The Bullet Physics library
+#include "LinearMath/btVector3.h"
+// The C++ Standard Library
+#include <cstddef>
+#include <set>
+#include <vector>
+#include <tr1/unordered_map>
+
+class tgRigidInfo;
+
+/**
+ * Finds the rigids containing a point without asking every rigid.
+ * Contained nodes are hashed by quantized position once, so a lookup
+ * only calls containsNode() on the rigids with a node near the point,
+ * plus those whose containsNode() isn't limited to their contained nodes
+ * (see tgRigidInfo::containsOnlyListedNodes).
+ */
+class tgRigidNodeIndex
+{
+public:
+
+    /**
+     * Index the given rigids. They must outlive the index and their nodes
+     * must not move while it is used.
+     */
+    explicit tgRigidNodeIndex(const std::vector<tgRigidInfo*>& rigids);
+
+    /**
+     * The indexed rigids whose containsNode() is true for v
+     */
+    std::set<tgRigidInfo*> findRigidsContaining(const btVector3& v) const;
+
+private:
+
+    /** A cube of side cellSize, by integer coordinates */
+    struct Cell
+    {
+        long x;
+        long y;
+        long z;
+
+        bool operator==(const Cell& other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct CellHash
+    {
+        std::size_t operator()(const Cell& c) const;
+    };
+
+    typedef std::tr1::unordered_map<Cell, std::vector<tgRigidInfo*>,
+                                    CellHash> CellMap;
+
+    static Cell cellOf(const btVector3& v);
+
+    CellMap m_cells;
+
+    /** Rigids that may contain points other than their nodes */
+    std::vector<tgRigidInfo*> m_unindexed;
+};
+
+#endif // TG_RIGID_NODE_INDEX_H
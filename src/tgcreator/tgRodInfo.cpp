@@ -69,9 +69,8 @@ tgRigidInfo* tgRodInfo::createRigidInfo(const tgPair& pair)
     return new tgRodInfo(m_config, pair);
 }
 
-void tgRodInfo::initRigidBody(tgWorld& world)
+void tgRodInfo::finishRigidBody()
 {
-    tgRigidInfo::initRigidBody(world);
     assert(m_collisionObject != NULL);
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
@@ -102,13 +101,13 @@ btCollisionShape* tgRodInfo::getCollisionShape(tgWorld& world) const
     {
         const double radius = m_config.radius;
         const double length = getLength();
-        m_collisionShape =
-            new btCylinderShape(btVector3(radius, length / 2.0, radius));
     
-        // Add the collision shape to the array so we can delete it later
+        // Rods of the same radius and length share one shape, which
+        // the world owns
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
-        bulletWorld.addCollisionShape(m_collisionShape);
+        m_collisionShape =
+            bulletWorld.getCylinderShape(btVector3(radius, length / 2.0, radius));
     }
     return m_collisionShape;
 }
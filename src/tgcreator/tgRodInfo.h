@@ -91,12 +91,12 @@ public:
     tgRigidInfo* createRigidInfo(const tgPair& pair);
     
     /**
-     * Call tgRigidInfo init rigid, then apply config to the rigid body.
-     * @todo come up with a general solution in tgRigidInfo::initRigidBody
+     * Apply config to the rigid body.
+     * @todo come up with a general solution in tgRigidInfo
      * Currently very difficult to pass around the config file in
      * tgRigidInfo, since
      */
-    virtual void initRigidBody(tgWorld& world);
+    virtual void finishRigidBody();
     
     tgModel* createModel(tgWorld& world);
     
@@ -206,6 +206,15 @@ public:
      */
     virtual std::set<btVector3> getContainedNodes() const;
 
+    /**
+     * Only the endpoints are contained
+     * @retval true
+     */
+    virtual bool containsOnlyListedNodes() const
+    {
+        return true;
+    }
+
     /**
      * Return the distance between the two endpoints.
      * @return the distance between the two endpoints
@@ -70,9 +70,8 @@ tgRigidInfo* tgSphereInfo::createRigidInfo(const tgNode& node)
     return new tgSphereInfo(m_config, node);
 }
 
-void tgSphereInfo::initRigidBody(tgWorld& world)
+void tgSphereInfo::finishRigidBody()
 {
-    tgRigidInfo::initRigidBody(world);
     assert(m_collisionObject != NULL);
     getRigidBody()->setFriction(m_config.friction);
     getRigidBody()->setRollingFriction(m_config.rollFriction);
@@ -102,13 +101,11 @@ btCollisionShape* tgSphereInfo::getCollisionShape(tgWorld& world) const
     if (m_collisionShape == NULL) 
     {
         const double radius = m_config.radius;
-        m_collisionShape =
-            new btSphereShape(radius);
     
-        // Add the collision shape to the array so we can delete it later
+        // Shared with spheres of the same radius; the world owns it
         tgWorldBulletPhysicsImpl& bulletWorld =
       (tgWorldBulletPhysicsImpl&)world.implementation();
-        bulletWorld.addCollisionShape(m_collisionShape);
+        m_collisionShape = bulletWorld.getSphereShape(radius);
     }
     return m_collisionShape;
 }
@@ -89,12 +89,12 @@ public:
     tgRigidInfo* createRigidInfo(const tgNode& node);
     
     /**
-     * Call tgRigidInfo init rigid, then apply config to the rigid body.
-     * @todo come up with a general solution in tgRigidInfo::initRigidBody
+     * Apply config to the rigid body.
+     * @todo come up with a general solution in tgRigidInfo
      * Currently very difficult to pass around the config file in
      * tgRigidInfo, since
      */
-    virtual void initRigidBody(tgWorld& world);
+    virtual void finishRigidBody();
     
     tgModel* createModel(tgWorld& world);
     
@@ -205,6 +205,15 @@ public:
      */
     virtual std::set<btVector3> getContainedNodes() const;
 
+    /**
+     * Only the center point is contained
+     * @retval true
+     */
+    virtual bool containsOnlyListedNodes() const
+    {
+        return true;
+    }
+
 private:
 
     /** Disable the copy constructor. */
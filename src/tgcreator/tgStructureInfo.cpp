@@ -29,11 +29,227 @@
 // This library
 #include "tgConnectorInfo.h"
 #include "tgRigidAutoCompound.h"
+#include "tgRigidNodeIndex.h"
 #include "tgStructure.h"
+#include "tgRigidInfo.h"
+#include "core/tgBulletUtil.h"
 #include "core/tgWorld.h"
 #include "core/tgModel.h"
+// The Bullet Physics library
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+// POSIX
+#include <pthread.h>
+#include <unistd.h>
 // The C++ Standard Library
+#include <algorithm>
+#include <exception>
+#include <set>
 #include <stdexcept>
+#include <string>
+
+namespace
+{
+    /** Build work that may be split across threads, one item at a time */
+    class BuildJob
+    {
+    public:
+        virtual ~BuildJob() { }
+        virtual void run(std::size_t item) = 0;
+    };
+
+    /** State shared by all threads for one call to dispatch */
+    struct DispatchState
+    {
+        BuildJob* job;
+        std::size_t numItems;
+        std::size_t nextItem;
+        bool failed;
+        std::string error;
+        pthread_mutex_t mutex;
+    };
+
+    void recordFailure(DispatchState& state, const std::string& what)
+    {
+        pthread_mutex_lock(&state.mutex);
+        if (!state.failed)
+        {
+            state.failed = true;
+            state.error = what;
+        }
+        pthread_mutex_unlock(&state.mutex);
+    }
+
+    void* buildThreadMain(void* arg)
+    {
+        DispatchState& state = *static_cast<DispatchState*>(arg);
+
+        while (true)
+        {
+            pthread_mutex_lock(&state.mutex);
+            const bool done = state.failed || state.nextItem >= state.numItems;
+            const std::size_t item = state.nextItem++;
+            pthread_mutex_unlock(&state.mutex);
+
+            if (done)
+            {
+                break;
+            }
+
+            try
+            {
+                state.job->run(item);
+            }
+            catch (const std::exception& e)
+            {
+                recordFailure(state, e.what());
+            }
+            catch (...)
+            {
+                recordFailure(state, "unknown exception");
+            }
+        }
+        return NULL;
+    }
+
+    /**
+     * Run items 0 to numItems - 1 and return when all are complete. With
+     * more than one thread, the first failure abandons the remaining
+     * items and is rethrown as a std::runtime_error once all have joined.
+     */
+    void dispatch(BuildJob& job, std::size_t numItems, std::size_t numThreads)
+    {
+        if (numThreads <= 1)
+        {
+            for (std::size_t i = 0; i < numItems; i++)
+            {
+                job.run(i);
+            }
+            return;
+        }
+
+        DispatchState state;
+        state.job = &job;
+        state.numItems = numItems;
+        state.nextItem = 0;
+        state.failed = false;
+        pthread_mutex_init(&state.mutex, NULL);
+
+        std::vector<pthread_t> threads(numThreads);
+        std::size_t started = 0;
+        for (std::size_t i = 0; i < numThreads; i++)
+        {
+            if (pthread_create(&threads[i], NULL, buildThreadMain, &state) != 0)
+            {
+                break;
+            }
+            started++;
+        }
+
+        // If no thread could be started, do the work here
+        if (started == 0)
+        {
+            buildThreadMain(&state);
+        }
+
+        for (std::size_t i = 0; i < started; i++)
+        {
+            pthread_join(threads[i], NULL);
+        }
+        pthread_mutex_destroy(&state.mutex);
+
+        if (state.failed)
+        {
+            throw std::runtime_error("Build failed: " + state.error);
+        }
+    }
+
+    /**
+     * Threads worth starting for numItems. Starting a thread costs more
+     * than preparing a few dozen rods, so small models stay serial.
+     * @param[in] requested zero for one per processor
+     */
+    std::size_t buildThreads(std::size_t requested, std::size_t numItems)
+    {
+        const std::size_t minItemsPerThread = 64;
+        if (requested == 0)
+        {
+            const long online = sysconf(_SC_NPROCESSORS_ONLN);
+            requested = online > 0 ? static_cast<std::size_t>(online) : 1;
+        }
+        return std::max<std::size_t>(1,
+                            std::min(requested, numItems / minItemsPerThread));
+    }
+
+    /** What createRigidBody needs for one rigid group */
+    struct RigidBodyPlan
+    {
+        /** The group, or the rigid itself if ungrouped */
+        tgRigidInfo* rigid;
+        /** The group's first rigid in build order, which creates the body */
+        tgRigidInfo* first;
+        /** As passed to tgRigidInfo::createCollisionObject */
+        float mass;
+        btTransform transform;
+        btCollisionShape* shape;
+        btVector3 localInertia;
+    };
+
+    /**
+     * Builds shapes and mass properties. Each plan is a different group,
+     * and groups share no rigids, so the only shared state is the
+     * world's shape collections, which it locks.
+     */
+    class PrepareRigidsJob : public BuildJob
+    {
+    public:
+        PrepareRigidsJob(std::vector<RigidBodyPlan>& plans, tgWorld& world) :
+        m_plans(plans),
+        m_world(world)
+        {
+        }
+
+        virtual void run(std::size_t item)
+        {
+            RigidBodyPlan& plan = m_plans[item];
+            plan.mass = plan.rigid->getMass();
+            plan.transform = plan.rigid->getTransform();
+            plan.shape = plan.rigid->getCollisionShape(m_world);
+            plan.localInertia = btVector3(0.0, 0.0, 0.0);
+            if (plan.mass != 0.f)
+            {
+                plan.shape->calculateLocalInertia(plan.mass, plan.localInertia);
+            }
+        }
+
+    private:
+        std::vector<RigidBodyPlan>& m_plans;
+        tgWorld& m_world;
+    };
+
+    /** Connectors whose initConnector leaves the world alone */
+    class InitConnectorsJob : public BuildJob
+    {
+    public:
+        InitConnectorsJob(const std::vector<tgConnectorInfo*>& connectors,
+                          tgWorld& world) :
+        m_connectors(connectors),
+        m_world(world)
+        {
+        }
+
+        virtual void run(std::size_t item)
+        {
+            m_connectors[item]->initConnector(m_world);
+        }
+
+    private:
+        const std::vector<tgConnectorInfo*>& m_connectors;
+        tgWorld& m_world;
+    };
+}
 
 tgStructureInfo::tgStructureInfo(tgStructure& structure, tgBuildSpec& buildSpec) : 
     tgTaggable(),
@@ -114,6 +330,23 @@ std::vector<tgRigidInfo*> tgStructureInfo::getAllRigids() const
     return result;
 }
 
+std::vector<tgConnectorInfo*> tgStructureInfo::getAllConnectors() const
+{
+    std::vector<tgConnectorInfo*> result(m_connectors);
+
+    // Collect child connectors
+    for (std::size_t i = 0; i < m_children.size(); i++)
+    {
+        tgStructureInfo * const pStructureInfo = m_children[i];
+    assert(pStructureInfo != NULL);
+        std::vector<tgConnectorInfo*> childConnectors =
+            pStructureInfo->getAllConnectors();
+        result.insert(result.end(), childConnectors.begin(), childConnectors.end());
+    }
+
+    return result;
+}
+
 ////////////////////////////
 // Build methods
 ////////////////////////////
@@ -121,25 +354,27 @@ std::vector<tgRigidInfo*> tgStructureInfo::getAllRigids() const
 void tgStructureInfo::addRigidsAndConnectors() {
     const std::vector<tgBuildSpec::RigidAgent*> rigidAgents = m_buildSpec.getRigidAgents();
     const std::vector<tgBuildSpec::ConnectorAgent*> connectorAgents = m_buildSpec.getConnectorAgents();
+    const std::vector<tgTagSearch> rigidSearches = initAgentSearches(rigidAgents);
+    const std::vector<tgTagSearch> connectorSearches = initAgentSearches(connectorAgents);
 
     const tgNodes& nodes = m_structure.getNodes();
     const tgPairs& pairs = m_structure.getPairs();
 
     // for each node, create a rigidInfo object using a matching rigidAgent
     for (int i = 0; i < nodes.size(); i++) {
-        tgRigidInfo* nodeRigid = initRigidInfo<tgNode>(nodes[i], rigidAgents);
+        tgRigidInfo* nodeRigid = initRigidInfo<tgNode>(nodes[i], rigidAgents, rigidSearches);
         if (nodeRigid) {
             m_rigids.push_back(nodeRigid);
         }
     }
     // for each pair, create a rigidInfo or connectorInfo object using a matching rigidAgent or connectorAgent
     for (int i = 0; i < pairs.size(); i++) {
-        tgRigidInfo* pairRigid = initRigidInfo<tgPair>(pairs[i], rigidAgents);
+        tgRigidInfo* pairRigid = initRigidInfo<tgPair>(pairs[i], rigidAgents, rigidSearches);
         if (pairRigid) {
 	  m_rigids.push_back(pairRigid);
         }
         else {
-            tgConnectorInfo* pairConnector = initConnectorInfo<tgPair>(pairs[i], connectorAgents);
+            tgConnectorInfo* pairConnector = initConnectorInfo<tgPair>(pairs[i], connectorAgents, connectorSearches);
             if (pairConnector) {
                 m_connectors.push_back(pairConnector);
             }
@@ -155,23 +390,33 @@ void tgStructureInfo::addRigidsAndConnectors() {
     }
 }
 
-template <class T>
-tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents) const {
-    for (int i = rigidAgents.size() - 1; i >= 0; i--) {
-        const tgBuildSpec::RigidAgent* pRigidAgent = rigidAgents[i];
-        assert(pRigidAgent != NULL);
-
-        tgTagSearch tagSearch = tgTagSearch(pRigidAgent->tagSearch);
+template <class A>
+std::vector<tgTagSearch> tgStructureInfo::initAgentSearches(const std::vector<A*>& agents) const {
+    std::vector<tgTagSearch> result;
+    result.reserve(agents.size());
+    for (std::size_t i = 0; i < agents.size(); i++) {
+        assert(agents[i] != NULL);
+        result.push_back(agents[i]->tagSearch);
 
         // Remove our tags so that subcomponents 'inherit' them (because of the
         // way tags work, removing a tag from the search is the same as adding
         // the tag to children to be searched)
-        tagSearch.remove(getTags());
+        result.back().remove(getTags());
+    }
+    return result;
+}
+
+template <class T>
+tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents,
+                                            const std::vector<tgTagSearch>& rigidSearches) const {
+    for (int i = rigidAgents.size() - 1; i >= 0; i--) {
+        const tgBuildSpec::RigidAgent* pRigidAgent = rigidAgents[i];
+        assert(pRigidAgent != NULL);
 
         tgRigidInfo* pRigidInfo = pRigidAgent->infoFactory;
         assert(pRigidInfo != NULL);
 
-        tgRigidInfo* rigid = pRigidInfo->createRigidInfo(rigidCandidate, tagSearch);
+        tgRigidInfo* rigid = pRigidInfo->createRigidInfo(rigidCandidate, rigidSearches[i]);
         if (rigid) {// check if a tgRigidInfo was found
 	  return rigid;
 	}
@@ -180,22 +425,16 @@ tgRigidInfo* tgStructureInfo::initRigidInfo(const T& rigidCandidate, const std::
 }
 
 template <class T>
-tgConnectorInfo* tgStructureInfo::initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents) const {
+tgConnectorInfo* tgStructureInfo::initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents,
+                                                    const std::vector<tgTagSearch>& connectorSearches) const {
     for (int i = connectorAgents.size() - 1; i >= 0; i--) {
         const tgBuildSpec::ConnectorAgent*  pConnectorAgent = connectorAgents[i];
         assert(pConnectorAgent != NULL);
 
-        tgTagSearch tagSearch = tgTagSearch(pConnectorAgent->tagSearch);
-
-        // Remove our tags so that subcomponents 'inherit' them (because of the
-        // way tags work, removing a tag from the search is the same as adding
-        // the tag to children to be searched)
-        tagSearch.remove(getTags());
-
         tgConnectorInfo* pConnectorInfo = pConnectorAgent->infoFactory;
         assert(pConnectorInfo != NULL);
 
-        tgConnectorInfo* connector = pConnectorInfo->createConnectorInfo(connectorCandidate, tagSearch);
+        tgConnectorInfo* connector = pConnectorInfo->createConnectorInfo(connectorCandidate, connectorSearches[i]);
         if (connector) // check if a tgConnectorInfo was found
             return connector;
     }
@@ -229,12 +468,19 @@ void tgStructureInfo::chooseConnectorRigids()
 }
 
 void tgStructureInfo::chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids)
+{
+    // Built once here rather than scanning allRigids for every endpoint
+    const tgRigidNodeIndex index(allRigids);
+    chooseConnectorRigids(index);
+}
+
+void tgStructureInfo::chooseConnectorRigids(const tgRigidNodeIndex& index)
 {
     for (std::size_t i = 0; i < m_connectors.size(); i++)
     {
         tgConnectorInfo * const pConnectorInfo = m_connectors[i];
     assert(pConnectorInfo != NULL);
-        pConnectorInfo->chooseRigids(allRigids);
+        pConnectorInfo->chooseRigids(index);
     }    
 
     // Children
@@ -242,46 +488,91 @@ void tgStructureInfo::chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids)
     {
         tgStructureInfo * const pStructureInfo = m_children[i];
     assert(pStructureInfo != NULL);
-        pStructureInfo->chooseConnectorRigids(allRigids);
+        pStructureInfo->chooseConnectorRigids(index);
     }
 }
 
 void tgStructureInfo::initRigidBodies(tgWorld& world) 
 {
-    // Rigids
-    for (std::size_t i = 0; i < m_rigids.size(); i++)
+    // One plan per group (or ungrouped rigid), in the order a walk of the
+    // tree with tgRigidInfo::initRigidBody would have created the objects
+    const std::vector<tgRigidInfo*> allRigids = getAllRigids();
+    std::vector<RigidBodyPlan> plans;
+    std::set<tgRigidInfo*> planned;
+    for (std::size_t i = 0; i < allRigids.size(); i++)
     {
-        tgRigidInfo * const pRigidInfo = m_rigids[i];
+        tgRigidInfo * const pRigidInfo = allRigids[i];
     assert(pRigidInfo != NULL);
-        pRigidInfo->initRigidBody(world);
+        tgRigidInfo* rigid = pRigidInfo->getRigidInfoGroup();
+        if (rigid == 0)
+        {
+            rigid = pRigidInfo;
+        }
+        if (rigid->getCollisionObject() == NULL && planned.insert(rigid).second)
+        {
+            RigidBodyPlan plan;
+            plan.rigid = rigid;
+            plan.first = pRigidInfo;
+            plans.push_back(plan);
+        }
     }
-    
-    // Children
-    for (std::size_t i = 0; i < m_children.size(); i++)
+
+    // Shapes and mass properties, possibly in parallel
+    PrepareRigidsJob job(plans, world);
+    dispatch(job, plans.size(),
+             buildThreads(m_buildSpec.getBuildThreads(), plans.size()));
+
+    // The dynamics world isn't thread safe, so bodies are added here,
+    // interleaved with finishRigidBody as initRigidBody would do them
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < allRigids.size(); i++)
     {
-        tgStructureInfo * const pStructureInfo = m_children[i];
-    assert(pStructureInfo != NULL);
-        pStructureInfo->initRigidBodies(world);
+        tgRigidInfo * const pRigidInfo = allRigids[i];
+        if (next < plans.size() && plans[next].first == pRigidInfo)
+        {
+            const RigidBodyPlan& plan = plans[next];
+            pRigidInfo->createCollisionObject(world,
+                                              *plan.rigid,
+                                              plan.mass,
+                                              plan.transform,
+                                              plan.shape,
+                                              plan.localInertia);
+            next++;
+        }
+        pRigidInfo->finishRigidBody();
     }
+    assert(next == plans.size());
 }
 
 void tgStructureInfo::initConnectors(tgWorld& world) 
 {
-    // Connectors
-    for (std::size_t i = 0; i < m_connectors.size(); i++)
+    const std::vector<tgConnectorInfo*> allConnectors = getAllConnectors();
+    std::vector<tgConnectorInfo*> withoutWorld;
+    std::vector<tgConnectorInfo*> withWorld;
+    for (std::size_t i = 0; i < allConnectors.size(); i++)
     {
-        tgConnectorInfo * const pConnectorInfo = m_connectors[i];
+        tgConnectorInfo * const pConnectorInfo = allConnectors[i];
     assert(pConnectorInfo != NULL);
-        pConnectorInfo->initConnector(world);
+        if (pConnectorInfo->initsWithoutWorld())
+        {
+            withoutWorld.push_back(pConnectorInfo);
+        }
+        else
+        {
+            withWorld.push_back(pConnectorInfo);
+        }
     }
-    
-    // Children
-    for (std::size_t i = 0; i < m_children.size(); i++)
+
+    // Anchor geometry only needs the bodies, which all exist by now
+    InitConnectorsJob job(withoutWorld, world);
+    dispatch(job, withoutWorld.size(),
+             buildThreads(m_buildSpec.getBuildThreads(), withoutWorld.size()));
+
+    // e.g. contact cables, which add ghost objects to the world
+    for (std::size_t i = 0; i < withWorld.size(); i++)
     {
-        tgStructureInfo * const pStructureInfo = m_children[i];
-    assert(pStructureInfo != NULL);
-        pStructureInfo->initConnectors(world);
-    } 
+        withWorld[i]->initConnector(world);
+    }
 }
 
 /**
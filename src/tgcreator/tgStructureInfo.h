@@ -40,6 +40,7 @@ class tgBuildSpec;
 class tgConnectorInfo;
 class tgModel;
 class tgRigidInfo;
+class tgRigidNodeIndex;
 class tgStructure;
 class tgWorld;
 
@@ -78,27 +79,56 @@ private:
      */
     void addRigidsAndConnectors();
 
+    /*
+     * The agents' tag searches with our tags removed, so subcomponents
+     * 'inherit' them. Computed once per structure rather than per candidate.
+     */
+    template <class A>
+    std::vector<tgTagSearch> initAgentSearches(const std::vector<A*>& agents) const;
+
     /*
      * Create and return a rigidInfo object using a matching rigidAgent
      */
     template <class T>
-    tgRigidInfo* initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents) const;
+    tgRigidInfo* initRigidInfo(const T& rigidCandidate, const std::vector<tgBuildSpec::RigidAgent*>& rigidAgents,
+                               const std::vector<tgTagSearch>& rigidSearches) const;
 
     /*
      * Create and return a connectorInfo object using a matching connectorAgent
      */
     template <class T>
-    tgConnectorInfo* initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents) const;
+    tgConnectorInfo* initConnectorInfo(const T& connectorCandidate, const std::vector<tgBuildSpec::ConnectorAgent*>& connectorAgents,
+                                       const std::vector<tgTagSearch>& connectorSearches) const;
 
     void autoCompoundRigids();
     
     void chooseConnectorRigids();
 
     void chooseConnectorRigids(std::vector<tgRigidInfo*> allRigids);
+
+    /*
+     * Resolve every connector endpoint, here and in children, through one
+     * index of rigids by node position
+     */
+    void chooseConnectorRigids(const tgRigidNodeIndex& index);
     
+    /*
+     * Create a btRigidBody for every rigid group here and in children.
+     * Shapes and mass properties are prepared first, on build threads if
+     * the build spec opts in to them; the bodies are then added to the
+     * world serially, in tree order.
+     */
     void initRigidBodies(tgWorld& world);
     
+    /*
+     * Initialize every connector here and in children. If the build spec
+     * opts in to build threads, those that don't touch the world are
+     * spread across them; the rest always run serially.
+     */
     void initConnectors(tgWorld& world);
+
+    // Return all connectors in this structure and its descendants
+    std::vector<tgConnectorInfo*> getAllConnectors() const;
     
     const std::vector<tgRigidInfo*>& getRigids() const
     {
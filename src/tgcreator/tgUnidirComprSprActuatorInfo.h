@@ -93,6 +93,11 @@ public:
      */
     virtual void initConnector(tgWorld& world);
 
+    virtual bool initsWithoutWorld() const
+    {
+        return true;
+    }
+
     /**
      * Return the tgUnidirComprSprActuator that's been built
      * from the tgBulletUnidirComprSpr.
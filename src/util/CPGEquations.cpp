@@ -26,28 +26,28 @@
 
 #include "CPGEquations.h"
 
-#include "boost/array.hpp"
-#include "boost/numeric/odeint.hpp"
-
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 
 // The C++ Standard Library
 #include <assert.h>
+#include <cmath>
+#include <iostream>
 #include <stdexcept>
-
-using namespace boost::numeric::odeint;
-
-typedef std::vector<double > cpgVars_type;
+#include <typeinfo>
 
 CPGEquations::CPGEquations(int maxSteps) :
+m_compiled(false),
+m_lanes(1),
 stepSize(0.1),
 numSteps(0),
 m_maxSteps(maxSteps)
  {}
 CPGEquations::CPGEquations(std::vector<CPGNode*>& newNodeList, int maxSteps) :
 nodeList(newNodeList),
+m_compiled(false),
+m_lanes(1),
 stepSize(0.1), //TODO: specify as a parameter somewhere
 numSteps(0),
 m_maxSteps(maxSteps)
@@ -70,6 +70,7 @@ int CPGEquations::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNode* newNode = new CPGNode(index, newParams);
 	nodeList.push_back(newNode);
+	m_compiled = false;
 	
 	return index;
 }
@@ -86,6 +87,7 @@ void CPGEquations::defineConnections (	int nodeIndex,
 	for(int i = 0; i != connections.size(); i++){
 		nodeList[nodeIndex]->addCoupling(nodeList[connections[i]], newWeights[i], newPhaseOffsets[i]); 
 	}
+	m_compiled = false;
 }
 
 const double CPGEquations::operator[](const std::size_t i) const
@@ -156,83 +158,146 @@ void CPGEquations::updateNodeData(std::vector<double> newXVals)
 	}
 }
 
-/**
- * Function object for interfacing with ODE Int
- */
-class integrate_function {
-	public:
+void CPGEquations::compileNodes()
+{
+	const std::size_t n = nodeList.size();
+	const std::size_t lanes = m_laneNetworks.size();
+	m_lanes = lanes;
+	m_frequencyOffset.resize(n * lanes);
+	m_frequencyScale.resize(n * lanes);
+	m_radiusOffset.resize(n * lanes);
+	m_radiusScale.resize(n * lanes);
+	m_rConst.resize(n * lanes);
+	m_dMin.resize(n * lanes);
+	m_dMax.resize(n * lanes);
 	
-	integrate_function(CPGEquations* pCPGs, std::vector<double> newComs) :
-	theseCPGs(pCPGs),
-	descCom(newComs)
+	// Topology comes from the first lane; setBatch checked the others
+	const std::vector<CPGNode*>& first = laneNodes(0);
+	assert(first.size() == n);
+	m_couplingStart.assign(1, 0);
+	m_couplingTarget.clear();
+	for (std::size_t i = 0; i != n; i++)
 	{
-		
+		const CPGNode& node = *first[i];
+		for (std::size_t j = 0; j != node.couplingList.size(); j++)
+		{
+			const int target = node.couplingList[j]->m_nodeNumber;
+			assert(target >= 0 && static_cast<std::size_t>(target) < n);
+			assert(first[target] == node.couplingList[j]);
+			m_couplingTarget.push_back(target);
+		}
+		m_couplingStart.push_back(m_couplingTarget.size());
 	}
+	m_couplingWeight.resize(m_couplingTarget.size() * lanes);
+	m_couplingPhase.resize(m_couplingTarget.size() * lanes);
 	
-	void operator()  (const cpgVars_type &x ,
-					cpgVars_type &dxdt ,
-					double t )
+	for (std::size_t k = 0; k != lanes; k++)
 	{
-#ifndef BT_NO_PROFILE 
-        BT_PROFILE("CPGEquations::integrate_function");
-#endif //BT_NO_PROFILE
-		theseCPGs->updateNodeData(x);
-		theseCPGs->updateNodes(descCom);
-	
-		/**
-		 * Read information from nodes into variables that work for ODEInt
-		 */
-		std::vector<double> dXVars = theseCPGs->getDXVars();
-		/**
-		 * Values are pre-computed by nodes, so we just have to transfer
-		 * them
-		 */
-		for(std::size_t i = 0; i != x.size(); i++){
-			dxdt[i] = dXVars[i];
+		const std::vector<CPGNode*>& nodes = laneNodes(k);
+		for (std::size_t i = 0; i != n; i++)
+		{
+			const CPGNode& node = *nodes[i];
+			const std::size_t ik = i * lanes + k;
+			m_frequencyOffset[ik] = node.frequencyOffset;
+			m_frequencyScale[ik] = node.frequencyScale;
+			m_radiusOffset[ik] = node.radiusOffset;
+			m_radiusScale[ik] = node.radiusScale;
+			m_rConst[ik] = node.rConst;
+			m_dMin[ik] = node.dMin;
+			m_dMax[ik] = node.dMax;
+			
+			const std::size_t e0 = m_couplingStart[i];
+			for (std::size_t j = 0; j != node.couplingList.size(); j++)
+			{
+				m_couplingWeight[(e0 + j) * lanes + k] = node.weightList[j];
+				m_couplingPhase[(e0 + j) * lanes + k] = node.phaseList[j];
+			}
 		}
-		//std::cout<<"operator call"<<std::endl;
-		
-		theseCPGs->countStep();
-		
 	}
 	
-	private:
-	CPGEquations* theseCPGs;
-	std::vector<double> descCom;
-};
+	m_phaseDrive.resize(n * lanes);
+	m_radiusDrive.resize(n * lanes);
+	m_auxDrive.resize(n * lanes);
+	m_compiled = true;
+}
 
-/**
- * ODE_Int Output function, can do nothing, but needs to exist
- */
-class output_function {
-	public: 
+void CPGEquations::setDrives(const std::vector<double>& descCom,
+                             std::size_t lane)
+{
+	const std::size_t n = nodeList.size();
+	assert(descCom.size() >= n);
 	
-	output_function(CPGEquations* pCPGs) :
-	theseCPGs(pCPGs)
+	// Same as CPGNode::nodeEquation
+	for (std::size_t i = 0; i != n; i++)
 	{
+		const std::size_t ik = i * m_lanes + lane;
+		const double d = descCom[i];
+		const bool inRange = d >= m_dMin[ik] && d <= m_dMax[ik];
+		m_phaseDrive[ik] = inRange ?
+			2 * M_PI * (m_frequencyScale[ik] * d + m_frequencyOffset[ik]) : 0.0;
+		m_radiusDrive[ik] = inRange ?
+			m_radiusScale[ik] * d + m_radiusOffset[ik] : 0.0;
 	}
+}
+
+void CPGEquations::derivatives(const double* y, double* dydt) const
+{
+	const std::size_t size = nodeList.size() * m_lanes;
+	const double* const r = y + size;
+	const double* const rDot = y + 2 * size;
+	double* const phiDot = dydt;
+	double* const rDotOut = dydt + size;
+	double* const rDoubleDot = dydt + 2 * size;
 	
-	void operator() ( 	const cpgVars_type &x ,
-						const double t )
+	// Same equations as CPGNode::updateDTs
+	for (std::size_t j = 0; j != size; j++)
 	{
-		/**
-		 * Push integrated vars back to nodes
-		 */
-		theseCPGs->updateNodeData(x);
-		#if (0) // Suppress output
-		std::cout << t << '\t' << (*theseCPGs)[0]  << '\t' << (*theseCPGs)[1]  << '\t' << (*theseCPGs)[2]  << std::endl;
-		#endif
+		phiDot[j] = m_phaseDrive[j];
+		rDotOut[j] = rDot[j];
+		rDoubleDot[j] = m_rConst[j] * (m_rConst[j] / 4 *
+			(m_radiusDrive[j] - r[j]) - rDot[j]);
 	}
 	
-	private:
-	CPGEquations* theseCPGs;
-};
+	addCouplings(y, dydt);
+}
 
-void CPGEquations::update(std::vector<double>& descCom, double dt)
+void CPGEquations::addCouplings(const double* y, double* dydt) const
+{
+	const std::size_t n = nodeList.size();
+	const std::size_t lanes = m_lanes;
+	const double* const phi = y;
+	const double* const r = y + n * lanes;
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		double* const phiDot = dydt + i * lanes;
+		const double* const phiI = phi + i * lanes;
+		const std::size_t end = m_couplingStart[i + 1];
+		for (std::size_t e = m_couplingStart[i]; e != end; e++)
+		{
+			const std::size_t t = m_couplingTarget[e] * lanes;
+			const double* const weight = &m_couplingWeight[e * lanes];
+			const double* const phase = &m_couplingPhase[e * lanes];
+			for (std::size_t k = 0; k != lanes; k++)
+			{
+				phiDot[k] += weight[k] * r[t + k] *
+					sin(phi[t + k] - phiI[k] - phase[k]);
+			}
+		}
+	}
+}
+
+void CPGEquations::useLanes(const std::vector<CPGEquations*>& lanes)
+{
+	if (!m_compiled || m_laneNetworks != lanes)
+	{
+		m_laneNetworks = lanes;
+		compileNodes();
+	}
+}
+
+std::vector<bool> CPGEquations::integrate(double dt)
 {
-#ifndef BT_NO_PROFILE 
-    BT_PROFILE("CPGEquations::update");
-#endif //BT_NO_PROFILE
 	if (dt <= 0.1){ //TODO: specify default step size as a parameter during construction
 		stepSize = dt;
 	}
@@ -243,14 +308,107 @@ void CPGEquations::update(std::vector<double>& descCom, double dt)
 	numSteps = 0;
 	
 	/**
-	 * Read information from nodes into variables that work for ODEInt
+	 * Read information from nodes into the integrator's layout
 	 */
-	std::vector<double>& xVars = getXVars(); 
+	const std::size_t n = nodeList.size();
+	const std::size_t lanes = m_lanes;
+	const std::size_t block = n * lanes;
+	const std::size_t size = 3 * block;
+	m_state.resize(size);
+	m_stage.resize(size);
+	m_k1.resize(size);
+	m_k2.resize(size);
+	m_k3.resize(size);
+	m_k4.resize(size);
+	for (std::size_t k = 0; k != lanes; k++)
+	{
+		const std::vector<double>& xVars = m_laneNetworks[k]->getXVars();
+		assert(xVars.size() == 3 * n);
+		for (std::size_t i = 0; i != n; i++)
+		{
+			for (std::size_t v = 0; v != 3; v++)
+			{
+				m_state[v * block + i * lanes + k] = xVars[3 * i + v];
+			}
+		}
+	}
+	
+	if (size > 0 && dt > 0.0)
+	{
+		const std::size_t steps =
+			static_cast<std::size_t>(std::ceil(dt / stepSize - 1e-9));
+		const double h = dt / steps;
+		double* const y = &m_state[0];
+		double* const stage = &m_stage[0];
+		double* const k1 = &m_k1[0];
+		double* const k2 = &m_k2[0];
+		double* const k3 = &m_k3[0];
+		double* const k4 = &m_k4[0];
+		
+		for (std::size_t s = 0; s != steps; s++)
+		{
+			derivatives(y, k1);
+			for (std::size_t j = 0; j != size; j++)
+			{
+				stage[j] = y[j] + 0.5 * h * k1[j];
+			}
+			derivatives(stage, k2);
+			for (std::size_t j = 0; j != size; j++)
+			{
+				stage[j] = y[j] + 0.5 * h * k2[j];
+			}
+			derivatives(stage, k3);
+			for (std::size_t j = 0; j != size; j++)
+			{
+				stage[j] = y[j] + h * k3[j];
+			}
+			derivatives(stage, k4);
+			for (std::size_t j = 0; j != size; j++)
+			{
+				y[j] += h / 6.0 * (k1[j] + 2.0 * (k2[j] + k3[j]) + k4[j]);
+			}
+			numSteps += 4;
+		}
+	}
 	
 	/**
-	 * Run ODEInt. This will change the data in xVars
+	 * Push integrated vars back to the nodes of every lane that is
+	 * still finite
 	 */
-	integrate(integrate_function(this, descCom), xVars, 0.0, dt, stepSize, output_function(this));
+	std::vector<bool> finite(lanes, true);
+	std::vector<double> newXVars(3 * n);
+	for (std::size_t k = 0; k != lanes; k++)
+	{
+		for (std::size_t i = 0; i != n; i++)
+		{
+			for (std::size_t v = 0; v != 3; v++)
+			{
+				const double x = m_state[v * block + i * lanes + k];
+				finite[k] = finite[k] && std::isfinite(x);
+				newXVars[3 * i + v] = x;
+			}
+		}
+		if (finite[k])
+		{
+			m_laneNetworks[k]->updateNodeData(newXVars);
+		}
+	}
+	return finite;
+}
+
+void CPGEquations::update(std::vector<double>& descCom, double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquations::update");
+#endif //BT_NO_PROFILE
+	useLanes(std::vector<CPGEquations*>(1, this));
+	setDrives(descCom, 0);
+	
+	if (!integrate(dt)[0])
+	{
+		std::cout << "Ending trial due to unstable equations" << std::endl;
+		throw std::runtime_error("Unstable CPG Parameters");
+	}
 	
     if (numSteps > m_maxSteps)
     {
@@ -266,6 +424,62 @@ void CPGEquations::update(std::vector<double>& descCom, double dt)
 	   
 }
 
+void CPGEquations::setBatch(const std::vector<CPGEquations*>& batch)
+{
+	for (std::size_t k = 0; k != batch.size(); k++)
+	{
+		const CPGEquations* const pOther = batch[k];
+		if (pOther == NULL || typeid(*pOther) != typeid(*this))
+		{
+			throw std::invalid_argument("Batch network is not of this class");
+		}
+		const std::vector<CPGNode*>& nodes = pOther->nodeList;
+		if (nodes.size() != nodeList.size())
+		{
+			throw std::invalid_argument("Batch network has a different node count");
+		}
+		for (std::size_t i = 0; i != nodes.size(); i++)
+		{
+			const std::vector<CPGNode*>& mine = nodeList[i]->couplingList;
+			const std::vector<CPGNode*>& theirs = nodes[i]->couplingList;
+			bool same = mine.size() == theirs.size();
+			for (std::size_t j = 0; same && j != mine.size(); j++)
+			{
+				same = mine[j]->m_nodeNumber == theirs[j]->m_nodeNumber;
+			}
+			if (!same)
+			{
+				throw std::invalid_argument("Batch network has different couplings");
+			}
+		}
+	}
+	m_batch = batch;
+	m_compiled = false;
+}
+
+std::vector<bool> CPGEquations::updateBatch(std::vector<std::vector<double> >& descComs,
+                                            double dt)
+{
+#ifndef BT_NO_PROFILE 
+    BT_PROFILE("CPGEquations::updateBatch");
+#endif //BT_NO_PROFILE
+	if (descComs.size() != m_batch.size())
+	{
+		throw std::invalid_argument("Need one set of commands per batch network");
+	}
+	if (m_batch.empty())
+	{
+		return std::vector<bool>();
+	}
+	
+	useLanes(m_batch);
+	for (std::size_t k = 0; k != m_batch.size(); k++)
+	{
+		setDrives(descComs[k], k);
+	}
+	return integrate(dt);
+}
+
 std::string CPGEquations::toString(const std::string& prefix) const
 {
 	std::string p = "  ";
@@ -27,6 +27,7 @@
  * $Id$
  */
 
+#include <cstddef>
 #include <vector>
 #include <sstream>
 
@@ -34,7 +35,11 @@
 
 /**
  * The top level class for interfacing with CPGs. Contains the definition
- * of the CPG (list of nodes) as well as functions to interface with ODEInt
+ * of the CPG (list of nodes) and a fixed step RK4 integrator for it.
+ * The nodes describe the network and hold its state between updates;
+ * integration runs on a flattened copy with node parameters in arrays
+ * and couplings in compressed rows, so the inner loops never touch the
+ * node objects.
  */
 class CPGEquations
 {
@@ -64,10 +69,34 @@ class CPGEquations
 	virtual void updateNodeData(std::vector<double> newXVals);
 	
 	/**
-	 * Call the integrator a the specified timestep
+	 * Integrate the network over dt with RK4, in equal steps of at most
+	 * 0.1, holding the descending commands fixed
+	 * @throw std::runtime_error if the state stops being finite
 	 */
 	void update(std::vector<double>& descCom, double dt);
 	
+	/**
+	 * Choose networks for updateBatch() to integrate in lockstep. They
+	 * must be of this network's class and have its topology (node count
+	 * and coupling targets), but node parameters, coupling weights, phase
+	 * offsets and state may differ. Call again after changing any of
+	 * them; an empty batch releases them.
+	 * @throw std::invalid_argument if a network's topology differs
+	 */
+	void setBatch(const std::vector<CPGEquations*>& batch);
+	
+	/**
+	 * Integrate every network of the batch over dt as update() would,
+	 * each with its own descending commands. The networks run as lanes of
+	 * one set of arrays, so the kernels vectorize across the batch.
+	 * @param[in] descComs one set of descending commands per network
+	 * @return whether each network's state stayed finite. Networks that
+	 * did not keep their previous state; the rest are unaffected.
+	 * @throw std::invalid_argument if descComs doesn't match the batch
+	 */
+	std::vector<bool> updateBatch(std::vector<std::vector<double> >& descComs,
+	                              double dt);
+	
 	std::string toString(const std::string& prefix = "") const;
 	
     void countStep()
@@ -77,8 +106,73 @@ class CPGEquations
     
 protected:
 	
+	/**
+	 * Copy node parameters and couplings of every lane's network into
+	 * the arrays below. Called when the lanes change or after nodes or
+	 * connections are added through this class; couplings added to the
+	 * nodes directly after the first update are not seen.
+	 */
+	virtual void compileNodes();
+	
+	/**
+	 * Fill one lane of the drive arrays from its descending commands,
+	 * which stay fixed for the whole update
+	 */
+	virtual void setDrives(const std::vector<double>& descCom,
+	                       std::size_t lane);
+	
+	/**
+	 * Right hand side of all lanes. State is laid out as consecutive
+	 * blocks of phase, radius and the third node variable, each holding
+	 * node i of lane k at i * m_lanes + k.
+	 */
+	virtual void derivatives(const double* y, double* dydt) const;
+	
+	/**
+	 * Add every node's coupling terms to its phase derivative
+	 */
+	void addCouplings(const double* y, double* dydt) const;
+	
+	/** The nodes of a lane's network */
+	const std::vector<CPGNode*>& laneNodes(std::size_t lane) const
+	{
+		return m_laneNetworks[lane]->nodeList;
+	}
+	
 	std::vector<CPGNode*> nodeList;
 	
+	/** Whether the arrays below match m_laneNetworks */
+	bool m_compiled;
+	
+	/** The networks being integrated: this one, or the batch */
+	std::vector<CPGEquations*> m_laneNetworks;
+	std::size_t m_lanes;
+	
+	/** Node parameters, one entry per node and lane */
+	std::vector<double> m_frequencyOffset;
+	std::vector<double> m_frequencyScale;
+	std::vector<double> m_radiusOffset;
+	std::vector<double> m_radiusScale;
+	std::vector<double> m_rConst;
+	std::vector<double> m_dMin;
+	std::vector<double> m_dMax;
+	
+	/**
+	 * Couplings in compressed rows: node i's couplings are entries
+	 * m_couplingStart[i] up to m_couplingStart[i + 1]. Targets are shared
+	 * by all lanes; weights and phases have one entry per coupling and
+	 * lane, at e * m_lanes + k.
+	 */
+	std::vector<std::size_t> m_couplingStart;
+	std::vector<std::size_t> m_couplingTarget;
+	std::vector<double> m_couplingWeight;
+	std::vector<double> m_couplingPhase;
+	
+	/** Per node and lane terms computed once per update by setDrives() */
+	std::vector<double> m_phaseDrive;
+	std::vector<double> m_radiusDrive;
+	std::vector<double> m_auxDrive;
+	
     std::vector<double> XVars;
     std::vector<double> DXVars;
     
@@ -87,6 +181,29 @@ protected:
     int m_maxSteps;
     int numSteps;
     
+private:
+	
+	/** Compile for the given lanes unless already compiled for them */
+	void useLanes(const std::vector<CPGEquations*>& lanes);
+	
+	/**
+	 * RK4 over every lane, starting from and returning to the lanes'
+	 * nodes
+	 * @return whether each lane's state stayed finite
+	 */
+	std::vector<bool> integrate(double dt);
+	
+	/** Networks for updateBatch() */
+	std::vector<CPGEquations*> m_batch;
+	
+	/** RK4 state and stage buffers, kept to avoid reallocating */
+	std::vector<double> m_state;
+	std::vector<double> m_stage;
+	std::vector<double> m_k1;
+	std::vector<double> m_k2;
+	std::vector<double> m_k3;
+	std::vector<double> m_k4;
+    
 };
 
 /**
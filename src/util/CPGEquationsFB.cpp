@@ -28,21 +28,15 @@
 
 #include "core/tgCast.h"
 
-#include "boost/array.hpp"
-#include "boost/numeric/odeint.hpp"
-
 // The Bullet Physics Library
 #include "LinearMath/btQuickprof.h"
 
 // The C++ Standard Library
 #include <assert.h>
+#include <cmath>
 #include <stdexcept>
 #include <iterator> 
 
-using namespace boost::numeric::odeint;
-
-typedef std::vector<double > cpgVars_type;
-
 CPGEquationsFB::CPGEquationsFB(int maxSteps) :
 CPGEquations(maxSteps)
  {}
@@ -61,6 +55,7 @@ int CPGEquationsFB::addNode(std::vector<double>& newParams)
 	int index = nodeList.size();
 	CPGNodeFB* newNode = new CPGNodeFB(index, newParams);
 	nodeList.push_back(newNode);
+	m_compiled = false;
 	
 	return index;
 }
@@ -128,3 +123,63 @@ void CPGEquationsFB::updateNodeData(std::vector<double> newXVals)
 		currentNode->updateNodeValues(newXVals[3*i], newXVals[3*i+1], newXVals[3*i+2]);
 	}
 }
+
+void CPGEquationsFB::compileNodes()
+{
+	CPGEquations::compileNodes();
+	
+	const std::size_t n = nodeList.size();
+	m_kFreq.resize(n * m_lanes);
+	m_kAmp.resize(n * m_lanes);
+	m_kPhase.resize(n * m_lanes);
+	for (std::size_t k = 0; k != m_lanes; k++)
+	{
+		const std::vector<CPGNode*>& nodes = laneNodes(k);
+		for (std::size_t i = 0; i != n; i++)
+		{
+			const CPGNodeFB* currentNode =
+				tgCast::cast<CPGNode, CPGNodeFB>(nodes[i]);
+			assert(currentNode);
+			const std::size_t ik = i * m_lanes + k;
+			m_kFreq[ik] = currentNode->kFreq;
+			m_kAmp[ik] = currentNode->kAmp;
+			m_kPhase[ik] = currentNode->kPhase;
+		}
+	}
+}
+
+void CPGEquationsFB::setDrives(const std::vector<double>& descCom,
+                               std::size_t lane)
+{
+	const std::size_t n = nodeList.size();
+	assert(descCom.size() == n * 3);
+	
+	for (std::size_t i = 0; i != n; i++)
+	{
+		const std::size_t ik = i * m_lanes + lane;
+		m_phaseDrive[ik] = m_kPhase[ik] * descCom[3 * i + 2];
+		m_radiusDrive[ik] = m_radiusOffset[ik] + m_kAmp[ik] * descCom[3 * i + 1];
+		m_auxDrive[ik] = m_kFreq[ik] * descCom[3 * i];
+	}
+}
+
+void CPGEquationsFB::derivatives(const double* y, double* dydt) const
+{
+	const std::size_t size = nodeList.size() * m_lanes;
+	const double* const phi = y;
+	const double* const r = y + size;
+	const double* const omega = y + 2 * size;
+	double* const phiDot = dydt;
+	double* const rDot = dydt + size;
+	double* const omegaDot = dydt + 2 * size;
+	
+	// Same equations as CPGNodeFB::updateDTs
+	for (std::size_t j = 0; j != size; j++)
+	{
+		phiDot[j] = omega[j] + m_phaseDrive[j];
+		rDot[j] = m_rConst[j] * (m_radiusDrive[j] - r[j] * r[j]) * r[j];
+		omegaDot[j] = m_auxDrive[j] * sin(phi[j]);
+	}
+	
+	addCouplings(y, dydt);
+}
@@ -38,8 +38,9 @@
 
 
 /**
- * The top level class for interfacing with CPGs. Contains the definition
- * of the CPG (list of nodes) as well as functions to interface with ODEInt
+ * The top level class for interfacing with CPGs with feedback. Contains
+ * the definition of the CPG (list of nodes) and the equations of
+ * CPGNodeFB for CPGEquations' integrator.
  */
 class CPGEquationsFB : public CPGEquations
 {
@@ -61,6 +62,27 @@ class CPGEquationsFB : public CPGEquations
 	
 	void updateNodeData(std::vector<double> newXVals);
 
+protected:
+	
+	virtual void compileNodes();
+	
+	/**
+	 * @param[in] descCom three feedback values per node, as for
+	 * CPGNodeFB::updateDTs
+	 */
+	virtual void setDrives(const std::vector<double>& descCom,
+	                       std::size_t lane);
+	
+	/**
+	 * The third node variable is the frequency omega
+	 */
+	virtual void derivatives(const double* y, double* dydt) const;
+	
+	/** Feedback gains, one entry per node and lane */
+	std::vector<double> m_kFreq;
+	std::vector<double> m_kAmp;
+	std::vector<double> m_kPhase;
+
 };
 
 #endif // SIMULATOR_SRC_LIB_MODELS_SNAKE_CPGS_CPGEQUATIONS